@@ -0,0 +1,467 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "applicationcatalog.h"
+#include "containerfilesystem.h"
+
+#include <KShell>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Desktop entry values can't contain control characters, so the ASCII unit separator is safe
+constexpr char FieldSeparator = '\x1f';
+constexpr int FieldCount = 9;
+// Records of known, unchanged files only carry id, path and mtime
+constexpr int UnchangedFieldCount = 3;
+
+// Bump when the meaning of the cached fields changes
+constexpr int CacheVersion = 2;
+
+// Applications directories of @p dataDirectories, skipping the ones shared with the host
+QStringList applicationDirectories(const QStringList &dataDirectories)
+{
+    // distrobox shares the home directory with the host by default
+    const QString home = QDir::homePath();
+
+    QStringList directories;
+    for (const QString &dataDirectory : dataDirectories) {
+        const QString directory = QDir::cleanPath(dataDirectory);
+        if (directory.isEmpty() || directory == home || directory.startsWith(home + QLatin1Char('/')) || directory == QLatin1String("/run/host")
+            || directory.startsWith(QLatin1String("/run/host/"))) {
+            continue;
+        }
+        directories << directory + u"/applications"_s;
+    }
+    directories.removeDuplicates();
+    return directories;
+}
+
+// Name keys for @p locale, most specific first, as the desktop entry spec matches them
+QStringList localizedNameKeys(const QString &locale)
+{
+    QString language = locale.section(QLatin1Char('.'), 0, 0);
+    QString modifier;
+    const qsizetype at = language.indexOf(QLatin1Char('@'));
+    if (at >= 0) {
+        modifier = language.mid(at);
+        language.truncate(at);
+    }
+    const QString shortLanguage = language.section(QLatin1Char('_'), 0, 0);
+
+    return {u"Name[%1%2]"_s.arg(language, modifier),
+            u"Name[%1]"_s.arg(language),
+            u"Name[%1%2]"_s.arg(shortLanguage, modifier),
+            u"Name[%1]"_s.arg(shortLanguage)};
+}
+
+// Prints: id, path, mtime, Name, localized Name, Icon, Type, NoDisplay, Hidden
+const char ScanAwkProgram[] = R"AWK(
+BEGIN {
+    sep = sprintf("%c", 31)
+    while ((getline line < knownFile) > 0) {
+        m = line; sub(/ .*/, "", m)
+        if (m != "") known[substr(line, length(m) + 2)] = m
+    }
+    close(knownFile)
+    dirCount = split(dirs, dirList, ":")
+    lang = locale; sub(/\..*/, "", lang)
+    country = lang; modifier = ""
+    if (index(lang, "@")) { modifier = substr(lang, index(lang, "@")); country = substr(lang, 1, index(lang, "@") - 1) }
+    short = country; sub(/_.*/, "", short)
+    keys[1] = "Name[" country modifier "]"; keys[2] = "Name[" country "]"
+    keys[3] = "Name[" short modifier "]"; keys[4] = "Name[" short "]"
+}
+{
+    mtime = $0; sub(/ .*/, "", mtime)
+    path = substr($0, length(mtime) + 2)
+    id = path
+    for (i = 1; i <= dirCount; i++) {
+        if (dirList[i] != "" && index(path, dirList[i] "/") == 1) { id = substr(path, length(dirList[i]) + 2); break }
+    }
+    gsub(/\//, "-", id); sub(/\.desktop$/, "", id)
+    if (id in seen) next
+    seen[id] = 1
+    if ((path in known) && known[path] == mtime) { print id sep path sep mtime; next }
+
+    name = ""; icon = ""; type = ""; noDisplay = "false"; hidden = "false"; section = 0
+    for (k = 1; k <= 4; k++) localized[k] = ""
+    while ((getline line < path) > 0) {
+        sub(/\r$/, "", line)
+        if (line ~ /^\[/) { section = (line ~ /^\[Desktop Entry\][ \t]*$/); continue }
+        if (!section || line ~ /^#/) continue
+        eq = index(line, "=")
+        if (!eq) continue
+        key = substr(line, 1, eq - 1); value = substr(line, eq + 1)
+        sub(/[ \t]+$/, "", key); sub(/^[ \t]+/, "", value)
+        if (key == "Name") name = value
+        else if (key == "Icon") icon = value
+        else if (key == "Type") type = value
+        else if (key == "NoDisplay") noDisplay = value
+        else if (key == "Hidden") hidden = value
+        else for (k = 1; k <= 4; k++) if (key == keys[k]) localized[k] = value
+    }
+    close(path)
+
+    localizedName = ""
+    for (k = 1; k <= 4 && localizedName == ""; k++) localizedName = localized[k]
+    print id sep path sep mtime sep name sep localizedName sep icon sep type sep noDisplay sep hidden
+}
+)AWK";
+
+QString cacheFilePath(const QString &container)
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+    return QDir(cacheBase).filePath(QStringLiteral("kontainer/applications/%1.json").arg(container));
+}
+
+QJsonObject entryToJson(const ApplicationCatalog::Entry &entry)
+{
+    QJsonObject object;
+    object[u"basename"_s] = entry.basename;
+    object[u"path"_s] = entry.path;
+    object[u"mtime"_s] = entry.mtime;
+    object[u"name"_s] = entry.name;
+    object[u"localizedName"_s] = entry.localizedName;
+    object[u"icon"_s] = entry.icon;
+    object[u"type"_s] = entry.type;
+    object[u"noDisplay"_s] = entry.noDisplay;
+    object[u"hidden"_s] = entry.hidden;
+    return object;
+}
+
+ApplicationCatalog::Entry entryFromJson(const QJsonObject &object)
+{
+    ApplicationCatalog::Entry entry;
+    entry.basename = object.value(QLatin1String("basename")).toString();
+    entry.path = object.value(QLatin1String("path")).toString();
+    entry.mtime = object.value(QLatin1String("mtime")).toInteger();
+    entry.name = object.value(QLatin1String("name")).toString();
+    entry.localizedName = object.value(QLatin1String("localizedName")).toString();
+    entry.icon = object.value(QLatin1String("icon")).toString();
+    entry.type = object.value(QLatin1String("type")).toString();
+    entry.noDisplay = object.value(QLatin1String("noDisplay")).toBool();
+    entry.hidden = object.value(QLatin1String("hidden")).toBool();
+    return entry;
+}
+}
+
+namespace ApplicationCatalog
+{
+bool Entry::isVisibleApplication() const
+{
+    return type == QLatin1String("Application") && !noDisplay && !hidden;
+}
+
+QString Entry::displayName() const
+{
+    if (!localizedName.isEmpty()) {
+        return localizedName;
+    }
+    return name.isEmpty() ? basename : name;
+}
+
+bool Entry::operator==(const Entry &other) const
+{
+    return basename == other.basename && path == other.path && mtime == other.mtime && name == other.name && localizedName == other.localizedName
+        && icon == other.icon && type == other.type && noDisplay == other.noDisplay && hidden == other.hidden && unchanged == other.unchanged;
+}
+
+bool Entry::operator!=(const Entry &other) const
+{
+    return !(*this == other);
+}
+
+QString scanScript(const QString &locale, const QStringList &dataDirectories, const QList<Entry> &known)
+{
+    QStringList knownFiles;
+    for (const Entry &entry : known) {
+        knownFiles << QString::number(entry.mtime) + QLatin1Char(' ') + entry.path;
+    }
+
+    // The known files go through a temporary file: in the environment a long list would hit
+    // the size limit of a single variable. Directories are in XDG precedence order; find
+    // keeps that order, so the first record per ID wins.
+    const QString script = uR"SH(
+known=$(mktemp) || exit 125
+trap 'rm -f "$known"' EXIT
+cat >"$known" <<'KONTAINER_KNOWN'
+%3
+KONTAINER_KNOWN
+set -f
+dirs=""
+IFS=:
+for dir in %4; do
+    if [ -d "$dir" ]; then
+        dirs="${dirs:+$dirs:}$dir"
+    fi
+done
+[ -n "$dirs" ] || exit 0
+find $dirs -name '*.desktop' \( -type f -o -type l \) -exec stat -L -c '%Y %n' {} + 2>/dev/null | awk -v locale=%1 -v dirs="$dirs" -v knownFile="$known" %2
+)SH"_s;
+
+    return script.arg(KShell::quoteArg(locale),
+                      KShell::quoteArg(QString::fromLatin1(ScanAwkProgram)),
+                      knownFiles.join(QLatin1Char('\n')),
+                      KShell::quoteArg(applicationDirectories(dataDirectories).join(QLatin1Char(':'))));
+}
+
+QList<Entry> mergeUnchanged(const QList<Entry> &scanned, const QList<Entry> &known)
+{
+    QHash<QString, const Entry *> knownByPath;
+    for (const Entry &entry : known) {
+        knownByPath.insert(entry.path, &entry);
+    }
+
+    QList<Entry> entries;
+    entries.reserve(scanned.size());
+    for (const Entry &entry : scanned) {
+        if (!entry.unchanged) {
+            entries.append(entry);
+            continue;
+        }
+
+        const Entry *previous = knownByPath.value(entry.path);
+        if (previous && previous->mtime == entry.mtime) {
+            entries.append(*previous);
+        }
+    }
+    return entries;
+}
+
+Entry parseDesktopEntry(const QString &basename, const QByteArray &contents, const QString &locale)
+{
+    Entry entry;
+    entry.basename = basename;
+
+    const QStringList nameKeys = localizedNameKeys(locale);
+    QStringList localizedNames(nameKeys.size());
+    bool inDesktopEntry = false;
+
+    for (QByteArray line : contents.split('\n')) {
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+        if (line.startsWith('[')) {
+            inDesktopEntry = line.trimmed() == "[Desktop Entry]";
+            continue;
+        }
+        if (!inDesktopEntry || line.startsWith('#')) {
+            continue;
+        }
+
+        const qsizetype equals = line.indexOf('=');
+        if (equals < 0) {
+            continue;
+        }
+
+        const QString key = QString::fromUtf8(line.left(equals)).trimmed();
+        const QString value = QString::fromUtf8(line.mid(equals + 1)).trimmed();
+
+        if (key == QLatin1String("Name")) {
+            entry.name = value;
+        } else if (key == QLatin1String("Icon")) {
+            entry.icon = value;
+        } else if (key == QLatin1String("Type")) {
+            entry.type = value;
+        } else if (key == QLatin1String("NoDisplay")) {
+            entry.noDisplay = value == QLatin1String("true");
+        } else if (key == QLatin1String("Hidden")) {
+            entry.hidden = value == QLatin1String("true");
+        } else if (const qsizetype index = nameKeys.indexOf(key); index >= 0) {
+            localizedNames[index] = value;
+        }
+    }
+
+    for (const QString &localizedName : std::as_const(localizedNames)) {
+        if (!localizedName.isEmpty()) {
+            entry.localizedName = localizedName;
+            break;
+        }
+    }
+
+    return entry;
+}
+
+std::optional<QList<Entry>> scanFilesystem(const ContainerFilesystem &filesystem, const QString &locale, const QList<Entry> &known)
+{
+    if (!filesystem.isValid()) {
+        return std::nullopt;
+    }
+
+    QHash<QString, const Entry *> knownByPath;
+    for (const Entry &entry : known) {
+        knownByPath.insert(entry.path, &entry);
+    }
+
+    QList<Entry> entries;
+    QSet<QString> seen;
+
+    for (const QString &directory : applicationDirectories(filesystem.dataDirectories())) {
+        for (const ContainerFilesystem::File &file : filesystem.findFiles(directory, {u"*.desktop"_s})) {
+            // Desktop file ID: path relative to the applications directory, with '/' replaced by '-'
+            QString basename = file.path.mid(directory.size() + 1);
+            basename.chop(8);
+            basename.replace(QLatin1Char('/'), QLatin1Char('-'));
+            if (seen.contains(basename)) {
+                continue;
+            }
+            seen.insert(basename);
+
+            // Like stat -L in scanScript(), links report the mtime of their target
+            const QString resolved = filesystem.hostPath(file.path);
+            if (resolved.isEmpty()) {
+                continue;
+            }
+            const qint64 mtime = QFileInfo(resolved).lastModified().toSecsSinceEpoch();
+
+            const Entry *previous = knownByPath.value(file.path);
+            if (previous && previous->mtime == mtime && previous->basename == basename) {
+                entries.append(*previous);
+                continue;
+            }
+
+            QFile desktopFile(resolved);
+            if (!desktopFile.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+
+            Entry entry = parseDesktopEntry(basename, desktopFile.readAll(), locale);
+            entry.path = file.path;
+            entry.mtime = mtime;
+            entries.append(entry);
+        }
+    }
+
+    return entries;
+}
+
+QList<Entry> Parser::feed(const QByteArray &chunk)
+{
+    m_pending += chunk;
+
+    QList<Entry> entries;
+    qsizetype start = 0;
+    qsizetype newline;
+    while ((newline = m_pending.indexOf('\n', start)) >= 0) {
+        const QList<QByteArray> fields = m_pending.mid(start, newline - start).split(FieldSeparator);
+        start = newline + 1;
+
+        if (fields.size() != FieldCount && fields.size() != UnchangedFieldCount) {
+            continue;
+        }
+
+        Entry entry;
+        entry.basename = QString::fromUtf8(fields.at(0));
+        entry.path = QString::fromUtf8(fields.at(1));
+        entry.mtime = fields.at(2).toLongLong();
+        if (fields.size() == UnchangedFieldCount) {
+            entry.unchanged = true;
+            entries.append(entry);
+            continue;
+        }
+        entry.name = QString::fromUtf8(fields.at(3));
+        entry.localizedName = QString::fromUtf8(fields.at(4));
+        entry.icon = QString::fromUtf8(fields.at(5));
+        entry.type = QString::fromUtf8(fields.at(6));
+        entry.noDisplay = fields.at(7).trimmed() == "true";
+        entry.hidden = fields.at(8).trimmed() == "true";
+        entries.append(entry);
+    }
+
+    m_pending.remove(0, start);
+    return entries;
+}
+
+QList<Entry> Parser::finish()
+{
+    if (m_pending.isEmpty()) {
+        return {};
+    }
+    return feed(QByteArrayLiteral("\n"));
+}
+
+std::optional<QList<Entry>> loadCache(const QString &container, const QString &containerId, const QString &locale)
+{
+    QFile file(cacheFilePath(container));
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    const QJsonObject catalog = QJsonDocument::fromJson(file.readAll()).object();
+    if (catalog.value(QLatin1String("version")).toInt() != CacheVersion || catalog.value(QLatin1String("locale")).toString() != locale) {
+        return std::nullopt;
+    }
+
+    // A container recreated under the same name has different applications
+    const QString cachedId = catalog.value(QLatin1String("id")).toString();
+    if (!containerId.isEmpty() && !cachedId.isEmpty() && cachedId != containerId) {
+        qDebug() << "Discarding the application catalog of" << container << "saved for another container of that name";
+        return std::nullopt;
+    }
+
+    QList<Entry> entries;
+    const QJsonArray array = catalog.value(QLatin1String("entries")).toArray();
+    entries.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        entries.append(entryFromJson(value.toObject()));
+    }
+    return entries;
+}
+
+void saveCache(const QString &container, const QString &containerId, const QString &locale, const QList<Entry> &entries)
+{
+    const QString path = cacheFilePath(container);
+    if (path.isEmpty()) {
+        return;
+    }
+    QDir().mkpath(QFileInfo(path).path());
+
+    QJsonArray array;
+    for (const Entry &entry : entries) {
+        array.append(entryToJson(entry));
+    }
+
+    QJsonObject catalog;
+    catalog[u"version"_s] = CacheVersion;
+    catalog[u"id"_s] = containerId;
+    catalog[u"locale"_s] = locale;
+    catalog[u"entries"_s] = array;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write the application catalog of" << container << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(catalog).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Cannot write the application catalog of" << container << file.errorString();
+    }
+}
+
+void removeCache(const QString &container)
+{
+    const QString path = cacheFilePath(container);
+    if (!path.isEmpty()) {
+        QFile::remove(path);
+    }
+}
+}
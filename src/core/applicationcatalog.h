@@ -0,0 +1,131 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+class ContainerFilesystem;
+
+/**
+ * @brief Scan of the desktop applications installed inside a container
+ *
+ * A single script walks every XDG applications directory in the container and prints
+ * one record per desktop file, so listing the applications costs one round trip
+ * regardless of how many are installed.
+ *
+ * The result is kept on disk per container, so a catalog can be shown right away and
+ * then revalidated by a scan that only reads the desktop files that changed since.
+ */
+namespace ApplicationCatalog
+{
+/**
+ * @struct Entry
+ * @brief Desktop file found inside a container
+ */
+struct Entry {
+    QString basename; ///< Desktop file ID without the .desktop suffix
+    QString path; ///< Absolute path of the desktop file inside the container
+    qint64 mtime = 0; ///< Modification time in seconds since the epoch
+    QString name; ///< Untranslated Name
+    QString localizedName; ///< Name for the host locale, empty if not translated
+    QString icon; ///< Icon name or path
+    QString type; ///< Desktop entry Type
+    bool noDisplay = false;
+    bool hidden = false;
+    bool unchanged = false; ///< Set by scanScript() records for known files that were not read again
+
+    bool operator==(const Entry &other) const;
+    bool operator!=(const Entry &other) const;
+
+    /**
+     * @brief Whether the entry is an application meant to be shown in menus
+     */
+    bool isVisibleApplication() const;
+
+    /**
+     * @brief Localized name if there is one, the untranslated name otherwise
+     */
+    QString displayName() const;
+};
+
+/**
+ * @brief Returns the script listing every desktop file in the container
+ * @param locale Host locale used to pick the localized Name, e.g. "de_DE"
+ * @param dataDirectories XDG data directories to search, see ContainerFilesystem::dataDirectories()
+ * @param known Entries from an earlier scan; files whose path and mtime match one of
+ *        them are not read again and come back with only Entry::unchanged set
+ *
+ * Directories shared with the host (home directories and /run/host) are skipped, so
+ * applications already exported from other containers don't show up. When a desktop
+ * file ID exists in several directories, the one with the highest XDG precedence wins.
+ */
+QString scanScript(const QString &locale, const QStringList &dataDirectories, const QList<Entry> &known = {});
+
+/**
+ * @brief Replaces the Entry::unchanged records of a scanScript() result by the matching @p known entries
+ */
+QList<Entry> mergeUnchanged(const QList<Entry> &scanned, const QList<Entry> &known);
+
+/**
+ * @brief Reads the same information as scanScript() straight from the container's layers
+ * @param known Entries from an earlier scan, reused for files whose mtime didn't change
+ * @return The entries, or std::nullopt if @p filesystem can't be read from the host
+ *
+ * Searches the same directories as scanScript() does for the filesystem's
+ * dataDirectories(), so both give the same catalog. Safe to call from any thread.
+ */
+std::optional<QList<Entry>> scanFilesystem(const ContainerFilesystem &filesystem, const QString &locale, const QList<Entry> &known = {});
+
+/**
+ * @brief Loads the catalog saved for @p container by saveCache()
+ * @param containerId Engine ID of the container; a catalog saved for another container
+ *        of the same name is ignored. May be empty if the ID isn't known yet.
+ * @param locale Locale the names have to be localized for
+ * @return The cached entries, or std::nullopt if there is no usable catalog
+ */
+std::optional<QList<Entry>> loadCache(const QString &container, const QString &containerId, const QString &locale);
+
+/**
+ * @brief Saves the catalog of @p container for loadCache()
+ */
+void saveCache(const QString &container, const QString &containerId, const QString &locale, const QList<Entry> &entries);
+
+/**
+ * @brief Deletes the saved catalog of @p container
+ */
+void removeCache(const QString &container);
+
+/**
+ * @brief Parses the [Desktop Entry] group of a desktop file
+ * @param basename Desktop file ID without the .desktop suffix
+ */
+Entry parseDesktopEntry(const QString &basename, const QByteArray &contents, const QString &locale);
+
+/**
+ * @class Parser
+ * @brief Incremental parser for the output of scanScript()
+ */
+class Parser
+{
+public:
+    /**
+     * @brief Parses the complete records contained in @p chunk and any data left from earlier chunks
+     */
+    QList<Entry> feed(const QByteArray &chunk);
+
+    /**
+     * @brief Parses whatever is left once the output ended
+     */
+    QList<Entry> finish();
+
+private:
+    QByteArray m_pending;
+};
+}
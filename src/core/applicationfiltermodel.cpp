@@ -0,0 +1,237 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "applicationfiltermodel.h"
+#include "applicationlistmodel.h"
+
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Scores of the match kinds, the position of the match breaks ties within a kind
+constexpr int PrefixScore = 4000;
+constexpr int WordStartScore = 3000;
+constexpr int SubstringScore = 2000;
+constexpr int FuzzyScore = 1000;
+}
+
+ApplicationFilterModel::ApplicationFilterModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+    , m_filterTimer(new QTimer(this))
+{
+    m_filterTimer->setSingleShot(true);
+    m_filterTimer->setInterval(DefaultFilterDelay);
+    connect(m_filterTimer, &QTimer::timeout, this, &ApplicationFilterModel::applyFilter);
+
+    connect(this, &QAbstractItemModel::rowsInserted, this, &ApplicationFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &ApplicationFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &ApplicationFilterModel::countChanged);
+    connect(this, &QAbstractItemModel::layoutChanged, this, &ApplicationFilterModel::countChanged);
+
+    setDynamicSortFilter(true);
+    sort(0);
+}
+
+QString ApplicationFilterModel::filterText() const
+{
+    return m_filterText;
+}
+
+void ApplicationFilterModel::setFilterText(const QString &text)
+{
+    if (m_filterText == text) {
+        return;
+    }
+    m_filterText = text;
+    Q_EMIT filterTextChanged();
+
+    // Going back to the full list needs no ranking, and shouldn't lag behind
+    if (text.trimmed().isEmpty()) {
+        m_filterTimer->stop();
+        applyFilter();
+    } else {
+        m_filterTimer->start();
+    }
+}
+
+bool ApplicationFilterModel::isFuzzy() const
+{
+    return m_fuzzy;
+}
+
+void ApplicationFilterModel::setFuzzy(bool fuzzy)
+{
+    if (m_fuzzy == fuzzy) {
+        return;
+    }
+    m_fuzzy = fuzzy;
+    Q_EMIT fuzzyChanged();
+    applyFilter();
+}
+
+int ApplicationFilterModel::filterDelay() const
+{
+    return m_filterTimer->interval();
+}
+
+void ApplicationFilterModel::setFilterDelay(int delay)
+{
+    if (m_filterTimer->interval() == delay) {
+        return;
+    }
+    m_filterTimer->setInterval(delay);
+    Q_EMIT filterDelayChanged();
+}
+
+int ApplicationFilterModel::count() const
+{
+    return rowCount();
+}
+
+void ApplicationFilterModel::setSourceModel(QAbstractItemModel *model)
+{
+    if (QAbstractItemModel *previous = sourceModel()) {
+        disconnect(previous, nullptr, this, nullptr);
+    }
+
+    // Connected before the proxy connects its own handlers, so the index is already
+    // marked stale when they filter the changed rows
+    if (model) {
+        connect(model, &QAbstractItemModel::rowsInserted, this, &ApplicationFilterModel::invalidateIndex);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, &ApplicationFilterModel::invalidateIndex);
+        connect(model, &QAbstractItemModel::rowsMoved, this, &ApplicationFilterModel::invalidateIndex);
+        connect(model, &QAbstractItemModel::modelReset, this, &ApplicationFilterModel::invalidateIndex);
+        connect(model, &QAbstractItemModel::layoutChanged, this, &ApplicationFilterModel::invalidateIndex);
+        connect(model, &QAbstractItemModel::dataChanged, this, [this](const QModelIndex &, const QModelIndex &, const QList<int> &roles) {
+            // Toggling the exported flag doesn't change what is searched
+            if (roles.isEmpty() || roles.contains(ApplicationListModel::NameRole) || roles.contains(ApplicationListModel::BasenameRole)) {
+                invalidateIndex();
+            }
+        });
+    }
+
+    invalidateIndex();
+    QSortFilterProxyModel::setSourceModel(model);
+    Q_EMIT countChanged();
+}
+
+QString ApplicationFilterModel::normalize(const QString &text)
+{
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+    QString normalized;
+    normalized.reserve(decomposed.size());
+    for (const QChar c : decomposed) {
+        if (!c.isMark()) {
+            normalized.append(c.toLower());
+        }
+    }
+    return normalized;
+}
+
+int ApplicationFilterModel::score(const QString &text, const QString &query, bool fuzzy)
+{
+    if (query.isEmpty()) {
+        return SubstringScore;
+    }
+
+    const qsizetype position = text.indexOf(query);
+    if (position == 0) {
+        return PrefixScore;
+    }
+    if (position > 0) {
+        // Earlier matches rank higher within their kind
+        const int tieBreak = int(qMax<qsizetype>(0, 999 - position));
+        return (text.at(position - 1).isLetterOrNumber() ? SubstringScore : WordStartScore) + tieBreak;
+    }
+    if (!fuzzy) {
+        return 0;
+    }
+
+    // The query's characters in order; tighter matches rank higher
+    qsizetype next = 0;
+    qsizetype first = -1;
+    for (const QChar c : query) {
+        next = text.indexOf(c, next);
+        if (next < 0) {
+            return 0;
+        }
+        if (first < 0) {
+            first = next;
+        }
+        ++next;
+    }
+    const qsizetype span = next - first;
+    return FuzzyScore + int(qMax<qsizetype>(0, 999 - (span - query.size())));
+}
+
+bool ApplicationFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+
+    ensureScores();
+    return sourceRow < m_scores.size() && m_scores.at(sourceRow) > 0;
+}
+
+bool ApplicationFilterModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    ensureScores();
+    const int leftScore = m_scores.value(left.row());
+    const int rightScore = m_scores.value(right.row());
+
+    // Best matches first, the source order among equals
+    if (leftScore != rightScore) {
+        return leftScore > rightScore;
+    }
+    return left.row() < right.row();
+}
+
+void ApplicationFilterModel::applyFilter()
+{
+    m_query = normalize(m_filterText.trimmed());
+    m_scores.clear();
+    invalidate();
+    Q_EMIT countChanged();
+}
+
+void ApplicationFilterModel::invalidateIndex()
+{
+    m_indexValid = false;
+}
+
+void ApplicationFilterModel::ensureScores() const
+{
+    const QAbstractItemModel *model = sourceModel();
+    if (!model) {
+        m_names.clear();
+        m_basenames.clear();
+        m_scores.clear();
+        return;
+    }
+
+    if (!m_indexValid) {
+        m_names.clear();
+        m_basenames.clear();
+        m_names.reserve(model->rowCount());
+        m_basenames.reserve(model->rowCount());
+        for (int row = 0; row < model->rowCount(); ++row) {
+            const QModelIndex index = model->index(row, 0);
+            m_names.append(normalize(index.data(ApplicationListModel::NameRole).toString()));
+            m_basenames.append(normalize(index.data(ApplicationListModel::BasenameRole).toString()));
+        }
+        m_indexValid = true;
+        m_scores.clear();
+    }
+
+    // Scored per field, so a match can't span the end of the name and the start of the basename
+    if (m_scores.size() != m_names.size()) {
+        m_scores.clear();
+        m_scores.reserve(m_names.size());
+        for (qsizetype row = 0; row < m_names.size(); ++row) {
+            m_scores.append(qMax(score(m_names.at(row), m_query, m_fuzzy), score(m_basenames.at(row), m_query, m_fuzzy)));
+        }
+    }
+}
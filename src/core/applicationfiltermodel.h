@@ -0,0 +1,102 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QList>
+#include <QSortFilterProxyModel>
+#include <QString>
+#include <qqmlintegration.h>
+
+class QTimer;
+
+/**
+ * @class ApplicationFilterModel
+ * @brief Search over an ApplicationListModel for the applications window
+ *
+ * Name and basename of every row are normalized once (lowercased, accents removed)
+ * and kept until the source rows change, so a keystroke only compares strings that
+ * are ready to use. Matches are ranked: prefix before word start before substring,
+ * and with fuzzy enabled, rows containing the typed characters in order come last.
+ *
+ * Typing is debounced by filterDelay milliseconds; clearing the search applies at once.
+ */
+class ApplicationFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    /**
+     * @brief Text typed by the user; applied after filterDelay
+     */
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+
+    /**
+     * @brief Whether rows matching the typed characters in order, not contiguously, are shown
+     */
+    Q_PROPERTY(bool fuzzy READ isFuzzy WRITE setFuzzy NOTIFY fuzzyChanged)
+
+    Q_PROPERTY(int filterDelay READ filterDelay WRITE setFilterDelay NOTIFY filterDelayChanged)
+
+    /**
+     * @brief Number of rows passing the filter
+     */
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    static constexpr int DefaultFilterDelay = 150; ///< Milliseconds
+
+    explicit ApplicationFilterModel(QObject *parent = nullptr);
+
+    QString filterText() const;
+    void setFilterText(const QString &text);
+
+    bool isFuzzy() const;
+    void setFuzzy(bool fuzzy);
+
+    int filterDelay() const;
+    void setFilterDelay(int delay);
+
+    int count() const;
+
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
+    /**
+     * @brief Lowercases @p text and strips diacritics, e.g. "Éditeur" becomes "editeur"
+     */
+    static QString normalize(const QString &text);
+
+    /**
+     * @brief Ranks how well @p text matches @p query, both normalized
+     * @return 0 for no match; higher is better
+     */
+    static int score(const QString &text, const QString &query, bool fuzzy);
+
+Q_SIGNALS:
+    void filterTextChanged();
+    void fuzzyChanged();
+    void filterDelayChanged();
+    void countChanged();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    void applyFilter();
+    void invalidateIndex();
+    void ensureScores() const;
+
+    QString m_filterText; ///< As typed
+    QString m_query; ///< Normalized text of the applied filter
+    bool m_fuzzy = true;
+    QTimer *m_filterTimer;
+
+    // Derived from the source rows, rebuilt on first use after they changed
+    mutable bool m_indexValid = false;
+    mutable QList<QString> m_names; ///< Normalized name per source row
+    mutable QList<QString> m_basenames; ///< Normalized basename per source row
+    mutable QList<int> m_scores; ///< score() of each source row for m_query
+};
@@ -0,0 +1,148 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "applicationlistmodel.h"
+
+bool ApplicationRow::operator==(const ApplicationRow &other) const
+{
+    return basename == other.basename && name == other.name && icon == other.icon && iconSource == other.iconSource && exported == other.exported;
+}
+
+bool ApplicationRow::operator!=(const ApplicationRow &other) const
+{
+    return !(*this == other);
+}
+
+ApplicationListModel::ApplicationListModel(QObject *parent)
+    : KeyedListModel(parent)
+{
+    connect(this, &QAbstractItemModel::rowsInserted, this, &ApplicationListModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &ApplicationListModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &ApplicationListModel::countChanged);
+}
+
+QVariant ApplicationListModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+        return {};
+    }
+
+    const Application &application = rows().at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return application.name.isEmpty() ? application.basename : application.name;
+    case BasenameRole:
+        return application.basename;
+    case IconRole:
+        return application.icon;
+    case IconSourceRole:
+        return application.iconSource;
+    case ExportedRole:
+        return application.exported;
+    }
+    return {};
+}
+
+QHash<int, QByteArray> ApplicationListModel::roleNames() const
+{
+    return {
+        {BasenameRole, "basename"},
+        {NameRole, "name"},
+        {IconRole, "icon"},
+        {IconSourceRole, "iconSource"},
+        {ExportedRole, "exported"},
+    };
+}
+
+void ApplicationListModel::setApplications(const QList<Application> &applications)
+{
+    // Strings only used by rows that go away are dropped from the pool
+    m_strings.clear();
+    for (const Application &application : rows()) {
+        intern(application);
+    }
+
+    QList<Application> interned;
+    interned.reserve(applications.size());
+    for (const Application &application : applications) {
+        interned.append(intern(application));
+    }
+    setRows(interned);
+}
+
+void ApplicationListModel::insertOrUpdate(const Application &application)
+{
+    insertOrUpdateRow(intern(application));
+}
+
+void ApplicationListModel::remove(const QString &basename)
+{
+    removeKey(basename);
+}
+
+void ApplicationListModel::setExported(const QString &basename, bool exported)
+{
+    const int row = rowOf(basename);
+    if (row < 0) {
+        return;
+    }
+
+    Application application = rows().at(row);
+    application.exported = exported;
+    updateRow(row, application, {ExportedRole});
+}
+
+void ApplicationListModel::updateExported(const QSet<QString> &basenames)
+{
+    for (int row = 0; row < count(); ++row) {
+        Application application = rows().at(row);
+        application.exported = basenames.contains(application.basename);
+        updateRow(row, application, {ExportedRole});
+    }
+}
+
+std::optional<ApplicationListModel::Application> ApplicationListModel::application(const QString &basename) const
+{
+    const int row = rowOf(basename);
+    if (row < 0) {
+        return std::nullopt;
+    }
+    return rows().at(row);
+}
+
+bool ApplicationListModel::contains(const QString &basename) const
+{
+    return rowOf(basename) >= 0;
+}
+
+QString ApplicationListModel::keyOf(const Application &application) const
+{
+    return application.basename;
+}
+
+ApplicationListModel::Application ApplicationListModel::intern(const Application &application)
+{
+    Application interned = application;
+    interned.basename = intern(application.basename);
+    interned.name = intern(application.name);
+    interned.icon = intern(application.icon);
+    interned.iconSource = intern(application.iconSource);
+    return interned;
+}
+
+QString ApplicationListModel::intern(const QString &string)
+{
+    if (string.isEmpty()) {
+        return {};
+    }
+
+    const auto it = m_strings.constFind(string);
+    if (it != m_strings.constEnd()) {
+        return *it;
+    }
+    m_strings.insert(string);
+    return string;
+}
@@ -0,0 +1,99 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "keyedlistmodel.h"
+
+#include <QSet>
+#include <QString>
+#include <optional>
+
+/**
+ * @struct ApplicationRow
+ * @brief One row of ApplicationListModel
+ */
+struct ApplicationRow {
+    QString basename;
+    QString name;
+    QString icon;
+    QString iconSource;
+    bool exported = false;
+
+    bool operator==(const ApplicationRow &other) const;
+    bool operator!=(const ApplicationRow &other) const;
+};
+
+/**
+ * @class ApplicationListModel
+ * @brief Applications of a container, or the ones exported from it, for the applications window
+ *
+ * Rows are keyed by the desktop file basename, which is unique within the model.
+ * Exporting or unexporting an application touches a single row.
+ *
+ * Strings that repeat between rows, typically icon names, share their storage.
+ */
+class ApplicationListModel : public KeyedListModel<ApplicationRow>
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        BasenameRole = Qt::UserRole + 1,
+        NameRole,
+        IconRole, ///< Icon name or path from the desktop file
+        IconSourceRole, ///< image://kontainer-icon/ URL of a cached icon, empty if there is none
+        ExportedRole,
+    };
+    Q_ENUM(Roles)
+
+    using Application = ApplicationRow;
+
+    explicit ApplicationListModel(QObject *parent = nullptr);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Replaces the rows by @p applications with the fewest possible changes
+     *
+     * Later duplicates of a basename are dropped.
+     */
+    void setApplications(const QList<Application> &applications);
+
+    /**
+     * @brief Updates the row of @p application, or appends one if there is none
+     */
+    void insertOrUpdate(const Application &application);
+
+    void remove(const QString &basename);
+
+    /**
+     * @brief Updates the exported flag of one row, if the model has it
+     */
+    void setExported(const QString &basename, bool exported);
+
+    /**
+     * @brief Marks exactly the rows in @p basenames as exported
+     */
+    void updateExported(const QSet<QString> &basenames);
+
+    std::optional<Application> application(const QString &basename) const;
+
+    Q_INVOKABLE bool contains(const QString &basename) const;
+
+Q_SIGNALS:
+    void countChanged();
+
+protected:
+    QString keyOf(const Application &application) const override;
+
+private:
+    Application intern(const Application &application);
+    QString intern(const QString &string);
+
+    QSet<QString> m_strings; ///< Shared instances of the strings in the rows
+};
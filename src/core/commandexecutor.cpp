@@ -0,0 +1,232 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "commandexecutor.h"
+#include "distroboxcli.h"
+#include "hosthelper.h"
+#include "shellsession.h"
+
+#include <QCoreApplication>
+#include <QFutureWatcher>
+#include <QProcess>
+#include <QThread>
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Time a process gets to exit after SIGTERM before it is killed
+constexpr int TerminateGracePeriod = 3000;
+
+struct JobState {
+    bool timedOut = false;
+    bool canceled = false;
+};
+
+void terminateProcess(QProcess *process)
+{
+    if (process->state() == QProcess::NotRunning) {
+        return;
+    }
+
+    // SIGTERM first so flatpak-spawn can forward it to the host process
+    process->terminate();
+    QTimer::singleShot(TerminateGracePeriod, process, [process]() {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+        }
+    });
+}
+}
+
+CommandExecutor *CommandExecutor::instance()
+{
+    static CommandExecutor *executor = new CommandExecutor(QCoreApplication::instance());
+    return executor;
+}
+
+CommandExecutor::CommandExecutor(QObject *parent)
+    : QObject(parent)
+    , m_maxConcurrent(qMax(2, QThread::idealThreadCount()))
+{
+}
+
+CommandExecutor::~CommandExecutor() = default;
+
+QFuture<CommandResult> CommandExecutor::run(const QString &command, int timeoutMs)
+{
+    Job job;
+    job.command = command;
+    job.timeoutMs = timeoutMs;
+    job.promise = std::make_shared<QPromise<CommandResult>>();
+    job.promise->start();
+
+    QFuture<CommandResult> future = job.promise->future();
+    m_queue.enqueue(job);
+    startNext();
+    return future;
+}
+
+void CommandExecutor::onFinished(const QFuture<CommandResult> &future, QObject *context, const std::function<void(const CommandResult &)> &handler)
+{
+    auto *watcher = new QFutureWatcher<CommandResult>(context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, handler]() {
+        const QFuture<CommandResult> finishedFuture = watcher->future();
+        CommandResult result;
+        if (finishedFuture.isCanceled() || finishedFuture.resultCount() == 0) {
+            result.canceled = true;
+        } else {
+            result = finishedFuture.result();
+        }
+
+        watcher->deleteLater();
+        if (handler) {
+            handler(result);
+        }
+    });
+    watcher->setFuture(future);
+}
+
+int CommandExecutor::maxConcurrent() const
+{
+    return m_maxConcurrent;
+}
+
+void CommandExecutor::setMaxConcurrent(int maxConcurrent)
+{
+    m_maxConcurrent = qMax(1, maxConcurrent);
+    startNext();
+}
+
+int CommandExecutor::runningCount() const
+{
+    return m_running.size();
+}
+
+int CommandExecutor::queuedCount() const
+{
+    return m_queue.size();
+}
+
+void CommandExecutor::cancelAll()
+{
+    const auto queued = m_queue;
+    for (const Job &job : queued) {
+        job.promise->future().cancel();
+    }
+
+    const auto running = m_running;
+    for (const auto &promise : running) {
+        promise->future().cancel();
+    }
+
+    startNext();
+}
+
+void CommandExecutor::startNext()
+{
+    while (m_running.size() < m_maxConcurrent && !m_queue.isEmpty()) {
+        const Job job = m_queue.dequeue();
+
+        // Canceled while still waiting in the queue
+        if (job.promise->isCanceled()) {
+            job.promise->finish();
+            continue;
+        }
+
+        startJob(job);
+    }
+}
+
+void CommandExecutor::startJob(const Job &job)
+{
+    if (HostHelper::isEnabled()) {
+        startHelperJob(job);
+        return;
+    }
+
+    const auto promise = job.promise;
+    const auto state = std::make_shared<JobState>();
+
+    auto *process = new QProcess(this);
+    m_running.append(promise);
+
+    auto finishJob = [this, process, promise](const CommandResult &result) {
+        if (!m_running.removeOne(promise)) {
+            return;
+        }
+
+        promise->addResult(result);
+        promise->finish();
+        process->deleteLater();
+        startNext();
+    };
+
+    connect(process, &QProcess::finished, this, [process, state, finishJob](int exitCode, QProcess::ExitStatus exitStatus) {
+        CommandResult result;
+        result.output = process->readAllStandardOutput();
+        result.errorOutput = process->readAllStandardError();
+        result.exitCode = exitStatus == QProcess::NormalExit ? exitCode : -1;
+        result.timedOut = state->timedOut;
+        result.canceled = state->canceled;
+        finishJob(result);
+    });
+
+    connect(process, &QProcess::errorOccurred, this, [process, finishJob](QProcess::ProcessError error) {
+        // Every other error is followed by finished()
+        if (error != QProcess::FailedToStart) {
+            return;
+        }
+
+        CommandResult result;
+        result.errorOutput = process->errorString().toUtf8();
+        finishJob(result);
+    });
+
+    auto *watcher = new QFutureWatcher<CommandResult>(process);
+    connect(watcher, &QFutureWatcherBase::canceled, process, [process, state]() {
+        state->canceled = true;
+        terminateProcess(process);
+    });
+    watcher->setFuture(promise->future());
+
+    if (job.timeoutMs > 0) {
+        QTimer::singleShot(job.timeoutMs, process, [process, state]() {
+            state->timedOut = true;
+            terminateProcess(process);
+        });
+    }
+
+    process->start(u"sh"_s, DistroboxCli::hostShellArguments(job.command));
+}
+
+void CommandExecutor::startHelperJob(const Job &job)
+{
+    const auto promise = job.promise;
+
+    // Each running command gets a helper of its own, so commands don't wait for each other
+    ShellSession *helper = HostHelper::acquireSession();
+    const QFuture<CommandResult> helperFuture = helper->run(job.command, job.timeoutMs);
+    m_running.append(promise);
+
+    auto *watcher = new QFutureWatcher<CommandResult>(this);
+    connect(watcher, &QFutureWatcherBase::canceled, helper, [helperFuture]() mutable {
+        helperFuture.cancel();
+    });
+    watcher->setFuture(promise->future());
+
+    onFinished(helperFuture, this, [this, promise, helper, watcher](const CommandResult &result) {
+        watcher->deleteLater();
+        HostHelper::releaseSession(helper);
+        if (!m_running.removeOne(promise)) {
+            return;
+        }
+
+        promise->addResult(result);
+        promise->finish();
+        startNext();
+    });
+}
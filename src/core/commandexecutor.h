@@ -0,0 +1,115 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QFuture>
+#include <QObject>
+#include <QPromise>
+#include <QQueue>
+#include <QString>
+#include <functional>
+#include <memory>
+
+/**
+ * @struct CommandResult
+ * @brief Outcome of a host command run through the CommandExecutor
+ */
+struct CommandResult {
+    QByteArray output; ///< Raw standard output of the command
+    QByteArray errorOutput; ///< Raw standard error of the command
+    int exitCode = -1; ///< Exit code, -1 if the process did not exit normally
+    bool timedOut = false; ///< The command was killed because it exceeded its timeout
+    bool canceled = false; ///< The command was canceled before it finished
+
+    /**
+     * @brief Whether the command exited normally with exit code 0
+     */
+    bool success() const
+    {
+        return exitCode == 0 && !timedOut && !canceled;
+    }
+
+    /**
+     * @brief Standard output decoded as UTF-8
+     */
+    QString text() const
+    {
+        return QString::fromUtf8(output);
+    }
+};
+
+/**
+ * @class CommandExecutor
+ * @brief Runs host commands asynchronously with timeouts, cancellation and bounded concurrency
+ *
+ * Every call to run() returns immediately with a QFuture that is fulfilled once the
+ * command exits, times out or is canceled. Calling QFuture::cancel() on the returned
+ * future terminates the underlying process (or drops it from the queue if it has not
+ * started yet). At most maxConcurrent() processes run at the same time; additional
+ * commands wait in a FIFO queue.
+ *
+ * When HostHelper is enabled, commands run on pooled helper shells instead of one
+ * flatpak-spawn process each.
+ */
+class CommandExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultTimeout = 30000; ///< Default per-command timeout in milliseconds
+    static constexpr int NoTimeout = 0; ///< Disables the timeout for long running commands
+
+    /**
+     * @brief Returns the application-wide executor instance
+     */
+    static CommandExecutor *instance();
+
+    explicit CommandExecutor(QObject *parent = nullptr);
+    ~CommandExecutor() override;
+
+    /**
+     * @brief Queues a shell command for execution on the host
+     * @param command Command line, interpreted by sh
+     * @param timeoutMs Timeout in milliseconds, or NoTimeout
+     * @return Future holding the CommandResult
+     */
+    QFuture<CommandResult> run(const QString &command, int timeoutMs = DefaultTimeout);
+
+    /**
+     * @brief Invokes @p handler with the result of @p future on the thread of @p context
+     *
+     * Unlike QFuture::then(), the handler is also invoked for canceled futures,
+     * in which case it receives a CommandResult with canceled set.
+     */
+    static void onFinished(const QFuture<CommandResult> &future, QObject *context, const std::function<void(const CommandResult &)> &handler);
+
+    int maxConcurrent() const;
+    void setMaxConcurrent(int maxConcurrent);
+
+    int runningCount() const;
+    int queuedCount() const;
+
+    /**
+     * @brief Cancels every queued and running command
+     */
+    void cancelAll();
+
+private:
+    struct Job {
+        QString command;
+        int timeoutMs = DefaultTimeout;
+        std::shared_ptr<QPromise<CommandResult>> promise;
+    };
+
+    void startNext();
+    void startJob(const Job &job);
+    void startHelperJob(const Job &job);
+
+    QQueue<Job> m_queue;
+    QList<std::shared_ptr<QPromise<CommandResult>>> m_running;
+    int m_maxConcurrent;
+};
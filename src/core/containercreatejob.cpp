@@ -0,0 +1,248 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containercreatejob.h"
+#include "distroboxcli.h"
+#include "imagepuller.h"
+
+#include <QDebug>
+#include <QProcess>
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Progress messages arrive many times a second during a pull, the UI doesn't need them all
+constexpr int ProgressInterval = 100;
+
+// Output kept for output(), older lines are dropped
+constexpr qsizetype MaximumOutput = 256 * 1024;
+
+// Time distrobox create gets to exit after SIGTERM before it is killed
+constexpr int TerminateGracePeriod = 3000;
+}
+
+ContainerCreateJob::ContainerCreateJob(const QString &name, const QString &image, const QString &command, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+    , m_image(image)
+    , m_command(command)
+    , m_progressTimer(new QTimer(this))
+{
+    m_progressTimer->setSingleShot(true);
+    m_progressTimer->setInterval(ProgressInterval);
+    connect(m_progressTimer, &QTimer::timeout, this, &ContainerCreateJob::progressChanged);
+}
+
+ContainerCreateJob::~ContainerCreateJob()
+{
+    if (m_process) {
+        m_process->disconnect(this);
+    }
+}
+
+QString ContainerCreateJob::name() const
+{
+    return m_name;
+}
+
+QString ContainerCreateJob::image() const
+{
+    return m_image;
+}
+
+ContainerCreateJob::Stage ContainerCreateJob::stage() const
+{
+    return m_stage;
+}
+
+bool ContainerCreateJob::isFinished() const
+{
+    return m_stage == Succeeded || m_stage == Failed || m_stage == Canceled;
+}
+
+qint64 ContainerCreateJob::bytesDone() const
+{
+    return m_progress.bytesDone();
+}
+
+qint64 ContainerCreateJob::bytesTotal() const
+{
+    return m_progress.bytesTotal();
+}
+
+int ContainerCreateJob::layersDone() const
+{
+    return m_progress.layersDone();
+}
+
+int ContainerCreateJob::layerCount() const
+{
+    return int(m_progress.layers().size());
+}
+
+QVariantList ContainerCreateJob::layers() const
+{
+    return m_progress.layersVariant();
+}
+
+QString ContainerCreateJob::lastLine() const
+{
+    return m_lastLine;
+}
+
+QString ContainerCreateJob::output() const
+{
+    return m_output;
+}
+
+void ContainerCreateJob::start()
+{
+    m_timer.start();
+    pullThroughApi();
+}
+
+void ContainerCreateJob::cancel()
+{
+    if (isFinished() || m_canceled) {
+        return;
+    }
+    m_canceled = true;
+
+    if (m_pull) {
+        // ImagePuller cancels the pull once nobody else waits for the image
+        m_pull->disconnect(this);
+        ImagePuller::instance()->release(m_pull->image(), this);
+        m_pull = nullptr;
+        setStage(Canceled);
+        Q_EMIT finished(false);
+    } else if (m_process) {
+        m_process->terminate();
+        QTimer::singleShot(TerminateGracePeriod, m_process, [process = m_process]() {
+            if (process->state() != QProcess::NotRunning) {
+                process->kill();
+            }
+        });
+    } else {
+        setStage(Canceled);
+        Q_EMIT finished(false);
+    }
+}
+
+void ContainerCreateJob::pullThroughApi()
+{
+    m_pull = ImagePuller::instance()->pull(m_image, this);
+    if (!m_pull) {
+        runCreate();
+        return;
+    }
+
+    if (m_pull->isFinished()) {
+        pullFinished();
+        return;
+    }
+
+    connect(m_pull, &ImagePull::progressChanged, this, [this]() {
+        m_progress = m_pull->progress();
+        scheduleProgress();
+    });
+    connect(m_pull, &ImagePull::finished, this, &ContainerCreateJob::pullFinished);
+}
+
+void ContainerCreateJob::pullFinished()
+{
+    m_pull->disconnect(this);
+    m_progress = m_pull->progress();
+    if (m_pull->state() != ImagePull::Succeeded) {
+        // distrobox create pulls the image itself, with the engine's own name resolution
+        qWarning() << "Engine API pull of" << m_image << "failed, leaving it to distrobox:" << m_pull->error();
+    }
+    ImagePuller::instance()->release(m_pull->image(), this);
+    m_pull = nullptr;
+
+    Q_EMIT progressChanged();
+    runCreate();
+}
+
+void ContainerCreateJob::runCreate()
+{
+    setStage(Creating);
+
+    m_process = new QProcess(this);
+    m_process->setProcessChannelMode(QProcess::MergedChannels);
+
+    connect(m_process, &QProcess::readyRead, this, [this]() {
+        readOutput(false);
+    });
+    connect(m_process, &QProcess::finished, this, [this](int exitCode, QProcess::ExitStatus exitStatus) {
+        readOutput(true);
+        const bool success = !m_canceled && exitStatus == QProcess::NormalExit && exitCode == 0;
+        qDebug() << "Creating" << m_name << (success ? "succeeded" : "failed") << "after" << m_timer.elapsed() << "ms";
+        setStage(m_canceled ? Canceled : success ? Succeeded : Failed);
+        Q_EMIT progressChanged();
+        Q_EMIT finished(success);
+    });
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // Every other error is followed by finished()
+        if (error != QProcess::FailedToStart) {
+            return;
+        }
+        qWarning() << "Cannot run distrobox create:" << m_process->errorString();
+        setStage(Failed);
+        Q_EMIT finished(false);
+    });
+
+    m_process->start(u"sh"_s, DistroboxCli::hostShellArguments(m_command));
+}
+
+void ContainerCreateJob::readOutput(bool flush)
+{
+    m_pendingOutput += m_process->readAll();
+
+    // Pull progress redraws its line with carriage returns
+    qsizetype start = 0;
+    for (qsizetype i = 0; i < m_pendingOutput.size(); ++i) {
+        const char c = m_pendingOutput.at(i);
+        if (c != '\n' && c != '\r' && !(flush && i == m_pendingOutput.size() - 1)) {
+            continue;
+        }
+
+        const qsizetype end = (c == '\n' || c == '\r') ? i : i + 1;
+        const QString line = QString::fromUtf8(m_pendingOutput.mid(start, end - start)).trimmed();
+        start = i + 1;
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        m_output += line + QLatin1Char('\n');
+        m_lastLine = line;
+        if (m_progress.addLine(line)) {
+            scheduleProgress();
+        }
+        Q_EMIT outputLine(line);
+    }
+    m_pendingOutput.remove(0, start);
+
+    if (m_output.size() > MaximumOutput) {
+        m_output.remove(0, m_output.size() - MaximumOutput);
+    }
+}
+
+void ContainerCreateJob::setStage(Stage stage)
+{
+    if (m_stage == stage) {
+        return;
+    }
+    m_stage = stage;
+    Q_EMIT stageChanged();
+}
+
+void ContainerCreateJob::scheduleProgress()
+{
+    if (!m_progressTimer->isActive()) {
+        m_progressTimer->start();
+    }
+}
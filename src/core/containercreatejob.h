@@ -0,0 +1,133 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "imagepullprogress.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <qqmlintegration.h>
+
+class ImagePull;
+class QProcess;
+class QTimer;
+
+/**
+ * @class ContainerCreateJob
+ * @brief Creates a container in the background, reporting the image pull as it goes
+ *
+ * When the engine API is reachable the image is pulled through it first, which reports
+ * every layer with byte counts. The pull goes through ImagePuller, so it joins a pre-pull
+ * or another create of the same image. "distrobox create" then finds the image in place. If the
+ * API can't pull it, e.g. for a short name only the CLI resolves, distrobox pulls the
+ * image itself and the layers are followed from its output instead, without sizes.
+ *
+ * The output of distrobox is available line by line through outputLine() and lastLine.
+ */
+class ContainerCreateJob : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Returned by distroBoxManager.createContainer()")
+
+    Q_PROPERTY(QString name READ name CONSTANT)
+    Q_PROPERTY(QString image READ image CONSTANT)
+    Q_PROPERTY(Stage stage READ stage NOTIFY stageChanged)
+    Q_PROPERTY(qint64 bytesDone READ bytesDone NOTIFY progressChanged)
+    Q_PROPERTY(qint64 bytesTotal READ bytesTotal NOTIFY progressChanged)
+    Q_PROPERTY(int layersDone READ layersDone NOTIFY progressChanged)
+    Q_PROPERTY(int layerCount READ layerCount NOTIFY progressChanged)
+    Q_PROPERTY(QVariantList layers READ layers NOTIFY progressChanged)
+    Q_PROPERTY(QString lastLine READ lastLine NOTIFY outputLine)
+
+public:
+    enum Stage {
+        Pulling,
+        Creating,
+        Succeeded,
+        Failed,
+        Canceled,
+    };
+    Q_ENUM(Stage)
+
+    /**
+     * @param command distrobox create command line to run once the image is there
+     */
+    ContainerCreateJob(const QString &name, const QString &image, const QString &command, QObject *parent = nullptr);
+    ~ContainerCreateJob() override;
+
+    QString name() const;
+    QString image() const;
+    Stage stage() const;
+    bool isFinished() const;
+
+    qint64 bytesDone() const;
+
+    /**
+     * @brief Bytes of the layers known so far, 0 while the sizes are unknown
+     */
+    qint64 bytesTotal() const;
+
+    int layersDone() const;
+    int layerCount() const;
+
+    /**
+     * @brief Layers of the image, see ImagePullProgress::layersVariant()
+     */
+    QVariantList layers() const;
+
+    QString lastLine() const;
+
+    /**
+     * @brief Everything distrobox printed so far
+     */
+    Q_INVOKABLE QString output() const;
+
+    void start();
+
+    /**
+     * @brief Stops the pull or distrobox create, finished() follows
+     */
+    Q_INVOKABLE void cancel();
+
+Q_SIGNALS:
+    void stageChanged();
+    void progressChanged();
+
+    /**
+     * @brief Emitted for every line distrobox prints, standard output and error alike
+     */
+    void outputLine(const QString &line);
+
+    void finished(bool success);
+
+private:
+    void pullThroughApi();
+    void pullFinished();
+    void runCreate();
+    void readOutput(bool flush);
+    void setStage(Stage stage);
+    void scheduleProgress();
+
+    QString m_name;
+    QString m_image;
+    QString m_command;
+    Stage m_stage = Pulling;
+    ImagePullProgress m_progress;
+    QPointer<ImagePull> m_pull; ///< Shared pull of the image, held while the job is pulling
+    QProcess *m_process = nullptr;
+    QTimer *m_progressTimer;
+    QByteArray m_pendingOutput; ///< Incomplete last line
+    QString m_output;
+    QString m_lastLine;
+    bool m_canceled = false;
+    QElapsedTimer m_timer;
+};
@@ -0,0 +1,237 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containereventwatcher.h"
+#include "distroboxcli.h"
+
+#include <QDebug>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Delay before restarting the event process, doubled after every failed attempt
+constexpr int InitialRestartDelay = 1000;
+constexpr int MaximumRestartDelay = 60000;
+
+// Exit code of the events command when neither podman nor docker is installed
+constexpr int EngineNotFound = 127;
+
+struct ContainerEvent {
+    QString action;
+    QString id;
+    QString name;
+    QString image;
+    QHash<QString, QString> attributes;
+};
+
+// Podman prints {"ID", "Name", "Image", "Status", "Attributes"}, docker prints
+// {"Action", "id", "from", "Actor": {"ID", "Attributes": {"name", "image"}}}
+ContainerEvent parseEvent(const QJsonObject &object)
+{
+    ContainerEvent event;
+
+    const QJsonObject actor = object.value(QLatin1String("Actor")).toObject();
+    QJsonObject attributes = object.value(QLatin1String("Attributes")).toObject();
+    if (attributes.isEmpty()) {
+        attributes = actor.value(QLatin1String("Attributes")).toObject();
+    }
+    for (auto it = attributes.constBegin(); it != attributes.constEnd(); ++it) {
+        event.attributes.insert(it.key(), it.value().toString());
+    }
+
+    event.action = object.value(QLatin1String("Status")).toString();
+    if (event.action.isEmpty()) {
+        event.action = object.value(QLatin1String("Action")).toString();
+    }
+    // Docker appends details to some actions, e.g. "exec_start: sh"
+    event.action = event.action.section(QLatin1Char(':'), 0, 0).trimmed();
+
+    event.id = object.value(QLatin1String("ID")).toString();
+    if (event.id.isEmpty()) {
+        event.id = actor.value(QLatin1String("ID")).toString();
+    }
+
+    event.name = object.value(QLatin1String("Name")).toString();
+    if (event.name.isEmpty()) {
+        event.name = event.attributes.value(u"name"_s);
+    }
+
+    event.image = object.value(QLatin1String("Image")).toString();
+    if (event.image.isEmpty()) {
+        event.image = event.attributes.value(u"image"_s, object.value(QLatin1String("from")).toString());
+    }
+
+    return event;
+}
+}
+
+ContainerEventWatcher::ContainerEventWatcher(QObject *parent)
+    : QObject(parent)
+    , m_restartTimer(new QTimer(this))
+    , m_restartDelay(InitialRestartDelay)
+{
+    m_restartTimer->setSingleShot(true);
+    connect(m_restartTimer, &QTimer::timeout, this, &ContainerEventWatcher::launch);
+}
+
+ContainerEventWatcher::~ContainerEventWatcher()
+{
+    stop();
+}
+
+void ContainerEventWatcher::start()
+{
+    if (m_wanted) {
+        return;
+    }
+
+    m_wanted = true;
+    m_restartDelay = InitialRestartDelay;
+    launch();
+}
+
+void ContainerEventWatcher::stop()
+{
+    m_wanted = false;
+    m_restartTimer->stop();
+
+    if (m_process) {
+        QProcess *process = m_process;
+        m_process = nullptr;
+        process->disconnect(this);
+
+        // SIGTERM first so flatpak-spawn can forward it to the host process
+        process->terminate();
+        if (!process->waitForFinished(1000)) {
+            process->kill();
+            process->waitForFinished(1000);
+        }
+        process->deleteLater();
+    }
+
+    m_buffer.clear();
+    setActive(false);
+}
+
+bool ContainerEventWatcher::isActive() const
+{
+    return m_active;
+}
+
+void ContainerEventWatcher::launch()
+{
+    if (!m_wanted || m_process) {
+        return;
+    }
+
+    m_process = new QProcess(this);
+    m_buffer.clear();
+
+    connect(m_process, &QProcess::started, this, [this]() {
+        setActive(true);
+    });
+
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &ContainerEventWatcher::readEvents);
+
+    connect(m_process, &QProcess::finished, this, [this](int exitCode, QProcess::ExitStatus exitStatus) {
+        QProcess *process = m_process;
+        m_process = nullptr;
+        setActive(false);
+
+        const QByteArray errorOutput = process->readAllStandardError().trimmed();
+        process->deleteLater();
+
+        if (exitStatus == QProcess::NormalExit && exitCode == EngineNotFound) {
+            qWarning() << "No container engine found, not watching container events";
+            return;
+        }
+
+        qWarning() << "Container event stream ended with exit code" << exitCode << errorOutput << "- restarting in" << m_restartDelay << "ms";
+        if (m_wanted) {
+            m_restartTimer->start(m_restartDelay);
+            m_restartDelay = qMin(m_restartDelay * 2, MaximumRestartDelay);
+        }
+    });
+
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // Every other error is followed by finished()
+        if (error != QProcess::FailedToStart || !m_process) {
+            return;
+        }
+
+        qWarning() << "Failed to start the container event stream:" << m_process->errorString();
+        m_process->deleteLater();
+        m_process = nullptr;
+        setActive(false);
+    });
+
+    m_process->start(u"sh"_s, DistroboxCli::hostShellArguments(DistroboxCli::eventsCommand()));
+}
+
+void ContainerEventWatcher::readEvents()
+{
+    if (!m_process) {
+        return;
+    }
+
+    m_buffer += m_process->readAllStandardOutput();
+
+    qsizetype newline;
+    while ((newline = m_buffer.indexOf('\n')) >= 0) {
+        const QByteArray line = m_buffer.left(newline).trimmed();
+        m_buffer.remove(0, newline + 1);
+
+        if (!line.isEmpty()) {
+            handleEvent(line);
+        }
+    }
+
+    // The stream works, so the next failure starts over with a short delay
+    m_restartDelay = InitialRestartDelay;
+}
+
+void ContainerEventWatcher::handleEvent(const QByteArray &line)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(line, &error);
+    if (error.error != QJsonParseError::NoError || !document.isObject()) {
+        qWarning() << "Ignoring malformed container event:" << line;
+        return;
+    }
+
+    const ContainerEvent event = parseEvent(document.object());
+    if (event.id.isEmpty()) {
+        return;
+    }
+
+    qDebug() << "Container event" << event.action << event.name;
+
+    if (event.action == QLatin1String("create")) {
+        Q_EMIT containerCreated(event.id, event.name, event.image, event.attributes);
+    } else if (event.action == QLatin1String("start") || event.action == QLatin1String("restart") || event.action == QLatin1String("unpause")) {
+        Q_EMIT containerStarted(event.id, event.name);
+    } else if (event.action == QLatin1String("died") || event.action == QLatin1String("die") || event.action == QLatin1String("stop")) {
+        Q_EMIT containerStopped(event.id, event.name);
+    } else if (event.action == QLatin1String("remove") || event.action == QLatin1String("destroy")) {
+        Q_EMIT containerRemoved(event.id, event.name);
+    } else if (event.action == QLatin1String("rename")) {
+        Q_EMIT containerRenamed(event.id, event.name);
+    }
+}
+
+void ContainerEventWatcher::setActive(bool active)
+{
+    if (m_active == active) {
+        return;
+    }
+
+    m_active = active;
+    Q_EMIT activeChanged(active);
+}
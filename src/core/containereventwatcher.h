@@ -0,0 +1,80 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QString>
+
+class QProcess;
+class QTimer;
+
+/**
+ * @class ContainerEventWatcher
+ * @brief Follows the container engine's event stream and reports container state changes
+ *
+ * Runs "podman events" (or "docker events") for the whole lifetime of the watcher,
+ * parsing one JSON event per line. Both the Podman and the Docker event layouts are
+ * understood. If the event process exits it is restarted with an increasing delay.
+ */
+class ContainerEventWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ContainerEventWatcher(QObject *parent = nullptr);
+    ~ContainerEventWatcher() override;
+
+    /**
+     * @brief Starts following the event stream
+     */
+    void start();
+
+    /**
+     * @brief Stops following the event stream
+     */
+    void stop();
+
+    /**
+     * @brief Whether the event stream is currently being followed
+     */
+    bool isActive() const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted when a container was created
+     * @param attributes Labels and other attributes reported with the event
+     */
+    void containerCreated(const QString &id, const QString &name, const QString &image, const QHash<QString, QString> &attributes);
+    void containerStarted(const QString &id, const QString &name);
+    void containerStopped(const QString &id, const QString &name);
+    void containerRemoved(const QString &id, const QString &name);
+
+    /**
+     * @brief Emitted when a container was renamed
+     * @param newName Name the container has now; the old name has to be looked up by @p id
+     */
+    void containerRenamed(const QString &id, const QString &newName);
+
+    /**
+     * @brief Emitted when the event stream starts or stops being followed
+     */
+    void activeChanged(bool active);
+
+private:
+    void launch();
+    void readEvents();
+    void handleEvent(const QByteArray &line);
+    void setActive(bool active);
+
+    QProcess *m_process = nullptr;
+    QTimer *m_restartTimer;
+    QByteArray m_buffer;
+    int m_restartDelay;
+    bool m_active = false;
+    bool m_wanted = false;
+};
@@ -0,0 +1,375 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containerfilesystem.h"
+#include "distroboxcli.h"
+#include "engineprobe.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSet>
+#include <climits>
+#include <sys/stat.h>
+#include <sys/xattr.h>
+#include <unistd.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+constexpr int MaximumSymlinkDepth = 8;
+
+const QString WhiteoutPrefix = u".wh."_s;
+const QString OpaqueMarker = u".wh..wh..opq"_s;
+
+enum class LayerLookup {
+    Found, ///< The layer provides the path
+    Missing, ///< The layer doesn't know the path, lower layers may
+    Hidden, ///< The layer deleted the path or hides it from lower layers
+    Symlink, ///< A path component is a symbolic link that has to be followed
+};
+
+QHash<QString, ContainerFilesystem> &filesystems()
+{
+    static QHash<QString, ContainerFilesystem> cache;
+    return cache;
+}
+
+// Overlay marks deleted files with a 0/0 character device
+bool isWhiteoutDevice(const QString &hostPath)
+{
+    struct stat info;
+    return ::lstat(QFile::encodeName(hostPath).constData(), &info) == 0 && S_ISCHR(info.st_mode) && info.st_rdev == 0;
+}
+
+bool isOpaqueDirectory(const QString &hostPath)
+{
+    if (QFileInfo::exists(hostPath + QLatin1Char('/') + OpaqueMarker)) {
+        return true;
+    }
+
+    const QByteArray encodedPath = QFile::encodeName(hostPath);
+    for (const char *attribute : {"trusted.overlay.opaque", "user.overlay.opaque", "user.fuseoverlayfs.opaque"}) {
+        char value = 0;
+        if (::lgetxattr(encodedPath.constData(), attribute, &value, 1) == 1 && value == 'y') {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Looks the path made of @p segments up in one layer. For LayerLookup::Symlink,
+// @p linkIndex is the index of the segment that is a link.
+LayerLookup lookupInLayer(const QString &layer, const QStringList &segments, QString &hostPath, qsizetype &linkIndex)
+{
+    QString current = layer;
+    bool opaque = false;
+
+    for (qsizetype i = 0; i < segments.size(); ++i) {
+        const QString &segment = segments.at(i);
+        if (QFileInfo::exists(current + QLatin1Char('/') + WhiteoutPrefix + segment)) {
+            return LayerLookup::Hidden;
+        }
+
+        // Lower layers can't provide anything below an opaque directory
+        if (i > 0) {
+            opaque = opaque || isOpaqueDirectory(current);
+        }
+
+        const QString next = current + QLatin1Char('/') + segment;
+        const QFileInfo info(next);
+        if (info.isSymLink()) {
+            hostPath = next;
+            linkIndex = i;
+            return LayerLookup::Symlink;
+        }
+        if (!info.exists()) {
+            return opaque ? LayerLookup::Hidden : LayerLookup::Missing;
+        }
+        if (isWhiteoutDevice(next)) {
+            return LayerLookup::Hidden;
+        }
+
+        current = next;
+    }
+
+    hostPath = current;
+    return LayerLookup::Found;
+}
+
+QString readLink(const QString &hostPath)
+{
+    QByteArray target(PATH_MAX, '\0');
+    const ssize_t length = ::readlink(QFile::encodeName(hostPath).constData(), target.data(), target.size());
+    if (length <= 0) {
+        return {};
+    }
+    return QFile::decodeName(target.left(length));
+}
+
+// Whether @p relativePath or one of its parents is in @p paths
+bool isBelow(const QString &relativePath, const QSet<QString> &paths, bool includeSelf)
+{
+    if (paths.isEmpty()) {
+        return false;
+    }
+
+    QString path = relativePath;
+    if (includeSelf && paths.contains(path)) {
+        return true;
+    }
+    qsizetype slash;
+    while ((slash = path.lastIndexOf(QLatin1Char('/'))) > 0) {
+        path.truncate(slash);
+        if (paths.contains(path)) {
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+ContainerFilesystem::ContainerFilesystem(const QStringList &layers)
+    : m_layers(layers)
+{
+}
+
+ContainerFilesystem ContainerFilesystem::forContainer(const QString &container)
+{
+    auto &cache = filesystems();
+    const auto cached = cache.constFind(container);
+    if (cached != cache.constEnd()) {
+        return *cached;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    bool success = false;
+    const QString output = DistroboxCli::runCommand(
+        DistroboxCli::inspectCommand(container, uR"({"GraphDriver":{{json .GraphDriver}},"Env":{{json .Config.Env}}})"_s),
+        success);
+    const QJsonObject inspect = success ? QJsonDocument::fromJson(output.toUtf8()).object() : QJsonObject();
+
+    // Rootful storage and non-overlay drivers can't be read anyway
+    ContainerFilesystem filesystem;
+    const EngineInfo *engine = EngineProbe::instance()->capabilities().preferredEngine();
+    if (!engine || !engine->detailsProbed || (engine->rootless && engine->storageDriver == QLatin1String("overlay"))) {
+        filesystem = fromGraphDriver(inspect.value(QLatin1String("GraphDriver")).toObject());
+    }
+
+    QString dataDirs;
+    const QJsonArray environment = inspect.value(QLatin1String("Env")).toArray();
+    for (const QJsonValue &variable : environment) {
+        if (variable.toString().startsWith(QLatin1String("XDG_DATA_DIRS="))) {
+            dataDirs = variable.toString().mid(14);
+        }
+    }
+    filesystem.m_dataDirectories = dataDirs.split(QLatin1Char(':'), Qt::SkipEmptyParts);
+    if (filesystem.m_dataDirectories.isEmpty()) {
+        filesystem.m_dataDirectories = {u"/usr/local/share"_s, u"/usr/share"_s};
+    }
+
+    qDebug() << "Container filesystem of" << container << (filesystem.isValid() ? "is readable from the host" : "is not readable from the host")
+             << "- looked up in" << timer.elapsed() << "ms";
+
+    cache.insert(container, filesystem);
+    return filesystem;
+}
+
+void ContainerFilesystem::invalidate(const QString &container)
+{
+    filesystems().remove(container);
+}
+
+ContainerFilesystem ContainerFilesystem::fromGraphDriver(const QJsonObject &graphDriver)
+{
+    if (graphDriver.value(QLatin1String("Name")).toString() != QLatin1String("overlay")) {
+        return {};
+    }
+
+    const QJsonObject data = graphDriver.value(QLatin1String("Data")).toObject();
+
+    // Only visible from the host when the engine mounts it in the host's mount namespace
+    const QString mergedDir = data.value(QLatin1String("MergedDir")).toString();
+    if (!mergedDir.isEmpty() && QFileInfo(mergedDir + u"/usr"_s).isDir()) {
+        return ContainerFilesystem({mergedDir});
+    }
+
+    QStringList layers;
+    const QString upperDir = data.value(QLatin1String("UpperDir")).toString();
+    if (!upperDir.isEmpty()) {
+        layers << upperDir;
+    }
+    layers << data.value(QLatin1String("LowerDir")).toString().split(QLatin1Char(':'), Qt::SkipEmptyParts);
+
+    // Rootful storage belongs to root; a partially readable stack would give wrong answers
+    for (const QString &layer : std::as_const(layers)) {
+        const QFileInfo info(layer);
+        if (!info.isDir() || !info.isReadable() || !info.isExecutable()) {
+            return {};
+        }
+    }
+
+    return ContainerFilesystem(layers);
+}
+
+bool ContainerFilesystem::isValid() const
+{
+    return !m_layers.isEmpty();
+}
+
+QStringList ContainerFilesystem::layers() const
+{
+    return m_layers;
+}
+
+QStringList ContainerFilesystem::dataDirectories() const
+{
+    return m_dataDirectories;
+}
+
+QString ContainerFilesystem::hostPath(const QString &path) const
+{
+    QString current = QDir::cleanPath(path);
+
+    for (int depth = 0; depth <= MaximumSymlinkDepth; ++depth) {
+        const QStringList segments = current.split(QLatin1Char('/'), Qt::SkipEmptyParts);
+        bool redirected = false;
+
+        for (const QString &layer : m_layers) {
+            QString hostPath;
+            qsizetype linkIndex = -1;
+            const LayerLookup lookup = lookupInLayer(layer, segments, hostPath, linkIndex);
+
+            if (lookup == LayerLookup::Found) {
+                return hostPath;
+            }
+            if (lookup == LayerLookup::Hidden) {
+                return {};
+            }
+            if (lookup == LayerLookup::Symlink) {
+                const QString target = readLink(hostPath);
+                if (target.isEmpty()) {
+                    return {};
+                }
+
+                // Links are relative to the directory containing them, inside the container
+                const QString linkDirectory = u"/"_s + segments.mid(0, linkIndex).join(QLatin1Char('/'));
+                const QString remainder = segments.mid(linkIndex + 1).join(QLatin1Char('/'));
+                current = target.startsWith(QLatin1Char('/')) ? target : linkDirectory + QLatin1Char('/') + target;
+                if (!remainder.isEmpty()) {
+                    current += QLatin1Char('/') + remainder;
+                }
+                current = QDir::cleanPath(current);
+                redirected = true;
+                break;
+            }
+        }
+
+        if (!redirected) {
+            return {};
+        }
+    }
+
+    qWarning() << "Too many levels of symbolic links resolving" << path;
+    return {};
+}
+
+std::optional<QByteArray> ContainerFilesystem::readFile(const QString &path) const
+{
+    const QString resolved = hostPath(path);
+    if (resolved.isEmpty()) {
+        return std::nullopt;
+    }
+
+    QFile file(resolved);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+    return file.readAll();
+}
+
+QList<ContainerFilesystem::File> ContainerFilesystem::findFiles(const QString &directory, const QStringList &nameFilters) const
+{
+    QList<File> files;
+    QSet<QString> seen;
+    QSet<QString> deleted; ///< Relative paths deleted by an upper layer
+    QSet<QString> opaque; ///< Relative directories whose lower content is hidden
+
+    const QString containerDirectory = QDir::cleanPath(directory);
+
+    for (const QString &layer : m_layers) {
+        // An upper layer made the whole directory opaque
+        if (opaque.contains(QString())) {
+            break;
+        }
+
+        const QString root = layer + containerDirectory;
+        if (!QFileInfo(root).isDir()) {
+            continue;
+        }
+
+        QSet<QString> layerDeleted;
+        QSet<QString> layerOpaque;
+        if (isOpaqueDirectory(root)) {
+            layerOpaque.insert(QString());
+        }
+
+        QDirIterator it(root, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString hostFile = it.next();
+            const QFileInfo info = it.fileInfo();
+            const QString relativePath = hostFile.mid(root.size() + 1);
+
+            if (isBelow(relativePath, deleted, true) || isBelow(relativePath, opaque, false)) {
+                continue;
+            }
+
+            const QString name = info.fileName();
+            const qsizetype slash = relativePath.lastIndexOf(QLatin1Char('/'));
+            const QString parent = slash > 0 ? relativePath.left(slash) : QString();
+
+            if (name == OpaqueMarker) {
+                layerOpaque.insert(parent);
+                continue;
+            }
+            if (name.startsWith(WhiteoutPrefix)) {
+                const QString target = name.mid(WhiteoutPrefix.size());
+                layerDeleted.insert(parent.isEmpty() ? target : parent + QLatin1Char('/') + target);
+                continue;
+            }
+            if (!info.isSymLink() && info.isDir()) {
+                if (isOpaqueDirectory(hostFile)) {
+                    layerOpaque.insert(relativePath);
+                }
+                continue;
+            }
+            if (isWhiteoutDevice(hostFile)) {
+                layerDeleted.insert(relativePath);
+                continue;
+            }
+
+            if (seen.contains(relativePath) || !QDir::match(nameFilters, name)) {
+                continue;
+            }
+
+            seen.insert(relativePath);
+            files.append(File{containerDirectory + QLatin1Char('/') + relativePath, hostFile});
+        }
+
+        deleted.unite(layerDeleted);
+        opaque.unite(layerOpaque);
+    }
+
+    return files;
+}
@@ -0,0 +1,96 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+/**
+ * @class ContainerFilesystem
+ * @brief Read-only view of a container's root filesystem from the host
+ *
+ * Reads files straight out of the overlay layers the engine stores the container in,
+ * so plain file reads neither need nor start the container. Layers are searched from
+ * the top-most (the container's own writable layer) down, honouring overlay whiteouts
+ * and opaque directories, and symbolic links are resolved inside the container.
+ *
+ * This only works when the storage is readable by the user, which is the case for
+ * rootless Podman. For anything else the view is invalid and callers have to fall
+ * back to running a command inside the container.
+ */
+class ContainerFilesystem
+{
+public:
+    /**
+     * @struct File
+     * @brief File found by findFiles()
+     */
+    struct File {
+        QString path; ///< Path inside the container
+        QString hostPath; ///< Path of the file in the layer that provides it
+    };
+
+    ContainerFilesystem() = default;
+
+    /**
+     * @brief Creates a view over @p layers, top-most first
+     */
+    explicit ContainerFilesystem(const QStringList &layers);
+
+    /**
+     * @brief Returns the view of @p container, looking up its layers on first use
+     */
+    static ContainerFilesystem forContainer(const QString &container);
+
+    /**
+     * @brief Forgets the layers of @p container, e.g. after it was removed or renamed
+     */
+    static void invalidate(const QString &container);
+
+    /**
+     * @brief Creates a view from the GraphDriver object of "podman inspect"
+     */
+    static ContainerFilesystem fromGraphDriver(const QJsonObject &graphDriver);
+
+    bool isValid() const;
+    QStringList layers() const;
+
+    /**
+     * @brief XDG data directories of the container, in precedence order
+     *
+     * Taken from XDG_DATA_DIRS in the container's configured environment, or the XDG
+     * defaults if it isn't set. Known even when the layers can't be read.
+     */
+    QStringList dataDirectories() const;
+
+    /**
+     * @brief Resolves @p path inside the container to the host file providing it
+     * @return Host path, or an empty string if the file doesn't exist or can't be resolved
+     */
+    QString hostPath(const QString &path) const;
+
+    /**
+     * @brief Reads a file of the container
+     * @return File contents, or std::nullopt if it doesn't exist or can't be read
+     */
+    std::optional<QByteArray> readFile(const QString &path) const;
+
+    /**
+     * @brief Lists the files below @p directory whose names match @p nameFilters, recursively
+     *
+     * Files are listed in the order of the directory walk, each path at most once.
+     * Symbolic links are listed as well and resolved by readFile().
+     */
+    QList<File> findFiles(const QString &directory, const QStringList &nameFilters) const;
+
+private:
+    QStringList m_layers;
+    QStringList m_dataDirectories;
+};
@@ -0,0 +1,313 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containericons.h"
+#include "containerfilesystem.h"
+#include "iconcache.h"
+#include "shellsession.h"
+
+#include <KShell>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QPointer>
+#include <QRegularExpression>
+#include <QSet>
+#include <QThreadPool>
+#include <QUrl>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+const QStringList IconExtensions = {u"png"_s, u"svg"_s, u"xpm"_s, u"jpg"_s, u"jpeg"_s, u"ico"_s};
+
+// Picks the best file per requested name: scalable first, then the size closest to 256px.
+// Prints "<icon>\t<path>" lines.
+const char ResolveAwkProgram[] = R"AWK(
+BEGIN {
+    n = split(ENVIRON["KONTAINER_ICONS"], list, "\n")
+    for (i = 1; i <= n; i++) if (list[i] != "" && list[i] !~ /^\//) want[list[i]] = 1
+}
+{
+    file = $0; sub(/.*\//, "", file)
+    stem = file; sub(/\.[^.]*$/, "", stem)
+    if (file in want) name = file
+    else if (stem in want) name = stem
+    else next
+
+    score = 16
+    if ($0 ~ /\/scalable\//) score = 1000
+    else if (match($0, /\/[0-9]+x[0-9]+(@[0-9]+x?)?\//)) {
+        size = substr($0, RSTART + 1, RLENGTH - 2); sub(/x.*/, "", size); size += 0
+        score = size <= 256 ? size : 256 - size / 1000
+    }
+    if ($0 ~ /\/hicolor\//) score += 0.5
+    if (!(name in best) || score > best[name]) { best[name] = score; found[name] = $0 }
+}
+END { for (name in found) printf "%s\t%s\n", name, found[name] }
+)AWK";
+
+const QStringList IconDirectories = {u"/usr/share/icons"_s, u"/usr/local/share/icons"_s, u"/usr/share/pixmaps"_s};
+
+// Same preference as the awk program: scalable first, then the size closest to 256px, hicolor wins ties
+double iconScore(const QString &path)
+{
+    static const QRegularExpression sizeDirectory(u"/(\\d+)x\\d+(?:@\\d+x?)?/"_s);
+
+    double score = 16;
+    if (path.contains(u"/scalable/"_s)) {
+        score = 1000;
+    } else if (const QRegularExpressionMatch match = sizeDirectory.match(path); match.hasMatch()) {
+        const double size = match.captured(1).toDouble();
+        score = size <= 256 ? size : 256 - size / 1000;
+    }
+    if (path.contains(u"/hicolor/"_s)) {
+        score += 0.5;
+    }
+    return score;
+}
+
+// Reads @p icons straight from the container's layers. Icons whose file exists but
+// can't be read this way are added to @p unresolved.
+QList<ContainerIcons::IconFile> readIcons(const ContainerFilesystem &filesystem, const QStringList &icons, QStringList &unresolved)
+{
+    QSet<QString> themeIcons;
+    for (const QString &icon : icons) {
+        if (!icon.startsWith(QLatin1Char('/'))) {
+            themeIcons.insert(icon);
+        }
+    }
+
+    QStringList nameFilters;
+    for (const QString &extension : IconExtensions) {
+        nameFilters << u"*."_s + extension;
+    }
+
+    // Best candidate per theme icon name, like the find/awk pipeline of fetchScript()
+    QHash<QString, QPair<double, QString>> candidates;
+    if (!themeIcons.isEmpty()) {
+        for (const QString &directory : IconDirectories) {
+            for (const ContainerFilesystem::File &file : filesystem.findFiles(directory, nameFilters)) {
+                const QString fileName = file.path.section(QLatin1Char('/'), -1);
+                const QString stem = fileName.section(QLatin1Char('.'), 0, -2);
+
+                QString name;
+                if (themeIcons.contains(fileName)) {
+                    name = fileName;
+                } else if (themeIcons.contains(stem)) {
+                    name = stem;
+                } else {
+                    continue;
+                }
+
+                const double score = iconScore(file.path);
+                const auto existing = candidates.constFind(name);
+                if (existing == candidates.constEnd() || score > existing->first) {
+                    candidates.insert(name, {score, file.path});
+                }
+            }
+        }
+    }
+
+    QList<ContainerIcons::IconFile> files;
+    for (const QString &icon : icons) {
+        const QString path = icon.startsWith(QLatin1Char('/')) ? icon : candidates.value(icon).second;
+        if (path.isEmpty()) {
+            continue;
+        }
+
+        const std::optional<QByteArray> data = filesystem.readFile(path);
+        if (!data) {
+            unresolved << icon;
+            continue;
+        }
+        files.append({icon, path, *data});
+    }
+
+    return files;
+}
+
+// Puts fetched @p files into the IconCache and hands their URLs to @p handler. Icons of
+// @p requested without a file are remembered as missing, but only if the transfer worked.
+void storeIcons(const QString &container,
+                const QStringList &requested,
+                const QList<ContainerIcons::IconFile> &files,
+                bool transferSucceeded,
+                const QElapsedTimer &timer,
+                const std::function<void(const QHash<QString, QString> &)> &handler,
+                qsizetype transferred = 0)
+{
+    IconCache *cache = IconCache::instance();
+
+    QHash<QString, QString> result;
+    for (const ContainerIcons::IconFile &file : files) {
+        const QString localPath = cache->store(container, file.icon, file.data, QFileInfo(file.path).suffix().toLower());
+        if (!localPath.isEmpty()) {
+            result.insert(file.icon, QUrl::fromLocalFile(localPath).toString());
+        }
+    }
+
+    if (transferSucceeded) {
+        for (const QString &icon : requested) {
+            if (!result.contains(icon)) {
+                cache->storeMissing(container, icon);
+            }
+        }
+    }
+    cache->sync();
+
+    const IconCache::Statistics statistics = cache->statistics();
+    qDebug() << "Cached" << files.size() << "of" << requested.size() << "icons from" << container << "(" << transferred << "through the container) in"
+             << timer.elapsed() << "ms; icon cache:" << statistics.hits << "hits," << statistics.misses << "misses," << statistics.bytes << "bytes";
+
+    if (handler) {
+        handler(result);
+    }
+}
+}
+
+namespace ContainerIcons
+{
+QString fetchScript(const QStringList &icons)
+{
+    QStringList extensionTests;
+    for (const QString &extension : IconExtensions) {
+        extensionTests << u"-name '*.%1'"_s.arg(extension);
+    }
+
+    const QString script = uR"SH(
+KONTAINER_ICONS=%1
+export KONTAINER_ICONS
+tab=$(printf '\t')
+{
+    printf '%s\n' "$KONTAINER_ICONS" | while IFS= read -r icon; do
+        case "$icon" in
+            /*) [ -f "$icon" ] && printf '%s\t%s\n' "$icon" "$icon" ;;
+        esac
+    done
+    find /usr/share/icons /usr/local/share/icons /usr/share/pixmaps -type f \( %2 \) 2>/dev/null | awk %3
+} | while IFS="$tab" read -r icon path; do
+    size=$(wc -c < "$path") || continue
+    printf '%s\n%s\n%s\n' "$icon" "$path" "$size"
+    cat "$path"
+done
+)SH"_s;
+
+    return script.arg(KShell::quoteArg(icons.join(QLatin1Char('\n'))),
+                      extensionTests.join(u" -o "_s),
+                      KShell::quoteArg(QString::fromLatin1(ResolveAwkProgram)));
+}
+
+QList<IconFile> parseFrames(const QByteArray &output)
+{
+    QList<IconFile> files;
+    qsizetype position = 0;
+
+    while (position < output.size()) {
+        QByteArray header[3];
+        for (QByteArray &line : header) {
+            const qsizetype newline = output.indexOf('\n', position);
+            if (newline < 0) {
+                return files;
+            }
+            line = output.mid(position, newline - position);
+            position = newline + 1;
+        }
+
+        bool ok = false;
+        const qsizetype size = header[2].trimmed().toLongLong(&ok);
+        if (!ok || size < 0 || position + size > output.size()) {
+            qWarning() << "Truncated icon stream after" << files.size() << "icons";
+            return files;
+        }
+
+        IconFile file;
+        file.icon = QString::fromUtf8(header[0]);
+        file.path = QString::fromUtf8(header[1]);
+        file.data = output.mid(position, size);
+        files.append(file);
+        position += size;
+    }
+
+    return files;
+}
+
+QHash<QString, QString> cachedIcons(const QString &container, const QStringList &icons, QStringList *missing)
+{
+    QHash<QString, QString> result;
+    IconCache *cache = IconCache::instance();
+
+    for (const QString &icon : icons) {
+        if (icon.trimmed().isEmpty() || result.contains(icon) || missing->contains(icon)) {
+            continue;
+        }
+
+        QString localPath;
+        switch (cache->lookup(container, icon, &localPath)) {
+        case IconCache::Lookup::Hit:
+            result.insert(icon, QUrl::fromLocalFile(localPath).toString());
+            break;
+        case IconCache::Lookup::Missing:
+            break;
+        case IconCache::Lookup::Miss:
+            missing->append(icon);
+            break;
+        }
+    }
+
+    return result;
+}
+
+void fetchIcons(const QString &container,
+                const QStringList &icons,
+                QObject *context,
+                const std::function<void(const QHash<QString, QString> &sources)> &handler)
+{
+    if (icons.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const QPointer<QObject> guard(context);
+
+    // Runs on the GUI thread once the host reads are done, whatever is left comes out of the container in one transfer
+    auto transfer = [container, icons, guard, handler, timer](const QList<IconFile> &read, const QStringList &transferred) {
+        if (!guard) {
+            return;
+        }
+        if (transferred.isEmpty()) {
+            storeIcons(container, icons, read, true, timer, handler);
+            return;
+        }
+
+        const QFuture<CommandResult> future = ShellSession::forContainer(container)->run(fetchScript(transferred));
+        CommandExecutor::onFinished(future, guard, [container, icons, read, transferred, timer, handler](const CommandResult &result) {
+            storeIcons(container, icons, read + parseFrames(result.output), result.success(), timer, handler, transferred.size());
+        });
+    };
+
+    const ContainerFilesystem filesystem = ContainerFilesystem::forContainer(container);
+    if (!filesystem.isValid()) {
+        transfer({}, icons);
+        return;
+    }
+
+    // Walking the icon themes touches thousands of files, so it happens off the GUI thread
+    QThreadPool::globalInstance()->start([filesystem, icons, transfer]() {
+        QStringList unresolved;
+        const QList<IconFile> files = readIcons(filesystem, icons, unresolved);
+        QMetaObject::invokeMethod(
+            QCoreApplication::instance(),
+            [transfer, files, unresolved]() {
+                transfer(files, unresolved);
+            },
+            Qt::QueuedConnection);
+    });
+}
+}
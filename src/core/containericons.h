@@ -0,0 +1,72 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <functional>
+
+class QObject;
+
+/**
+ * @brief Copies application icons out of a container into the IconCache
+ *
+ * All icons of a container are resolved and transferred by one script: it looks the
+ * requested names up in the container's icon directories and writes every file found
+ * to its standard output as a length-prefixed frame.
+ */
+namespace ContainerIcons
+{
+/**
+ * @struct IconFile
+ * @brief Icon file transferred from a container
+ */
+struct IconFile {
+    QString icon; ///< Icon value as requested (theme name or absolute path)
+    QString path; ///< Path of the resolved file inside the container
+    QByteArray data; ///< File contents
+};
+
+/**
+ * @brief Returns the script resolving and printing the given icons
+ *
+ * Each icon that could be resolved is printed as three header lines (requested icon,
+ * resolved path, size in bytes) followed by the raw file contents.
+ */
+QString fetchScript(const QStringList &icons);
+
+/**
+ * @brief Splits the output of fetchScript() into its files
+ */
+QList<IconFile> parseFrames(const QByteArray &output);
+
+/**
+ * @brief Looks the icons up in the local cache without transferring anything
+ * @param container Container the icons come from
+ * @param icons Icon values from the container's desktop files
+ * @param missing Receives the icons that have to be fetched with fetchIcons()
+ * @return file:// URL per cached icon value
+ *
+ * Icons recently found missing in the container are neither returned nor listed in @p missing.
+ */
+QHash<QString, QString> cachedIcons(const QString &container, const QStringList &icons, QStringList *missing);
+
+/**
+ * @brief Copies @p icons out of the container into the local cache in the background
+ * @param handler Invoked on the thread of @p context with a file:// URL per icon that
+ *        could be cached; not invoked if @p context is gone by then
+ *
+ * Icons are read from the container's layers on a worker thread where possible,
+ * the rest comes out of the running container in one transfer.
+ */
+void fetchIcons(const QString &container,
+                const QStringList &icons,
+                QObject *context,
+                const std::function<void(const QHash<QString, QString> &sources)> &handler);
+}
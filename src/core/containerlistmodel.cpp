@@ -0,0 +1,98 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containerlistmodel.h"
+
+namespace
+{
+// Length of the IDs the engine CLIs print
+constexpr int ShortIdLength = 12;
+}
+
+ContainerListModel::ContainerListModel(QObject *parent)
+    : KeyedListModel(parent)
+{
+    connect(this, &QAbstractItemModel::rowsInserted, this, &ContainerListModel::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &ContainerListModel::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &ContainerListModel::countChanged);
+}
+
+QVariant ContainerListModel::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+        return {};
+    }
+
+    const DistroboxCli::ContainerInfo &container = rows().at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case NameRole:
+        return container.name;
+    case IdRole:
+        return container.id;
+    case ImageRole:
+        return container.image;
+    case StatusRole:
+        return container.status;
+    case CreatedRole:
+        return container.created;
+    case SizeRole:
+        return container.size;
+    case ImageShareRole:
+        return container.imageShare;
+    case TotalSizeRole:
+        return container.size < 0 ? qint64(-1) : container.size + qMax<qint64>(0, container.imageShare);
+    }
+    return {};
+}
+
+QHash<int, QByteArray> ContainerListModel::roleNames() const
+{
+    return {
+        {IdRole, "id"},
+        {NameRole, "name"},
+        {ImageRole, "image"},
+        {StatusRole, "status"},
+        {CreatedRole, "created"},
+        {SizeRole, "size"},
+        {ImageShareRole, "imageShare"},
+        {TotalSizeRole, "totalSize"},
+    };
+}
+
+void ContainerListModel::setContainers(const QList<DistroboxCli::ContainerInfo> &containers)
+{
+    setRows(containers);
+}
+
+void ContainerListModel::insertOrUpdate(const DistroboxCli::ContainerInfo &container)
+{
+    insertOrUpdateRow(container);
+}
+
+void ContainerListModel::remove(const QString &id)
+{
+    removeKey(id.left(ShortIdLength));
+}
+
+QString ContainerListModel::nameAt(int row) const
+{
+    return row >= 0 && row < count() ? rows().at(row).name : QString();
+}
+
+int ContainerListModel::rowOfName(const QString &name) const
+{
+    for (int row = 0; row < count(); ++row) {
+        if (rows().at(row).name == name) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+QString ContainerListModel::keyOf(const DistroboxCli::ContainerInfo &container) const
+{
+    return container.id.isEmpty() ? container.name : container.id.left(ShortIdLength);
+}
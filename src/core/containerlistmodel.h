@@ -0,0 +1,70 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "distroboxcli.h"
+#include "keyedlistmodel.h"
+
+/**
+ * @class ContainerListModel
+ * @brief The distrobox containers, one row per container
+ *
+ * Rows are keyed by container ID, so a refresh that only changed a status or a name
+ * updates that one row, and the card showing it stays in place. IDs are compared by
+ * their short form, since the engine CLI and the engine API report them at different
+ * lengths.
+ */
+class ContainerListModel : public KeyedListModel<DistroboxCli::ContainerInfo>
+{
+    Q_OBJECT
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+
+public:
+    enum Roles {
+        IdRole = Qt::UserRole + 1,
+        NameRole,
+        ImageRole,
+        StatusRole,
+        CreatedRole,
+        SizeRole, ///< Writable layer size in bytes, -1 if not known
+        ImageShareRole, ///< Bytes of the image attributed to the container, -1 if not known
+        TotalSizeRole, ///< Writable layer and image share, -1 while the writable layer isn't known
+    };
+    Q_ENUM(Roles)
+
+    explicit ContainerListModel(QObject *parent = nullptr);
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Brings the rows in line with a new listing, emitting only what changed
+     */
+    void setContainers(const QList<DistroboxCli::ContainerInfo> &containers);
+
+    /**
+     * @brief Updates the row of @p container, or appends one if there is none
+     */
+    void insertOrUpdate(const DistroboxCli::ContainerInfo &container);
+
+    void remove(const QString &id);
+
+    /**
+     * @brief Name of the container in @p row, empty if there is no such row
+     */
+    Q_INVOKABLE QString nameAt(int row) const;
+
+    /**
+     * @brief Row of the container named @p name, -1 if there is none
+     */
+    Q_INVOKABLE int rowOfName(const QString &name) const;
+
+Q_SIGNALS:
+    void countChanged();
+
+protected:
+    QString keyOf(const DistroboxCli::ContainerInfo &container) const override;
+};
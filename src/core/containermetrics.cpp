@@ -0,0 +1,483 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containermetrics.h"
+#include "commandexecutor.h"
+#include "containerlistmodel.h"
+#include "distroboxcli.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTimer>
+#include <initializer_list>
+#include <unistd.h>
+#include <utility>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+const QString CgroupRoot = u"/sys/fs/cgroup"_s;
+
+// inspect answers quickly, unless the engine is busy
+constexpr int ResolveTimeout = 15000;
+
+// stats --no-stream measures for a moment before it answers
+constexpr int StatsTimeout = 30000;
+
+// sysfs and procfs files are small and generated on read, no buffering needed
+QByteArray readSystemFile(const QString &path, bool *ok = nullptr)
+{
+    QFile file(path);
+    const bool opened = file.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    if (ok) {
+        *ok = opened;
+    }
+    return opened ? file.readAll() : QByteArray();
+}
+
+// Value of @p key in a "key value" file such as cpu.stat or memory.stat
+qint64 keyedValue(const QByteArray &contents, const QByteArray &key, bool *ok = nullptr)
+{
+    for (const QByteArray &line : contents.split('\n')) {
+        if (line.startsWith(key) && line.size() > key.size() && line.at(key.size()) == ' ') {
+            return line.mid(key.size() + 1).trimmed().toLongLong(ok);
+        }
+    }
+    if (ok) {
+        *ok = false;
+    }
+    return 0;
+}
+
+// cgroup v2 directory of @p pid, empty if it isn't in a v2 hierarchy we can read
+QString cgroupOf(int pid)
+{
+    const QByteArray contents = readSystemFile(u"/proc/%1/cgroup"_s.arg(pid));
+    for (const QByteArray &line : contents.split('\n')) {
+        if (line.startsWith("0::")) {
+            const QString directory = CgroupRoot + QString::fromUtf8(line.mid(3).trimmed());
+            return QFile::exists(directory + u"/cpu.stat"_s) ? directory : QString();
+        }
+    }
+    return {};
+}
+
+QString namespaceOf(const QString &pid, const char *type)
+{
+    QByteArray target(256, '\0');
+    const QByteArray link = u"/proc/%1/ns/%2"_s.arg(pid, QLatin1String(type)).toLocal8Bit();
+    const ssize_t length = ::readlink(link.constData(), target.data(), target.size());
+    return length > 0 ? QString::fromLatin1(target.constData(), length) : QString();
+}
+
+// Splits "in / out" pairs such as "12MB / 3.4GB"
+std::pair<qint64, qint64> parseSizePair(const QString &text)
+{
+    const QStringList parts = text.split(QLatin1Char('/'));
+    if (parts.size() != 2) {
+        return {-1, -1};
+    }
+    return {DistroboxCli::parseHumanSize(parts.at(0)), DistroboxCli::parseHumanSize(parts.at(1))};
+}
+
+// podman and docker name the stats fields differently
+QString field(const QJsonObject &object, std::initializer_list<QLatin1String> keys)
+{
+    for (const QLatin1String &key : keys) {
+        const QJsonValue value = object.value(key);
+        if (value.isString()) {
+            return value.toString();
+        }
+        if (value.isDouble()) {
+            return QString::number(value.toDouble());
+        }
+    }
+    return {};
+}
+
+double rate(const MetricsSample &previous, const MetricsSample &current, qint64 MetricsSample::*first, qint64 MetricsSample::*second)
+{
+    const qint64 elapsed = current.time - previous.time;
+    if (elapsed <= 0 || current.*first < 0 || previous.*first < 0) {
+        return -1;
+    }
+    const qint64 bytes = (current.*first - previous.*first) + (current.*second - previous.*second);
+    return qMax<qint64>(0, bytes) * 1000.0 / elapsed;
+}
+}
+
+ContainerMetrics::ContainerMetrics(ContainerListModel *containers, QObject *parent)
+    : QObject(parent)
+    , m_containers(containers)
+    , m_timer(new QTimer(this))
+    , m_cgroupsUsable(!DistroboxCli::isFlatpak() && QFile::exists(CgroupRoot + u"/cgroup.controllers"_s))
+{
+    if (!m_cgroupsUsable) {
+        qDebug() << "No cgroup v2 hierarchy of the host in reach, container metrics come from the engine";
+    }
+
+    connect(m_timer, &QTimer::timeout, this, &ContainerMetrics::sample);
+
+    // Starting or stopping a container changes its status row
+    connect(m_containers, &QAbstractItemModel::rowsInserted, this, &ContainerMetrics::updateSchedule);
+    connect(m_containers, &QAbstractItemModel::rowsRemoved, this, &ContainerMetrics::updateSchedule);
+    connect(m_containers, &QAbstractItemModel::modelReset, this, &ContainerMetrics::updateSchedule);
+    connect(m_containers, &QAbstractItemModel::dataChanged, this, &ContainerMetrics::updateSchedule);
+}
+
+bool ContainerMetrics::isWindowVisible() const
+{
+    return m_windowVisible;
+}
+
+void ContainerMetrics::setWindowVisible(bool visible)
+{
+    if (m_windowVisible == visible) {
+        return;
+    }
+    m_windowVisible = visible;
+    Q_EMIT windowVisibleChanged();
+
+    // Samples may be up to HiddenInterval old by now
+    if (visible && m_timer->isActive()) {
+        sample();
+    }
+    updateSchedule();
+}
+
+int ContainerMetrics::interval() const
+{
+    return m_timer->isActive() ? m_timer->interval() : 0;
+}
+
+QVariantMap ContainerMetrics::latest(const QString &container) const
+{
+    const auto it = m_series.constFind(container);
+    if (it == m_series.cend() || it->samples.isEmpty()) {
+        return {};
+    }
+
+    const RingBuffer<MetricsSample> &samples = it->samples;
+    const MetricsSample &last = samples.last();
+    const MetricsSample &previous = samples.size() > 1 ? samples.at(samples.size() - 2) : last;
+    return {
+        {u"cpu"_s, last.cpuPercent},
+        {u"memory"_s, last.memoryBytes},
+        {u"memoryLimit"_s, last.memoryLimit},
+        {u"pids"_s, last.pids},
+        {u"blockRate"_s, qMax(0.0, rate(previous, last, &MetricsSample::blockRead, &MetricsSample::blockWrite))},
+        {u"networkRate"_s, rate(previous, last, &MetricsSample::networkReceived, &MetricsSample::networkSent)},
+    };
+}
+
+QVariantList ContainerMetrics::history(const QString &container, const QString &metric) const
+{
+    const auto it = m_series.constFind(container);
+    if (it == m_series.cend()) {
+        return {};
+    }
+
+    const RingBuffer<MetricsSample> &samples = it->samples;
+    QVariantList values;
+    values.reserve(samples.size());
+    for (qsizetype i = 0; i < samples.size(); ++i) {
+        const MetricsSample &current = samples.at(i);
+        if (metric == QLatin1String("cpu")) {
+            values.append(current.cpuPercent);
+        } else if (metric == QLatin1String("memory")) {
+            values.append(current.memoryBytes);
+        } else if (metric == QLatin1String("pids")) {
+            values.append(current.pids);
+        } else if (i > 0) {
+            // Rates need the sample before, so they have one value less
+            const double value = metric == QLatin1String("blockRate")
+                ? rate(samples.at(i - 1), current, &MetricsSample::blockRead, &MetricsSample::blockWrite)
+                : metric == QLatin1String("networkRate") ? rate(samples.at(i - 1), current, &MetricsSample::networkReceived, &MetricsSample::networkSent)
+                                                         : -1;
+            if (value >= 0) {
+                values.append(value);
+            }
+        }
+    }
+    return values;
+}
+
+QHash<QString, MetricsSample> ContainerMetrics::parseStats(const QByteArray &output)
+{
+    QList<QJsonObject> objects;
+    const QJsonDocument document = QJsonDocument::fromJson(output);
+    if (document.isArray()) {
+        const QJsonArray array = document.array();
+        for (const QJsonValue &value : array) {
+            objects.append(value.toObject());
+        }
+    } else {
+        for (const QByteArray &line : output.split('\n')) {
+            const QJsonDocument lineDocument = QJsonDocument::fromJson(line);
+            if (lineDocument.isObject()) {
+                objects.append(lineDocument.object());
+            }
+        }
+    }
+
+    QHash<QString, MetricsSample> samples;
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const QJsonObject &object : std::as_const(objects)) {
+        QString name = field(object, {QLatin1String("name"), QLatin1String("Name")});
+        if (name.startsWith(QLatin1Char('/'))) {
+            name.remove(0, 1);
+        }
+        if (name.isEmpty()) {
+            continue;
+        }
+
+        MetricsSample sample;
+        sample.time = now;
+
+        QString cpu = field(object, {QLatin1String("cpu_percent"), QLatin1String("CPUPerc"), QLatin1String("CPU")});
+        cpu.remove(QLatin1Char('%'));
+        sample.cpuPercent = qMax(0.0, cpu.toDouble());
+
+        const auto [memory, memoryLimit] = parseSizePair(field(object, {QLatin1String("mem_usage"), QLatin1String("MemUsage")}));
+        sample.memoryBytes = qMax<qint64>(0, memory);
+        sample.memoryLimit = qMax<qint64>(0, memoryLimit);
+
+        sample.pids = field(object, {QLatin1String("pids"), QLatin1String("PIDs")}).toInt();
+
+        const auto [blockRead, blockWrite] = parseSizePair(field(object, {QLatin1String("block_io"), QLatin1String("BlockIO")}));
+        sample.blockRead = qMax<qint64>(0, blockRead);
+        sample.blockWrite = qMax<qint64>(0, blockWrite);
+
+        // Host network containers report "-- / --" or nothing at all
+        const auto [received, sent] = parseSizePair(field(object, {QLatin1String("net_io"), QLatin1String("NetIO")}));
+        if (received >= 0 && sent >= 0) {
+            sample.networkReceived = received;
+            sample.networkSent = sent;
+        }
+
+        samples.insert(name, sample);
+    }
+    return samples;
+}
+
+QStringList ContainerMetrics::runningContainers() const
+{
+    QStringList names;
+    for (const DistroboxCli::ContainerInfo &container : m_containers->rows()) {
+        if (container.status.startsWith(u"Up"_s, Qt::CaseInsensitive)) {
+            names.append(container.name);
+        }
+    }
+    return names;
+}
+
+void ContainerMetrics::updateSchedule()
+{
+    const int previousInterval = interval();
+
+    int newInterval = 0;
+    if (!runningContainers().isEmpty()) {
+        newInterval = m_windowVisible ? VisibleInterval : HiddenInterval;
+        if (m_usingStats) {
+            newInterval = qMax(newInterval, StatsInterval);
+        }
+    }
+
+    if (newInterval == 0) {
+        m_timer->stop();
+        m_series.clear();
+        m_sources.clear();
+    } else if (newInterval != previousInterval) {
+        // Take the first sample right away, it is the baseline of the CPU usage
+        if (previousInterval == 0) {
+            QTimer::singleShot(0, this, &ContainerMetrics::sample);
+        }
+        m_timer->start(newInterval);
+    }
+
+    if (interval() != previousInterval) {
+        qDebug() << "Sampling container metrics every" << interval() << "ms";
+        Q_EMIT intervalChanged();
+    }
+}
+
+void ContainerMetrics::sample()
+{
+    const QStringList running = runningContainers();
+
+    // Stopped containers cost nothing; a restart brings a new main process and cgroup
+    for (auto it = m_series.begin(); it != m_series.end();) {
+        it = running.contains(it.key()) ? std::next(it) : m_series.erase(it);
+    }
+    for (auto it = m_sources.begin(); it != m_sources.end();) {
+        it = running.contains(it.key()) ? std::next(it) : m_sources.erase(it);
+    }
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QStringList viaStats;
+    for (const QString &container : running) {
+        const auto it = m_sources.constFind(container);
+        if (it == m_sources.cend()) {
+            if (m_cgroupsUsable) {
+                resolveSource(container);
+            } else {
+                viaStats.append(container);
+            }
+        } else if (it->cgroup.isEmpty()) {
+            viaStats.append(container);
+        } else if (!readCgroup(container, *it, now)) {
+            // The container was restarted since its cgroup was looked up
+            m_sources.remove(container);
+            m_series[container].cpuUsage = -1;
+            resolveSource(container);
+        }
+    }
+
+    m_usingStats = !viaStats.isEmpty();
+    if (m_usingStats && !m_statsRunning) {
+        runStats(viaStats);
+    }
+
+    updateSchedule();
+    Q_EMIT sampled();
+}
+
+void ContainerMetrics::resolveSource(const QString &container)
+{
+    if (m_resolving.contains(container)) {
+        return;
+    }
+    m_resolving.insert(container);
+
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(DistroboxCli::inspectCommand(container, u"{{.State.Pid}}"_s), ResolveTimeout);
+    CommandExecutor::onFinished(future, this, [this, container](const CommandResult &result) {
+        m_resolving.remove(container);
+        if (!runningContainers().contains(container)) {
+            return;
+        }
+
+        Source source;
+        source.pid = result.success() ? result.text().trimmed().toInt() : 0;
+        if (source.pid > 0) {
+            source.cgroup = cgroupOf(source.pid);
+
+            // Without an answer the network can't be told apart from the host's
+            const QString containerNetwork = namespaceOf(QString::number(source.pid), "net");
+            source.sharedNetwork = containerNetwork.isEmpty() || containerNetwork == namespaceOf(u"self"_s, "net");
+        }
+
+        // The memory controller isn't always delegated to rootless containers
+        if (!source.cgroup.isEmpty() && !QFile::exists(source.cgroup + u"/memory.current"_s)) {
+            source.cgroup.clear();
+        }
+        if (source.cgroup.isEmpty()) {
+            qDebug() << "No readable cgroup for" << container << "- sampling it through the engine";
+        }
+        m_sources.insert(container, source);
+    });
+}
+
+bool ContainerMetrics::readCgroup(const QString &container, const Source &source, qint64 now)
+{
+    bool ok = false;
+    const qint64 cpuUsage = keyedValue(readSystemFile(source.cgroup + u"/cpu.stat"_s), "usage_usec", &ok);
+    if (!ok) {
+        return false;
+    }
+    const qint64 memoryCurrent = readSystemFile(source.cgroup + u"/memory.current"_s).trimmed().toLongLong(&ok);
+    if (!ok) {
+        return false;
+    }
+
+    Series &series = m_series[container];
+    const qint64 previousUsage = series.cpuUsage;
+    const qint64 previousTime = series.cpuTime;
+    series.cpuUsage = cpuUsage;
+    series.cpuTime = now;
+    if (previousUsage < 0 || now <= previousTime) {
+        // First reading, the CPU usage needs a second one
+        return true;
+    }
+
+    MetricsSample sample;
+    sample.time = now;
+    sample.cpuPercent = qMax<qint64>(0, cpuUsage - previousUsage) / ((now - previousTime) * 1000.0) * 100.0;
+
+    // Like the engines, leave out page cache the kernel can drop at any time
+    const qint64 inactiveFile = keyedValue(readSystemFile(source.cgroup + u"/memory.stat"_s), "inactive_file");
+    sample.memoryBytes = qMax<qint64>(0, memoryCurrent - inactiveFile);
+    sample.memoryLimit = readSystemFile(source.cgroup + u"/memory.max"_s).trimmed().toLongLong(); // "max" reads as 0
+    sample.pids = readSystemFile(source.cgroup + u"/pids.current"_s).trimmed().toInt();
+
+    // io.stat: "<major>:<minor> rbytes=... wbytes=... rios=... ..." per device
+    const QByteArray ioStat = readSystemFile(source.cgroup + u"/io.stat"_s);
+    for (const QByteArray &line : ioStat.split('\n')) {
+        for (const QByteArray &entry : line.split(' ')) {
+            if (entry.startsWith("rbytes=")) {
+                sample.blockRead += entry.mid(7).toLongLong();
+            } else if (entry.startsWith("wbytes=")) {
+                sample.blockWrite += entry.mid(7).toLongLong();
+            }
+        }
+    }
+
+    // Interface counters as the container's network namespace sees them, loopback excluded
+    if (!source.sharedNetwork) {
+        bool readable = false;
+        const QByteArray netDev = readSystemFile(u"/proc/%1/net/dev"_s.arg(source.pid), &readable);
+        if (readable) {
+            sample.networkReceived = 0;
+            sample.networkSent = 0;
+            const QList<QByteArray> lines = netDev.split('\n');
+            for (qsizetype i = 2; i < lines.size(); ++i) {
+                const qsizetype colon = lines.at(i).indexOf(':');
+                if (colon < 0 || lines.at(i).left(colon).trimmed() == "lo") {
+                    continue;
+                }
+                const QList<QByteArray> columns = lines.at(i).mid(colon + 1).simplified().split(' ');
+                if (columns.size() >= 9) {
+                    sample.networkReceived += columns.at(0).toLongLong();
+                    sample.networkSent += columns.at(8).toLongLong();
+                }
+            }
+        }
+    }
+
+    series.samples.append(sample);
+    return true;
+}
+
+void ContainerMetrics::runStats(const QStringList &containers)
+{
+    m_statsRunning = true;
+
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(DistroboxCli::statsCommand(containers), StatsTimeout);
+    CommandExecutor::onFinished(future, this, [this](const CommandResult &result) {
+        m_statsRunning = false;
+        if (!result.success()) {
+            qWarning() << "Cannot sample containers through the engine:" << QString::fromUtf8(result.errorOutput).trimmed();
+            return;
+        }
+
+        const QStringList running = runningContainers();
+        const QHash<QString, MetricsSample> samples = parseStats(result.output);
+        for (auto it = samples.cbegin(); it != samples.cend(); ++it) {
+            if (running.contains(it.key())) {
+                append(it.key(), it.value());
+            }
+        }
+        Q_EMIT sampled();
+    });
+}
+
+void ContainerMetrics::append(const QString &container, const MetricsSample &sample)
+{
+    m_series[container].samples.append(sample);
+}
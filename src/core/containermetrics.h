@@ -0,0 +1,140 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "ringbuffer.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
+#include <qqmlintegration.h>
+
+class ContainerListModel;
+class QTimer;
+
+/**
+ * @struct MetricsSample
+ * @brief Resource usage of a container at one point in time
+ */
+struct MetricsSample {
+    qint64 time = 0; ///< Milliseconds since the epoch
+    double cpuPercent = 0; ///< Percent of one core, so up to 100 times the number of cores
+    qint64 memoryBytes = 0; ///< Without the reclaimable page cache
+    qint64 memoryLimit = 0; ///< 0 if the container has no limit of its own
+    int pids = 0;
+    qint64 blockRead = 0; ///< Bytes read since the container started
+    qint64 blockWrite = 0; ///< Bytes written since the container started
+    qint64 networkReceived = -1; ///< Bytes since the container started, -1 if it uses the host's network
+    qint64 networkSent = -1; ///< Same as networkReceived, for sent bytes
+};
+
+/**
+ * @class ContainerMetrics
+ * @brief Samples CPU, memory, process and IO usage of the running containers
+ *
+ * Usage is read straight from the container's cgroup v2 files, found through the
+ * cgroup of its main process; that costs a few small file reads per container and
+ * sample. Where the cgroup isn't readable, e.g. inside Flatpak or on cgroup v1, the
+ * containers are sampled with "<engine> stats --no-stream" instead, at most every
+ * StatsInterval.
+ *
+ * Each container keeps its last HistoryLength samples. Stopped containers are neither
+ * sampled nor kept, and without a running container the sampler doesn't wake up at all.
+ * While the window is hidden the sampler slows down to HiddenInterval.
+ */
+class ContainerMetrics : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Use distroBoxManager.metrics")
+
+    /**
+     * @brief Whether the metrics are on screen, set by the window
+     */
+    Q_PROPERTY(bool windowVisible READ isWindowVisible WRITE setWindowVisible NOTIFY windowVisibleChanged)
+
+    /**
+     * @brief Milliseconds between samples, 0 while nothing is sampled
+     */
+    Q_PROPERTY(int interval READ interval NOTIFY intervalChanged)
+
+public:
+    static constexpr int HistoryLength = 60;
+    static constexpr int VisibleInterval = 2000; ///< Milliseconds
+    static constexpr int HiddenInterval = 30000; ///< Milliseconds
+    static constexpr int StatsInterval = 5000; ///< Shortest interval while the engine CLI is used, in milliseconds
+
+    explicit ContainerMetrics(ContainerListModel *containers, QObject *parent = nullptr);
+
+    bool isWindowVisible() const;
+    void setWindowVisible(bool visible);
+
+    int interval() const;
+
+    /**
+     * @brief Latest usage of @p container
+     * @return Map with "cpu" (percent), "memory" and "memoryLimit" (bytes), "pids",
+     *         "blockRate" and "networkRate" (bytes per second, networkRate -1 if the
+     *         container uses the host's network); empty before the first sample
+     */
+    Q_INVOKABLE QVariantMap latest(const QString &container) const;
+
+    /**
+     * @brief Values of one metric over the kept samples, oldest first
+     * @param metric "cpu", "memory", "pids", "blockRate" or "networkRate"
+     */
+    Q_INVOKABLE QVariantList history(const QString &container, const QString &metric) const;
+
+    /**
+     * @brief Parses the output of DistroboxCli::statsCommand(), keyed by container name
+     */
+    static QHash<QString, MetricsSample> parseStats(const QByteArray &output);
+
+Q_SIGNALS:
+    void windowVisibleChanged();
+    void intervalChanged();
+
+    /**
+     * @brief Emitted after each round of samples
+     */
+    void sampled();
+
+private:
+    struct Source {
+        QString cgroup; ///< cgroup v2 directory of the container, empty if unusable
+        int pid = 0; ///< Main process, for the network counters
+        bool sharedNetwork = false; ///< The container uses the host's network namespace
+    };
+
+    struct Series {
+        RingBuffer<MetricsSample> samples{HistoryLength};
+        qint64 cpuUsage = -1; ///< Last cpu.stat usage_usec, -1 before the first reading
+        qint64 cpuTime = 0; ///< When cpuUsage was read, in milliseconds since the epoch
+    };
+
+    QStringList runningContainers() const;
+    void updateSchedule();
+    void sample();
+    void resolveSource(const QString &container);
+    bool readCgroup(const QString &container, const Source &source, qint64 now);
+    void runStats(const QStringList &containers);
+    void append(const QString &container, const MetricsSample &sample);
+
+    ContainerListModel *m_containers;
+    QTimer *m_timer;
+    bool m_windowVisible = true;
+    bool m_cgroupsUsable; ///< cgroup v2 is mounted and the host's /proc is ours
+    QHash<QString, Source> m_sources; ///< By container name; an empty cgroup means "use stats"
+    QSet<QString> m_resolving; ///< Containers whose main process is being looked up
+    QHash<QString, Series> m_series; ///< By container name, running containers only
+    bool m_statsRunning = false;
+    bool m_usingStats = false; ///< The last round needed the engine CLI
+};
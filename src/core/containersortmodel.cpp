@@ -0,0 +1,59 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "containersortmodel.h"
+#include "containerlistmodel.h"
+
+ContainerSortModel::ContainerSortModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    setDynamicSortFilter(true);
+    setSortCaseSensitivity(Qt::CaseInsensitive);
+    sort(0);
+}
+
+ContainerSortModel::SortOrder ContainerSortModel::sortOrder() const
+{
+    return m_sortOrder;
+}
+
+void ContainerSortModel::setSortOrder(SortOrder order)
+{
+    if (m_sortOrder == order) {
+        return;
+    }
+    m_sortOrder = order;
+    Q_EMIT sortOrderChanged();
+    invalidate();
+}
+
+bool ContainerSortModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    switch (m_sortOrder) {
+    case Name: {
+        const int order = QString::compare(left.data(ContainerListModel::NameRole).toString(),
+                                           right.data(ContainerListModel::NameRole).toString(),
+                                           sortCaseSensitivity());
+        if (order != 0) {
+            return order < 0;
+        }
+        break;
+    }
+    case Size: {
+        // -1 for unmeasured containers puts them last
+        const qint64 leftSize = left.data(ContainerListModel::TotalSizeRole).toLongLong();
+        const qint64 rightSize = right.data(ContainerListModel::TotalSizeRole).toLongLong();
+        if (leftSize != rightSize) {
+            return leftSize > rightSize;
+        }
+        break;
+    }
+    case Default:
+        break;
+    }
+
+    // The source order among equals
+    return left.row() < right.row();
+}
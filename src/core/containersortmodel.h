@@ -0,0 +1,46 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QSortFilterProxyModel>
+#include <qqmlintegration.h>
+
+/**
+ * @class ContainerSortModel
+ * @brief Orders a ContainerListModel for the containers page
+ *
+ * The order is kept as rows change, so a container whose size was just measured
+ * moves to its place without the page re-sorting anything.
+ */
+class ContainerSortModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+    QML_ELEMENT
+
+    Q_PROPERTY(SortOrder sortOrder READ sortOrder WRITE setSortOrder NOTIFY sortOrderChanged)
+
+public:
+    enum SortOrder {
+        Default, ///< As the engine lists them
+        Name,
+        Size, ///< Largest first, containers not measured yet last
+    };
+    Q_ENUM(SortOrder)
+
+    explicit ContainerSortModel(QObject *parent = nullptr);
+
+    SortOrder sortOrder() const;
+    void setSortOrder(SortOrder order);
+
+Q_SIGNALS:
+    void sortOrderChanged();
+
+protected:
+    bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
+
+private:
+    SortOrder m_sortOrder = Default;
+};
@@ -0,0 +1,551 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "diskusage.h"
+#include "commandexecutor.h"
+#include "engineapiclient.h"
+#include "imagepuller.h"
+
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Bump when the meaning of the cached fields changes
+constexpr int CacheVersion = 1;
+
+// Walking a large writable layer takes a while, especially on a cold cache
+constexpr int MeasureTimeout = 5 * 60 * 1000;
+
+// A container may use an image pulled since the last listing; list again, but not in a loop
+constexpr int UnknownImageRetry = 60 * 1000;
+
+QString cacheFilePath()
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+    return QDir(cacheBase).filePath(u"kontainer/disk-usage.json"_s);
+}
+
+bool isRunning(const DistroboxCli::ContainerInfo &container)
+{
+    return container.status.startsWith(u"Up"_s, Qt::CaseInsensitive);
+}
+
+// The API prefixes image IDs with their digest algorithm, podman's CLI doesn't
+QString bareImageId(const QString &id)
+{
+    return id.startsWith(u"sha256:"_s) ? id.mid(7) : id;
+}
+
+// Image names as the engines abbreviate them, e.g. "ubuntu:latest" for "docker.io/library/ubuntu"
+QString comparableImageName(const QString &name)
+{
+    QString reference = ImagePuller::normalizedReference(name);
+    for (const QLatin1String prefix : {QLatin1String("docker.io/library/"), QLatin1String("docker.io/")}) {
+        if (reference.startsWith(prefix)) {
+            reference.remove(0, prefix.size());
+            break;
+        }
+    }
+    return reference;
+}
+
+// Sizes are numbers in the API and podman's JSON, and human-readable text in docker's CLI
+qint64 jsonSize(const QJsonValue &value)
+{
+    if (value.isDouble()) {
+        return value.toInteger();
+    }
+    return value.isString() ? DistroboxCli::parseHumanSize(value.toString()) : -1;
+}
+}
+
+DiskUsage::DiskUsage(QObject *parent)
+    : QObject(parent)
+    , m_updateTimer(new QTimer(this))
+    , m_runningTimer(new QTimer(this))
+{
+    m_updateTimer->setSingleShot(true);
+    m_updateTimer->setInterval(UpdateDelay);
+    connect(m_updateTimer, &QTimer::timeout, this, &DiskUsage::measure);
+
+    m_runningTimer->setInterval(RunningRefreshInterval);
+    connect(m_runningTimer, &QTimer::timeout, this, [this]() {
+        update(m_containers);
+    });
+
+    load();
+}
+
+bool DiskUsage::isBusy() const
+{
+    return m_pendingRequests > 0;
+}
+
+qint64 DiskUsage::writableTotal() const
+{
+    qint64 total = 0;
+    for (const DistroboxCli::ContainerInfo &container : m_containers) {
+        total += qMax<qint64>(0, m_usage.value(container.id).writable);
+    }
+    return total;
+}
+
+void DiskUsage::update(const QList<DistroboxCli::ContainerInfo> &containers)
+{
+    m_containers = containers;
+
+    // An empty list usually means the engine couldn't be asked, keep what is known
+    if (!containers.isEmpty()) {
+        QSet<QString> ids;
+        for (const DistroboxCli::ContainerInfo &container : containers) {
+            ids.insert(container.id);
+        }
+        const qsizetype known = m_usage.size();
+        m_usage.removeIf([&ids](const QHash<QString, Usage>::iterator it) {
+            return !ids.contains(it.key());
+        });
+        if (m_usage.size() != known) {
+            save();
+        }
+    }
+
+    if (std::any_of(containers.cbegin(), containers.cend(), isRunning)) {
+        if (!m_runningTimer->isActive()) {
+            m_runningTimer->start();
+        }
+    } else {
+        m_runningTimer->stop();
+    }
+
+    if (dirtyContainers().isEmpty() && !imagesStale()) {
+        return;
+    }
+    if (isBusy()) {
+        m_updateAgain = true;
+    } else if (!m_updateTimer->isActive()) {
+        m_updateTimer->start();
+    }
+}
+
+void DiskUsage::apply(QList<DistroboxCli::ContainerInfo> &containers) const
+{
+    // Users of each image among the listed containers, for engines that don't count them
+    QHash<const Image *, int> users;
+    for (const DistroboxCli::ContainerInfo &container : std::as_const(containers)) {
+        if (const Image *image = imageOf(container)) {
+            ++users[image];
+        }
+    }
+
+    for (DistroboxCli::ContainerInfo &container : containers) {
+        const auto usage = m_usage.constFind(container.id);
+        if (usage != m_usage.cend() && usage->writable >= 0) {
+            container.size = usage->writable;
+        }
+
+        if (const Image *image = imageOf(container)) {
+            const qint64 ownLayers = image->size - qMax<qint64>(0, image->sharedSize);
+            const int sharers = image->containers > 0 ? image->containers : users.value(image, 1);
+            container.imageShare = qMax<qint64>(0, ownLayers) / qMax(1, sharers);
+        }
+    }
+}
+
+void DiskUsage::refresh()
+{
+    for (Usage &usage : m_usage) {
+        usage.measured = 0;
+    }
+    m_imagesFetched = 0;
+    m_apiUnavailable = false;
+
+    // Containers that were never measured are dirty already
+    update(m_containers);
+}
+
+QList<DiskUsage::Image> DiskUsage::parseImages(const QByteArray &output)
+{
+    QList<QJsonObject> objects;
+    const QJsonDocument document = QJsonDocument::fromJson(output);
+    if (document.isArray()) {
+        const QJsonArray array = document.array();
+        for (const QJsonValue &value : array) {
+            objects.append(value.toObject());
+        }
+    } else {
+        for (const QByteArray &line : output.split('\n')) {
+            const QJsonDocument lineDocument = QJsonDocument::fromJson(line);
+            if (lineDocument.isObject()) {
+                objects.append(lineDocument.object());
+            }
+        }
+    }
+
+    QList<Image> images;
+    for (const QJsonObject &object : std::as_const(objects)) {
+        const QString id = bareImageId(object.value(u"Id"_s).toString(object.value(u"ID"_s).toString()));
+        if (id.isEmpty()) {
+            continue;
+        }
+
+        QStringList names;
+        for (const QString &key : {u"RepoTags"_s, u"Names"_s}) {
+            const QJsonArray array = object.value(key).toArray();
+            for (const QJsonValue &name : array) {
+                names.append(name.toString());
+            }
+        }
+        // docker's CLI prints one line per tag
+        const QString repository = object.value(u"Repository"_s).toString();
+        if (!repository.isEmpty() && repository != QLatin1String("<none>")) {
+            names.append(repository + QLatin1Char(':') + object.value(u"Tag"_s).toString(u"latest"_s));
+        }
+
+        auto existing = std::find_if(images.begin(), images.end(), [&id](const Image &image) {
+            return image.id == id;
+        });
+        if (existing != images.end()) {
+            existing->names.append(names);
+            continue;
+        }
+
+        Image image;
+        image.id = id;
+        image.names = names;
+        image.size = qMax<qint64>(0, jsonSize(object.value(u"Size"_s)));
+        image.sharedSize = jsonSize(object.value(u"SharedSize"_s));
+        const QJsonValue containers = object.value(u"Containers"_s);
+        image.containers = containers.isDouble() ? containers.toInt() : -1;
+        images.append(image);
+    }
+    return images;
+}
+
+QStringList DiskUsage::dirtyContainers() const
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QStringList dirty;
+    for (const DistroboxCli::ContainerInfo &container : m_containers) {
+        if (container.id.isEmpty()) {
+            continue;
+        }
+        const auto usage = m_usage.constFind(container.id);
+        const bool running = isRunning(container);
+        if (usage == m_usage.cend() || usage->measured == 0 || (usage->measuredRunning && !running)
+            || (running && now - usage->measured >= RunningRefreshInterval)) {
+            dirty.append(container.id);
+        }
+    }
+    return dirty;
+}
+
+bool DiskUsage::imagesStale() const
+{
+    const qint64 age = QDateTime::currentMSecsSinceEpoch() - m_imagesFetched;
+    if (age >= ImagesRefreshInterval) {
+        return true;
+    }
+    if (age < UnknownImageRetry) {
+        return false;
+    }
+    return std::any_of(m_containers.cbegin(), m_containers.cend(), [this](const DistroboxCli::ContainerInfo &container) {
+        return !imageOf(container);
+    });
+}
+
+void DiskUsage::measure()
+{
+    if (isBusy()) {
+        m_updateAgain = true;
+        return;
+    }
+
+    const QStringList dirty = dirtyContainers();
+    const bool stale = imagesStale();
+    m_pendingRequests = (dirty.isEmpty() ? 0 : 1) + (stale ? 1 : 0);
+    if (m_pendingRequests == 0) {
+        return;
+    }
+    Q_EMIT busyChanged();
+
+    if (!dirty.isEmpty()) {
+        measureContainers(dirty);
+    }
+    if (stale) {
+        measureImages();
+    }
+}
+
+void DiskUsage::measureContainers(const QStringList &ids)
+{
+    QSet<QString> running;
+    for (const DistroboxCli::ContainerInfo &container : std::as_const(m_containers)) {
+        if (ids.contains(container.id) && isRunning(container)) {
+            running.insert(container.id);
+        }
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (EngineApiClient *client = api()) {
+        EngineApiClient::onFinished(client->containerSizes(ids, MeasureTimeout), this, [this, ids, running, timer](const ApiResponse &response) {
+            if (!response.success()) {
+                qWarning() << "Cannot measure containers through the engine API, using the CLI:" << response.statusCode;
+                m_apiUnavailable = true;
+                measureContainers(ids);
+                return;
+            }
+
+            QHash<QString, Usage> measured;
+            const QJsonArray containers = response.json().array();
+            for (const QJsonValue &value : containers) {
+                const QJsonObject object = value.toObject();
+                Usage usage;
+                usage.writable = object.value(u"SizeRw"_s).toInteger(-1);
+                usage.imageId = bareImageId(object.value(u"ImageID"_s).toString());
+                measured.insert(object.value(u"Id"_s).toString(), usage);
+            }
+            qDebug() << "Measured" << measured.size() << "of" << ids.size() << "containers through the engine API in" << timer.elapsed() << "ms";
+            containersMeasured(ids, measured, running);
+        });
+        return;
+    }
+
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(DistroboxCli::containerSizesCommand(ids), MeasureTimeout);
+    CommandExecutor::onFinished(future, this, [this, ids, running, timer](const CommandResult &result) {
+        QHash<QString, Usage> measured;
+        if (result.success()) {
+            for (const QString &line : result.text().split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+                const qsizetype separator = line.indexOf(QLatin1Char('|'));
+                if (separator <= 0) {
+                    continue;
+                }
+                Usage usage;
+                usage.writable = DistroboxCli::parseHumanSize(line.mid(separator + 1));
+                measured.insert(line.left(separator).trimmed(), usage);
+            }
+        } else {
+            qWarning() << "Cannot measure containers:" << QString::fromUtf8(result.errorOutput).trimmed();
+        }
+        qDebug() << "Measured" << measured.size() << "of" << ids.size() << "containers in" << timer.elapsed() << "ms";
+        containersMeasured(ids, measured, running);
+    });
+}
+
+void DiskUsage::containersMeasured(const QStringList &ids, const QHash<QString, Usage> &measured, const QSet<QString> &running)
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (const QString &id : ids) {
+        // Engines may answer with IDs of another length than the ones listed
+        auto it = measured.constFind(id);
+        if (it == measured.cend()) {
+            for (auto candidate = measured.cbegin(); candidate != measured.cend(); ++candidate) {
+                if (candidate.key().startsWith(id) || id.startsWith(candidate.key())) {
+                    it = candidate;
+                    break;
+                }
+            }
+        }
+
+        // Containers without an answer keep their old size, instead of being asked again right away
+        Usage usage = it != measured.cend() ? it.value() : m_usage.value(id);
+        if (usage.imageId.isEmpty()) {
+            usage.imageId = m_usage.value(id).imageId;
+        }
+        usage.measured = now;
+        usage.measuredRunning = running.contains(id);
+        m_usage.insert(id, usage);
+    }
+    requestFinished();
+}
+
+void DiskUsage::measureImages()
+{
+    if (EngineApiClient *client = api()) {
+        EngineApiClient::onFinished(client->listImages(), this, [this](const ApiResponse &response) {
+            if (!response.success()) {
+                qWarning() << "Cannot list images through the engine API, using the CLI:" << response.statusCode;
+                m_apiUnavailable = true;
+                measureImages();
+                return;
+            }
+            m_images = parseImages(response.body);
+            m_imagesFetched = QDateTime::currentMSecsSinceEpoch();
+            requestFinished();
+        });
+        return;
+    }
+
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(DistroboxCli::imagesCommand());
+    CommandExecutor::onFinished(future, this, [this](const CommandResult &result) {
+        if (result.success()) {
+            m_images = parseImages(result.output);
+        } else {
+            qWarning() << "Cannot list images:" << QString::fromUtf8(result.errorOutput).trimmed();
+        }
+        // Also after a failure, so a broken engine isn't asked in a loop
+        m_imagesFetched = QDateTime::currentMSecsSinceEpoch();
+        requestFinished();
+    });
+}
+
+void DiskUsage::requestFinished()
+{
+    if (--m_pendingRequests > 0) {
+        return;
+    }
+
+    save();
+    Q_EMIT busyChanged();
+    Q_EMIT updated();
+
+    if (m_updateAgain) {
+        m_updateAgain = false;
+        update(m_containers);
+    }
+}
+
+const DiskUsage::Image *DiskUsage::imageOf(const DistroboxCli::ContainerInfo &container) const
+{
+    const QString imageId = m_usage.value(container.id).imageId;
+    const QString name = imageId.isEmpty() ? comparableImageName(container.image) : QString();
+
+    for (const Image &image : m_images) {
+        if (!imageId.isEmpty()) {
+            if (image.id.startsWith(imageId) || imageId.startsWith(image.id)) {
+                return &image;
+            }
+            continue;
+        }
+        for (const QString &imageName : image.names) {
+            if (comparableImageName(imageName) == name) {
+                return &image;
+            }
+        }
+    }
+    return nullptr;
+}
+
+EngineApiClient *DiskUsage::api()
+{
+    if (m_apiUnavailable) {
+        return nullptr;
+    }
+    if (!m_api) {
+        const QString socketPath = EngineApiClient::defaultSocketPath();
+        if (socketPath.isEmpty()) {
+            m_apiUnavailable = true;
+            return nullptr;
+        }
+        m_api = new EngineApiClient(socketPath, this);
+    }
+    return m_api;
+}
+
+void DiskUsage::load()
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const QJsonObject cache = QJsonDocument::fromJson(file.readAll()).object();
+    if (cache.value(QLatin1String("version")).toInt() != CacheVersion) {
+        return;
+    }
+
+    const QJsonObject containers = cache.value(QLatin1String("containers")).toObject();
+    for (auto it = containers.constBegin(); it != containers.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        Usage usage;
+        usage.writable = object.value(QLatin1String("writable")).toInteger(-1);
+        usage.imageId = object.value(QLatin1String("imageId")).toString();
+        usage.measured = object.value(QLatin1String("measured")).toInteger();
+        usage.measuredRunning = object.value(QLatin1String("running")).toBool();
+        m_usage.insert(it.key(), usage);
+    }
+
+    const QJsonArray images = cache.value(QLatin1String("images")).toArray();
+    for (const QJsonValue &value : images) {
+        const QJsonObject object = value.toObject();
+        Image image;
+        image.id = object.value(QLatin1String("id")).toString();
+        for (const QJsonValue &name : object.value(QLatin1String("names")).toArray()) {
+            image.names.append(name.toString());
+        }
+        image.size = object.value(QLatin1String("size")).toInteger();
+        image.sharedSize = object.value(QLatin1String("sharedSize")).toInteger(-1);
+        image.containers = object.value(QLatin1String("containers")).toInt(-1);
+        m_images.append(image);
+    }
+    m_imagesFetched = cache.value(QLatin1String("imagesFetched")).toInteger();
+
+    qDebug() << "Loaded the disk usage of" << m_usage.size() << "containers and" << m_images.size() << "images";
+}
+
+void DiskUsage::save() const
+{
+    const QString path = cacheFilePath();
+    if (path.isEmpty()) {
+        return;
+    }
+    QDir().mkpath(QFileInfo(path).path());
+
+    QJsonObject containers;
+    for (auto it = m_usage.cbegin(); it != m_usage.cend(); ++it) {
+        containers[it.key()] = QJsonObject{
+            {u"writable"_s, it->writable},
+            {u"imageId"_s, it->imageId},
+            {u"measured"_s, it->measured},
+            {u"running"_s, it->measuredRunning},
+        };
+    }
+
+    QJsonArray images;
+    for (const Image &image : m_images) {
+        images.append(QJsonObject{
+            {u"id"_s, image.id},
+            {u"names"_s, QJsonArray::fromStringList(image.names)},
+            {u"size"_s, image.size},
+            {u"sharedSize"_s, image.sharedSize},
+            {u"containers"_s, image.containers},
+        });
+    }
+
+    QJsonObject cache;
+    cache[u"version"_s] = CacheVersion;
+    cache[u"containers"_s] = containers;
+    cache[u"images"_s] = images;
+    cache[u"imagesFetched"_s] = m_imagesFetched;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write the disk usage cache" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Cannot write the disk usage cache" << file.errorString();
+    }
+}
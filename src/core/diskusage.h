@@ -0,0 +1,142 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <qqmlintegration.h>
+
+class EngineApiClient;
+class QTimer;
+
+/**
+ * @class DiskUsage
+ * @brief Keeps track of the storage used by each container and its image
+ *
+ * A container's size has two parts:
+ * - its writable layer, which is what removing the container frees
+ * - its share of the image, which is the image's own layers divided among the
+ *   containers using it
+ *
+ * Layers an image shares with other images are not attributed to any container, so
+ * shared layers are never counted twice.
+ *
+ * Measuring a writable layer makes the engine walk it, so sizes are cached on disk.
+ * Only containers that may have changed are measured again, in the background:
+ * - new containers
+ * - containers that stopped since they were last measured
+ * - running containers every RunningRefreshInterval
+ *
+ * A stopped container's layer doesn't change, so it is measured once. Image sizes
+ * never change and the image list is cheap, so images are simply listed again now
+ * and then.
+ */
+class DiskUsage : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Use distroBoxManager.diskUsage")
+
+    /**
+     * @brief Whether sizes are being measured
+     */
+    Q_PROPERTY(bool busy READ isBusy NOTIFY busyChanged)
+
+    /**
+     * @brief Bytes in the writable layers of all containers
+     */
+    Q_PROPERTY(qint64 writableTotal READ writableTotal NOTIFY updated)
+
+public:
+    static constexpr int RunningRefreshInterval = 15 * 60 * 1000; ///< Milliseconds
+    static constexpr int ImagesRefreshInterval = 60 * 60 * 1000; ///< Milliseconds
+    static constexpr int UpdateDelay = 2000; ///< Milliseconds a burst of container changes is collected
+
+    /**
+     * @struct Image
+     * @brief Size of an image as the engine reports it
+     */
+    struct Image {
+        QString id;
+        QStringList names; ///< Repository tags
+        qint64 size = 0; ///< All layers
+        qint64 sharedSize = -1; ///< Bytes in layers other images use as well, -1 if not known
+        int containers = -1; ///< Containers of any kind using the image, -1 if not known
+    };
+
+    explicit DiskUsage(QObject *parent = nullptr);
+
+    bool isBusy() const;
+    qint64 writableTotal() const;
+
+    /**
+     * @brief Follows @p containers, measuring the ones that may have changed in the background
+     */
+    void update(const QList<DistroboxCli::ContainerInfo> &containers);
+
+    /**
+     * @brief Fills size and imageShare of @p containers from what was measured so far
+     */
+    void apply(QList<DistroboxCli::ContainerInfo> &containers) const;
+
+    /**
+     * @brief Measures every container and lists the images again, e.g. after an image was pruned
+     */
+    Q_INVOKABLE void refresh();
+
+    /**
+     * @brief Parses a /images/json response or the output of DistroboxCli::imagesCommand()
+     */
+    static QList<Image> parseImages(const QByteArray &output);
+
+Q_SIGNALS:
+    void busyChanged();
+
+    /**
+     * @brief Emitted when sizes changed; apply() them to the container list
+     */
+    void updated();
+
+private:
+    struct Usage {
+        qint64 writable = -1;
+        QString imageId; ///< Empty if the engine didn't report it, the image is then found by name
+        qint64 measured = 0; ///< Milliseconds since the epoch, 0 to measure again
+        bool measuredRunning = false; ///< The container was running when it was measured
+    };
+
+    QStringList dirtyContainers() const;
+    bool imagesStale() const;
+    void measure();
+    void measureContainers(const QStringList &ids);
+    void measureImages();
+    void requestFinished();
+    void containersMeasured(const QStringList &ids, const QHash<QString, Usage> &measured, const QSet<QString> &running);
+    const Image *imageOf(const DistroboxCli::ContainerInfo &container) const;
+    EngineApiClient *api();
+
+    void load();
+    void save() const;
+
+    QList<DistroboxCli::ContainerInfo> m_containers; ///< Last list given to update()
+    QHash<QString, Usage> m_usage; ///< By full container ID
+    QList<Image> m_images;
+    qint64 m_imagesFetched = 0; ///< Milliseconds since the epoch
+    QPointer<EngineApiClient> m_api; ///< Own connection, measuring would hold up every other API request
+    bool m_apiUnavailable = false;
+    QTimer *m_updateTimer;
+    QTimer *m_runningTimer;
+    int m_pendingRequests = 0;
+    bool m_updateAgain = false; ///< Something changed while measuring
+};
@@ -4,13 +4,20 @@
 */
 
 #include "distroboxcli.h"
+#include "hosthelper.h"
 
+#include <KShell>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QEventLoop>
 #include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QProcess>
+#include <QRegularExpression>
+#include <QTimeZone>
+#include <QTimer>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -20,11 +27,64 @@ bool isFlatpakRuntime()
 {
     return QFile::exists(u"/.flatpak-info"_s);
 }
+
+// Parses the "2025-01-31 10:00:00 +0100 CET" timestamps printed by podman and docker
+QDateTime parseEngineTimestamp(const QString &value)
+{
+    static const QRegularExpression pattern(u"^(\\d{4}-\\d{2}-\\d{2} \\d{2}:\\d{2}:\\d{2})(?:\\.\\d+)? ([+-])(\\d{2})(\\d{2})"_s);
+
+    const QRegularExpressionMatch match = pattern.match(value.trimmed());
+    if (!match.hasMatch()) {
+        return {};
+    }
+
+    QDateTime dateTime = QDateTime::fromString(match.captured(1), u"yyyy-MM-dd HH:mm:ss"_s);
+    const int sign = match.captured(2) == QLatin1String("-") ? -1 : 1;
+    const int offset = sign * (match.captured(3).toInt() * 3600 + match.captured(4).toInt() * 60);
+    dateTime.setTimeZone(QTimeZone::fromSecondsAheadOfUtc(offset));
+    return dateTime;
+}
+
+// Wraps @p script in a sh invocation where $engine is the engine distrobox uses
+QString engineCommand(const QString &script)
+{
+    const QString fullScript = u"engine=\"${DBX_CONTAINER_MANAGER:-$(command -v podman || command -v docker)}\"; "
+                               u"[ -n \"$engine\" ] || exit 127; "_s
+        + script;
+
+    return u"sh -c %1"_s.arg(KShell::quoteArg(fullScript));
+}
 }
 
 namespace DistroboxCli
 {
-QString runCommand(const QString &command, bool &success)
+bool ContainerInfo::operator==(const ContainerInfo &other) const
+{
+    return id == other.id && name == other.name && image == other.image && status == other.status && created == other.created && size == other.size
+        && imageShare == other.imageShare;
+}
+
+qint64 parseHumanSize(const QString &value)
+{
+    static const QRegularExpression pattern(u"^\\s*([0-9.]+)\\s*([kKMGTP]?i?)B"_s);
+
+    const QRegularExpressionMatch match = pattern.match(value);
+    if (!match.hasMatch()) {
+        return -1;
+    }
+
+    const QString unit = match.captured(2).toUpper();
+    const double base = unit.endsWith(QLatin1Char('I')) ? 1024.0 : 1000.0;
+    const int exponent = unit.isEmpty() ? 0 : QStringLiteral("KMGTP").indexOf(unit.at(0)) + 1;
+
+    double bytes = match.captured(1).toDouble();
+    for (int i = 0; i < exponent; ++i) {
+        bytes *= base;
+    }
+    return static_cast<qint64>(bytes);
+}
+
+QStringList hostShellArguments(const QString &command)
 {
     QString actualCommand = u"/usr/bin/env "_s + command;
 
@@ -32,30 +92,76 @@ QString runCommand(const QString &command, bool &success)
         actualCommand = u"flatpak-spawn --host /usr/bin/env "_s + command;
     }
 
-    QString output;
-    QProcess process;
-    QObject::connect(&process, &QProcess::finished, [&process, &output, &success](int exitCode, QProcess::ExitStatus) {
-        output = QString::fromUtf8(process.readAllStandardOutput());
-        success = (exitCode == 0);
-    });
+    return {u"-c"_s, actualCommand};
+}
+
+QString runCommand(const QString &command, bool &success, int timeoutMs)
+{
+    success = false;
 
+    // Callers wait in a nested event loop so the window keeps painting while the command runs
     QEventLoop loop;
+    QTimer timeout;
+    timeout.setSingleShot(true);
+    bool timedOut = false;
+    QObject::connect(&timeout, &QTimer::timeout, &loop, [&loop, &timedOut]() {
+        timedOut = true;
+        loop.quit();
+    });
+
+    // Inside Flatpak this saves a flatpak-spawn per command
+    if (HostHelper::isEnabled()) {
+        CommandResult result;
+        CommandExecutor::onFinished(HostHelper::session()->run(command, timeoutMs), &loop, [&loop, &result](const CommandResult &finished) {
+            result = finished;
+            loop.quit();
+        });
+        loop.exec();
+
+        if (result.timedOut) {
+            qWarning() << "Command timed out:" << command;
+        }
+        success = result.success();
+        return result.text();
+    }
+
+    QProcess process;
     QObject::connect(&process, &QProcess::finished, &loop, &QEventLoop::quit);
+    QObject::connect(&process, &QProcess::errorOccurred, &loop, [&loop](QProcess::ProcessError error) {
+        // Every other error is followed by finished()
+        if (error == QProcess::FailedToStart) {
+            loop.quit();
+        }
+    });
 
-    process.start(u"sh"_s, QStringList() << QLatin1String("-c") << actualCommand);
+    process.start(u"sh"_s, hostShellArguments(command));
+    if (process.state() == QProcess::NotRunning) {
+        return {};
+    }
+    if (timeoutMs > 0) {
+        timeout.start(timeoutMs);
+    }
     loop.exec();
 
-    return output;
+    if (timedOut) {
+        qWarning() << "Command timed out:" << command;
+        process.disconnect(&loop);
+        process.kill();
+        process.waitForFinished();
+        return {};
+    }
+
+    success = process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0 && process.error() != QProcess::FailedToStart;
+    return QString::fromUtf8(process.readAllStandardOutput());
 }
 
-AvailableImages availableImages()
+QString availableImagesCommand()
 {
-    bool success = false;
-    const QString output = runCommand(u"distrobox create -C"_s, success);
-    if (!success) {
-        return {};
-    }
+    return u"distrobox create -C"_s;
+}
 
+AvailableImages parseAvailableImages(const QString &output)
+{
     QStringList lines = output.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
     if (!lines.isEmpty() && lines.first().trimmed().isEmpty()) {
         lines.removeFirst();
@@ -67,40 +173,148 @@ AvailableImages availableImages()
     return images;
 }
 
-QString containersJson()
+AvailableImages availableImages()
 {
     bool success = false;
-    const QString namesOutput = runCommand(u"distrobox list | tail -n +2 | cut -d'|' -f2 | awk '{$1=$1;print}'"_s, success);
+    const QString output = runCommand(availableImagesCommand(), success);
     if (!success) {
-        return u"[]"_s;
+        return {};
     }
+    return parseAvailableImages(output);
+}
 
-    const QString imagesOutput = runCommand(u"distrobox list | tail -n +2 | cut -d'|' -f4 | awk '{$1=$1;print}'"_s, success);
-    if (!success) {
-        return u"[]"_s;
+QString containersCommand(bool withSize)
+{
+    // Same query distrobox list runs internally, but once and with every field we need.
+    // Labels and mounts come last so a '|' inside them can't shift the other columns.
+    QString format = u"{{.ID}}|{{.Names}}|{{.Status}}|{{.Image}}|{{.CreatedAt}}|"_s;
+    if (withSize) {
+        format += u"{{.Size}}|"_s;
+    }
+    format += u"{{.Labels}}{{.Mounts}}"_s;
+
+    return engineCommand(u"exec \"$engine\" ps -a --no-trunc %1--format %2"_s.arg(withSize ? u"--size "_s : QString(), KShell::quoteArg(format)));
+}
+
+QString inspectCommand(const QString &container, const QString &format)
+{
+    return engineCommand(u"exec \"$engine\" inspect --type container --format %1 %2"_s.arg(KShell::quoteArg(format), KShell::quoteArg(container)));
+}
+
+QString eventsCommand()
+{
+    // podman only understands "json" as a shortcut, docker needs the template function
+    return engineCommand(
+        u"case \"${engine##*/}\" in docker*) format='{{json .}}' ;; *) format=json ;; esac; "
+        u"exec \"$engine\" events --filter type=container --format \"$format\""_s);
+}
+
+QString containerSizesCommand(const QStringList &ids)
+{
+    QString filters;
+    for (const QString &id : ids) {
+        filters += u" --filter id=%1"_s.arg(KShell::quoteArg(id));
     }
 
-    const QString statusOutput = runCommand(u"distrobox list | tail -n +2 | cut -d'|' -f3 | awk '{$1=$1;print}'"_s, success);
+    // --size makes the engine walk the writable layers, so only the given containers are listed
+    return engineCommand(u"exec \"$engine\" ps -a --no-trunc --size%1 --format '{{.ID}}|{{.Size}}'"_s.arg(filters));
+}
+
+QString imagesCommand()
+{
+    // Same format switch as eventsCommand(); podman prints an array with SharedSize, docker one object per line
+    return engineCommand(
+        u"case \"${engine##*/}\" in docker*) format='{{json .}}' ;; *) format=json ;; esac; "
+        u"exec \"$engine\" images --no-trunc --format \"$format\""_s);
+}
+
+QString statsCommand(const QStringList &containers)
+{
+    QStringList arguments;
+    for (const QString &container : containers) {
+        arguments.append(KShell::quoteArg(container));
+    }
+
+    // Same format switch as eventsCommand(); docker prints one object per line, podman an array
+    return engineCommand(u"case \"${engine##*/}\" in docker*) format='{{json .}}' ;; *) format=json ;; esac; "
+                         u"exec \"$engine\" stats --no-stream --format \"$format\" "_s
+                         + arguments.join(QLatin1Char(' ')));
+}
+
+QList<ContainerInfo> parseContainers(const QString &output, bool withSize)
+{
+    QList<ContainerInfo> result;
+    const int fixedColumns = withSize ? 6 : 5;
+
+    for (const QString &line : output.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts)) {
+        const QStringList columns = line.split(QLatin1Char('|'));
+        if (columns.size() <= fixedColumns) {
+            continue;
+        }
+
+        // Like distrobox list, only keep containers carrying the distrobox label or init mount
+        const QString labelsAndMounts = columns.mid(fixedColumns).join(QLatin1Char('|'));
+        if (!labelsAndMounts.contains(u"distrobox"_s)) {
+            continue;
+        }
+
+        ContainerInfo container;
+        container.id = columns[0].trimmed();
+        container.name = columns[1].trimmed();
+        container.status = columns[2].trimmed();
+        container.image = columns[3].trimmed();
+        container.created = parseEngineTimestamp(columns[4]);
+        if (withSize) {
+            container.size = parseHumanSize(columns[5]);
+        }
+        result.append(container);
+    }
+
+    return result;
+}
+
+QList<ContainerInfo> containers(bool withSize)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool success = false;
+    const QString output = runCommand(containersCommand(withSize), success);
     if (!success) {
-        return u"[]"_s;
+        return {};
     }
 
-    const QStringList names = namesOutput.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
-    const QStringList images = imagesOutput.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
-    const QStringList statuses = statusOutput.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts);
+    const QList<ContainerInfo> result = parseContainers(output, withSize);
+    qDebug() << "Listed" << result.size() << "containers in" << timer.elapsed() << "ms";
+    return result;
+}
 
+QString containersJson(const QList<ContainerInfo> &containers)
+{
     QJsonArray containerArray;
-    for (int i = 0; i < qMin(names.size(), qMin(images.size(), statuses.size())); ++i) {
+    for (const ContainerInfo &info : containers) {
         QJsonObject container;
-        container[u"name"_s] = names[i];
-        container[u"image"_s] = images[i];
-        container[u"status"_s] = statuses[i];
+        container[u"id"_s] = info.id;
+        container[u"name"_s] = info.name;
+        container[u"image"_s] = info.image;
+        container[u"status"_s] = info.status;
+        if (info.created.isValid()) {
+            container[u"created"_s] = info.created.toString(Qt::ISODate);
+        }
+        if (info.size >= 0) {
+            container[u"size"_s] = info.size;
+        }
         containerArray.append(container);
     }
 
     return QString::fromUtf8(QJsonDocument(containerArray).toJson());
 }
 
+QString containersJson()
+{
+    return containersJson(containers());
+}
+
 QString availableImagesJson(const AvailableImages &images)
 {
     if (images.displayNames.isEmpty() || images.fullNames.isEmpty()) {
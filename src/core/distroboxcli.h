@@ -5,6 +5,10 @@
 
 #pragma once
 
+#include "commandexecutor.h"
+
+#include <QDateTime>
+#include <QList>
 #include <QString>
 #include <QStringList>
 
@@ -15,8 +19,45 @@ struct AvailableImages {
     QStringList fullNames;
 };
 
-QString runCommand(const QString &command, bool &success);
+struct ContainerInfo {
+    QString id;
+    QString name;
+    QString image;
+    QString status;
+    QDateTime created;
+    qint64 size = -1; ///< Writable layer size in bytes, -1 if not queried
+    qint64 imageShare = -1; ///< Bytes of the image attributed to this container, see DiskUsage; -1 if not known
+
+    bool operator==(const ContainerInfo &other) const;
+};
+
+/**
+ * @brief Parses the leading size of engine output such as "12.3kB (virtual 512MB)" into bytes
+ * @return Bytes, -1 if @p value doesn't start with a size
+ */
+qint64 parseHumanSize(const QString &value);
+
+QStringList hostShellArguments(const QString &command);
+
+/**
+ * @brief Runs @p command on the host and waits for it in a nested event loop
+ *
+ * Prefer CommandExecutor; this remains for callers that still need the output synchronously.
+ */
+QString runCommand(const QString &command, bool &success, int timeoutMs = CommandExecutor::DefaultTimeout);
+
+QString availableImagesCommand();
+AvailableImages parseAvailableImages(const QString &output);
 AvailableImages availableImages();
+QString containersCommand(bool withSize = false);
+QString inspectCommand(const QString &container, const QString &format);
+QString eventsCommand();
+QString statsCommand(const QStringList &containers);
+QString containerSizesCommand(const QStringList &ids);
+QString imagesCommand();
+QList<ContainerInfo> parseContainers(const QString &output, bool withSize = false);
+QList<ContainerInfo> containers(bool withSize = false);
+QString containersJson(const QList<ContainerInfo> &containers);
 QString containersJson();
 QString availableImagesJson(const AvailableImages &images);
 bool isFlatpak();
@@ -6,50 +6,97 @@
  */
 
 #include "distroboxmanager.h"
+#include "applicationcatalog.h"
+#include "containereventwatcher.h"
+#include "containerfilesystem.h"
+#include "containericons.h"
 #include "distroboxcli.h"
 #include "distrocolors.h"
+#include "engineapiclient.h"
+#include "engineprobe.h"
+#include "hostdesktopindex.h"
+#include "iconcache.h"
+#include "iconimageprovider.h"
+#include "imagecatalog.h"
 #include "packageinstallcommand.h"
+#include "shellsession.h"
 #include "terminallauncher.h"
 #include <KLocalizedContext>
 #include <KLocalizedString>
 #include <KShell>
 #include <QByteArray>
+#include <QCoreApplication>
+#include <QDateTime>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFile>
 #include <QFileInfo>
 #include <QHash>
+#include <QLocale>
 #include <QPointer>
 #include <QRegularExpression>
-#include <QSettings>
 #include <QStandardPaths>
 #include <QTextStream>
+#include <QThreadPool>
+#include <QTimer>
 #include <QUrl>
+#include <memory>
+#include <optional>
 #include <sys/xattr.h>
-#include <QByteArray>
 #include <distroicons.h>
 
 using namespace Qt::Literals::StringLiterals;
 
 namespace
 {
-QString ensureIconCacheDirectory(const QString &container)
+// Runs a script through the container's shell session instead of a new distrobox enter per call
+QString runContainerCommand(const QString &container, const QString &script, bool &success)
 {
-    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
-    if (cacheBase.isEmpty()) {
-        return {};
+    const CommandResult result = ShellSession::forContainer(container)->runBlocking(script);
+    success = result.success();
+    return result.text();
+}
+
+// Removes the desktop file distrobox-export wrote for @p basename, leaving shared icons and metadata alone
+bool removeExportedDesktopFile(const QString &basename, const QString &container)
+{
+    if (DistroboxCli::isFlatpak()) {
+        qDebug() << "Manual removal skipped - read-only access inside Flatpak runtime";
+        return false;
     }
 
-    QDir cacheDir(cacheBase);
-    const QString iconsRoot = cacheDir.filePath(QStringLiteral("kontainer/icons/%1").arg(container));
-    QDir().mkpath(iconsRoot);
-    return iconsRoot;
+    const QString path = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation) + u"/%1-%2.desktop"_s.arg(container, basename);
+    QFile desktopFile(path);
+    if (!desktopFile.exists()) {
+        qDebug() << "Desktop file does not exist:" << path;
+        return false;
+    }
+    if (!desktopFile.remove()) {
+        qDebug() << "Could not remove" << path << ":" << desktopFile.errorString();
+        return false;
+    }
+
+    qDebug() << "Removed desktop file" << path;
+    return true;
 }
 
-QString runContainerCommand(const QString &container, const QString &script, bool &success)
+// Reads a file of the container from the host if possible, through the container's shell otherwise,
+// and passes the contents, or std::nullopt, to @p handler on the thread of @p context
+void readContainerFile(const QString &container,
+                       const QString &path,
+                       QObject *context,
+                       const std::function<void(const std::optional<QByteArray> &)> &handler)
 {
-    const QString command = u"distrobox enter %1 -- sh -c %2"_s.arg(container, KShell::quoteArg(script));
-    return DistroboxCli::runCommand(command, success);
+    if (const auto contents = ContainerFilesystem::forContainer(container).readFile(path)) {
+        handler(contents);
+        return;
+    }
+
+    const QFuture<CommandResult> future = ShellSession::forContainer(container)->run(u"cat %1"_s.arg(KShell::quoteArg(path)));
+    CommandExecutor::onFinished(future, context, [handler](const CommandResult &result) {
+        handler(result.success() ? std::optional<QByteArray>(result.output) : std::nullopt);
+    });
 }
 
 static QString resolveDocumentPortalPath(const QString &path)
@@ -73,172 +120,414 @@ static QString resolveDocumentPortalPath(const QString &path)
     return path;
 }
 
-QString resolveIconPathInContainer(const QString &container, const QString &iconValue)
+// Images a distrobox.ini manifest creates its containers from
+QStringList manifestImages(const QString &path)
 {
-    if (iconValue.trimmed().isEmpty()) {
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         return {};
     }
 
-    const QString pythonScript = QStringLiteral(
-                                     "python3 - %1 <<'PY'\n"
-                                     "import os, sys\n"
-                                     "icon = sys.argv[1]\n"
-                                     "if not icon:\n"
-                                     "    raise SystemExit(1)\n"
-                                     "if os.path.isabs(icon) and os.path.exists(icon):\n"
-                                     "    print(icon, end=\"\")\n"
-                                     "    raise SystemExit(0)\n"
-                                     "search_dirs = [\"/usr/share/icons\", \"/usr/local/share/icons\", \"/usr/share/pixmaps\", \"/usr/share/applications\", "
-                                     "\"/usr/share/icons/hicolor\"]\n"
-                                     "extensions = [\".png\", \".svg\", \".xpm\", \".jpg\", \".jpeg\", \".ico\"]\n"
-                                     "icon_path, icon_base = os.path.split(icon)\n"
-                                     "if not icon_base:\n"
-                                     "    icon_base = icon\n"
-                                     "    icon_path = ''\n"
-                                     "base, suffix = os.path.splitext(icon_base)\n"
-                                     "if suffix:\n"
-                                     "    candidates = [icon_base]\n"
-                                     "else:\n"
-                                     "    candidates = [icon_base + ext for ext in extensions]\n"
-                                     "candidate_dirs = []\n"
-                                     "if icon_path and icon_path != '.':\n"
-                                     "    for root in search_dirs:\n"
-                                     "        candidate_dir = os.path.join(root, icon_path)\n"
-                                     "        if os.path.isdir(candidate_dir):\n"
-                                     "            candidate_dirs.append(candidate_dir)\n"
-                                     "else:\n"
-                                     "    candidate_dirs.extend([d for d in search_dirs if os.path.isdir(d)])\n"
-                                     "for directory in candidate_dirs:\n"
-                                     "    for candidate in candidates:\n"
-                                     "        candidate_path = os.path.join(directory, candidate)\n"
-                                     "        if os.path.exists(candidate_path):\n"
-                                     "            print(candidate_path, end=\"\")\n"
-                                     "            raise SystemExit(0)\n"
-                                     "for directory in search_dirs:\n"
-                                     "    if not os.path.isdir(directory):\n"
-                                     "        continue\n"
-                                     "    for root, _, files in os.walk(directory):\n"
-                                     "        for candidate in candidates:\n"
-                                     "            if candidate in files:\n"
-                                     "                print(os.path.join(root, candidate), end=\"\")\n"
-                                     "                raise SystemExit(0)\n"
-                                     "print('', end=\"\")\n"
-                                     "raise SystemExit(1)\n"
-                                     "PY")
-                                     .arg(KShell::quoteArg(iconValue));
-
-    bool success = false;
-    const QString output = runContainerCommand(container, pythonScript, success);
-    if (!success) {
-        return {};
+    QStringList images;
+    QTextStream stream(&file);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (line.startsWith(QLatin1Char('#')) || line.startsWith(QLatin1Char(';'))) {
+            continue;
+        }
+        const qsizetype equals = line.indexOf(QLatin1Char('='));
+        if (equals < 0 || line.left(equals).trimmed() != QLatin1String("image")) {
+            continue;
+        }
+
+        QString image = line.mid(equals + 1).trimmed();
+        if (image.size() >= 2 && (image.startsWith(QLatin1Char('"')) || image.startsWith(QLatin1Char('\''))) && image.endsWith(image.front())) {
+            image = image.mid(1, image.size() - 2);
+        }
+        if (!image.isEmpty() && !images.contains(image)) {
+            images.append(image);
+        }
     }
+    return images;
+}
+
+// Upper bound for start/stop/remove, which normally take a few seconds
+constexpr int ContainerOperationTimeout = 120000;
+
+// Time after startup at which the image list is loaded if nothing asked for it yet
+constexpr int AvailableImagesPrefetchDelay = 3000;
 
-    return output.trimmed();
+// distrobox create -C can be slow on a cold start
+constexpr int AvailableImagesTimeout = 60000;
+
+// End of the stderr of a failed (un)export kept for the batch result, in bytes
+constexpr int MaximumBatchErrorSize = 2048;
 }
 
-QString cacheIconFromContainer(const QString &container, const QString &basename, const QString &iconValue)
+// Constructor: Initializes the manager; the available images are loaded once the event loop runs
+DistroboxManager::DistroboxManager(QObject *parent)
+    : QObject(parent)
+    , m_eventWatcher(new ContainerEventWatcher(this))
+    , m_containerModel(new ContainerListModel(this))
+    , m_upgradeScheduler(new UpgradeScheduler(this))
+    , m_containerMetrics(new ContainerMetrics(m_containerModel, this))
+    , m_diskUsage(new DiskUsage(this))
 {
-    static QHash<QString, QString> iconCache;
+    // Have the image list ready by the time the create dialog opens, without delaying the first window
+    QTimer::singleShot(AvailableImagesPrefetchDelay, this, [this]() {
+        if (!m_availableImagesLoaded) {
+            loadAvailableImages();
+        }
+    });
+
+    connect(m_eventWatcher, &ContainerEventWatcher::containerCreated, this, &DistroboxManager::handleContainerCreated);
+    connect(m_eventWatcher, &ContainerEventWatcher::containerStarted, this, [this](const QString &id) {
+        handleContainerStatus(id, u"Up"_s);
+    });
+    connect(m_eventWatcher, &ContainerEventWatcher::containerStopped, this, [this](const QString &id) {
+        handleContainerStatus(id, u"Exited"_s);
+    });
+    connect(m_eventWatcher, &ContainerEventWatcher::containerRemoved, this, &DistroboxManager::handleContainerRemoved);
+    connect(m_eventWatcher, &ContainerEventWatcher::containerRenamed, this, &DistroboxManager::handleContainerRenamed);
+    connect(m_eventWatcher, &ContainerEventWatcher::activeChanged, this, [this, reconnect = false](bool active) mutable {
+        // Events may have been missed while the stream was down
+        if (active && reconnect) {
+            refreshContainers();
+        }
+        reconnect = reconnect || active;
+        Q_EMIT watchingContainerEventsChanged();
+    });
+    m_eventWatcher->start();
+
+    connect(m_diskUsage, &DiskUsage::updated, this, [this]() {
+        m_diskUsage->apply(m_containers);
+        m_containerModel->setContainers(m_containers);
+    });
+
+    connect(EngineProbe::instance(), &EngineProbe::capabilitiesChanged, this, &DistroboxManager::containerEnginesChanged);
+    connect(HostDesktopIndex::instance(), &HostDesktopIndex::changed, this, &DistroboxManager::refreshExportedApps);
+
+    // Icons of a removed container are never needed again
+    connect(this, &DistroboxManager::containerOperationFinished, this, [](const QString &name, const QString &operation, bool success) {
+        if (operation == QLatin1String("remove") && success) {
+            IconCache::instance()->purgeContainer(name);
+        }
+    });
+}
 
-    const QString cacheKey = container + QLatin1Char('|') + iconValue;
-    if (iconCache.contains(cacheKey)) {
-        return iconCache.value(cacheKey);
-    }
+// Lists all existing containers and their base images in JSON format
+QString DistroboxManager::listContainers()
+{
+    return DistroboxCli::containersJson();
+}
 
-    const QString iconPath = resolveIconPathInContainer(container, iconValue);
-    if (iconPath.isEmpty()) {
-        iconCache.insert(cacheKey, QString());
-        return {};
+// Lists all existing containers asynchronously, updating the containers model
+void DistroboxManager::refreshContainers()
+{
+    if (!EngineProbe::instance()->isEngineAvailable()) {
+        setContainers({});
+        return;
     }
 
-    const QString cacheDirectory = ensureIconCacheDirectory(container);
-    if (cacheDirectory.isEmpty()) {
-        iconCache.insert(cacheKey, QString());
-        return {};
-    }
+    QElapsedTimer timer;
+    timer.start();
 
-    const QFileInfo iconInfo(iconPath);
-    QString localName = basename;
-    if (localName.isEmpty()) {
-        localName = iconInfo.completeBaseName();
-    }
+    // Prefer the engine's REST API, the CLI stays as fallback when the socket is unreachable
+    if (auto *api = EngineApiClient::instance()) {
+        EngineApiClient::onFinished(api->listContainers(), this, [this, timer](const ApiResponse &response) {
+            if (!response.success()) {
+                refreshContainersWithCli(timer);
+                return;
+            }
 
-    QString suffix = iconInfo.suffix();
-    if (suffix.isEmpty()) {
-        suffix = QStringLiteral("png");
+            const auto containers = EngineApiClient::parseContainers(response.json());
+            qDebug() << "Refreshed" << containers.size() << "containers through the engine API in" << timer.elapsed() << "ms";
+            setContainers(containers);
+        });
+        return;
     }
 
-    const QString localPath = QDir(cacheDirectory).filePath(localName + QLatin1Char('.') + suffix);
-
-    if (!QFile::exists(localPath)) {
-        const QString pythonScript = QStringLiteral(
-                                         "python3 - %1 <<'PY'\n"
-                                         "import base64, sys\n"
-                                         "path = sys.argv[1]\n"
-                                         "with open(path, 'rb') as handler:\n"
-                                         "    data = handler.read()\n"
-                                         "    print(base64.b64encode(data).decode('ascii'), end=\"\")\n"
-                                         "PY")
-                                         .arg(KShell::quoteArg(iconPath));
+    refreshContainersWithCli(timer);
+}
 
-        bool success = false;
-        const QString base64Data = runContainerCommand(container, pythonScript, success);
-        if (!success || base64Data.isEmpty()) {
-            iconCache.insert(cacheKey, QString());
-            return {};
+void DistroboxManager::refreshContainersWithCli(const QElapsedTimer &timer)
+{
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(DistroboxCli::containersCommand());
+    CommandExecutor::onFinished(future, this, [this, timer](const CommandResult &result) {
+        if (!result.success()) {
+            setContainers({});
+            return;
         }
 
-        const QByteArray binaryData = QByteArray::fromBase64(base64Data.trimmed().toUtf8());
-        if (binaryData.isEmpty()) {
-            iconCache.insert(cacheKey, QString());
-            return {};
+        const auto containers = DistroboxCli::parseContainers(result.text());
+        qDebug() << "Refreshed" << containers.size() << "containers in" << timer.elapsed() << "ms";
+        setContainers(containers);
+    });
+}
+
+bool DistroboxManager::isWatchingContainerEvents() const
+{
+    return m_eventWatcher->isActive();
+}
+
+ContainerListModel *DistroboxManager::containerModel() const
+{
+    return m_containerModel;
+}
+
+UpgradeScheduler *DistroboxManager::upgradeScheduler() const
+{
+    return m_upgradeScheduler;
+}
+
+ContainerMetrics *DistroboxManager::containerMetrics() const
+{
+    return m_containerMetrics;
+}
+
+DiskUsage *DistroboxManager::diskUsage() const
+{
+    return m_diskUsage;
+}
+
+void DistroboxManager::setContainers(const QList<DistroboxCli::ContainerInfo> &containers)
+{
+    m_containers = containers;
+    m_diskUsage->apply(m_containers);
+    m_containerModel->setContainers(m_containers);
+    m_diskUsage->update(m_containers);
+    Q_EMIT containersRefreshed();
+}
+
+qsizetype DistroboxManager::containerIndex(const QString &id) const
+{
+    for (qsizetype i = 0; i < m_containers.size(); ++i) {
+        if (m_containers.at(i).id == id) {
+            return i;
         }
+    }
+    return -1;
+}
 
-        QFile localFile(localPath);
-        if (!localFile.open(QIODevice::WriteOnly)) {
-            iconCache.insert(cacheKey, QString());
-            return {};
+QString DistroboxManager::containerId(const QString &name) const
+{
+    for (const DistroboxCli::ContainerInfo &container : m_containers) {
+        if (container.name == name) {
+            return container.id;
         }
+    }
+    return {};
+}
+
+void DistroboxManager::handleContainerCreated(const QString &id, const QString &name, const QString &image, const QHash<QString, QString> &attributes)
+{
+    // Engines that don't report labels with their events need a full listing to tell distrobox containers apart
+    if (attributes.isEmpty()) {
+        refreshContainers();
+        return;
+    }
 
-        localFile.write(binaryData);
-        localFile.close();
+    if (attributes.value(u"manager"_s) != QLatin1String("distrobox") || containerIndex(id) >= 0) {
+        return;
     }
 
-    const QString url = QUrl::fromLocalFile(localPath).toString();
-    iconCache.insert(cacheKey, url);
-    return url;
+    // A container of the same name may have existed before
+    ContainerFilesystem::invalidate(name);
+
+    DistroboxCli::ContainerInfo info;
+    info.id = id;
+    info.name = name;
+    info.image = image;
+    info.status = u"Created"_s;
+    info.created = QDateTime::currentDateTime();
+    m_containers.append(info);
+    m_containerModel->insertOrUpdate(info);
+    m_diskUsage->update(m_containers);
+
+    Q_EMIT containerAdded(name);
+    Q_EMIT containersRefreshed();
 }
+
+void DistroboxManager::handleContainerStatus(const QString &id, const QString &status)
+{
+    const qsizetype index = containerIndex(id);
+    if (index < 0 || m_containers.at(index).status == status) {
+        return;
+    }
+
+    m_containers[index].status = status;
+    m_containerModel->insertOrUpdate(m_containers.at(index));
+    m_diskUsage->update(m_containers);
+    Q_EMIT containerStatusChanged(m_containers.at(index).name, status);
+    Q_EMIT containersRefreshed();
 }
 
-// Constructor: Initializes the manager and populates available images lists
-DistroboxManager::DistroboxManager(QObject *parent)
-    : QObject(parent)
+void DistroboxManager::handleContainerRemoved(const QString &id)
 {
-    const auto images = DistroboxCli::availableImages();
-    m_availableImages = images.displayNames;
-    m_fullImageNames = images.fullNames;
+    const qsizetype index = containerIndex(id);
+    if (index < 0) {
+        return;
+    }
+
+    const QString name = m_containers.takeAt(index).name;
+    m_containerModel->remove(id);
+    m_diskUsage->update(m_containers);
+    ContainerFilesystem::invalidate(name);
+    ApplicationCatalog::removeCache(name);
+    IconCache::instance()->purgeContainer(name);
+    dropApplicationModels(name);
+    Q_EMIT containerRemoved(name);
+    Q_EMIT containersRefreshed();
 }
 
-// Lists all existing containers and their base images in JSON format
-QString DistroboxManager::listContainers()
+void DistroboxManager::handleContainerRenamed(const QString &id, const QString &newName)
 {
-    return DistroboxCli::containersJson();
+    const qsizetype index = containerIndex(id);
+    if (index < 0 || newName.isEmpty() || m_containers.at(index).name == newName) {
+        return;
+    }
+
+    const QString oldName = m_containers.at(index).name;
+    m_containers[index].name = newName;
+    m_containerModel->insertOrUpdate(m_containers.at(index));
+    ContainerFilesystem::invalidate(oldName);
+    ContainerFilesystem::invalidate(newName);
+    ApplicationCatalog::removeCache(oldName);
+    dropApplicationModels(oldName);
+    Q_EMIT containerRenamed(oldName, newName);
+    Q_EMIT containersRefreshed();
 }
 
 // Lists all available container images in JSON format
 QString DistroboxManager::listAvailableImages()
 {
-    if (m_availableImages.isEmpty() || m_fullImageNames.isEmpty()) {
-        const auto images = DistroboxCli::availableImages();
+    if (!m_availableImagesLoaded) {
+        loadAvailableImages();
+    }
+
+    return DistroboxCli::availableImagesJson(DistroboxCli::AvailableImages{m_availableImages, m_fullImageNames});
+}
+
+bool DistroboxManager::isLoadingAvailableImages() const
+{
+    return m_loadingAvailableImages;
+}
+
+void DistroboxManager::loadAvailableImages()
+{
+    m_availableImagesLoaded = true;
+
+    const std::optional<ImageCatalog::Cached> cached = ImageCatalog::load();
+    if (cached) {
+        m_availableImages = cached->images.displayNames;
+        m_fullImageNames = cached->images.fullNames;
+        qDebug() << "Loaded" << m_availableImages.size() << "available images fetched" << cached->fetched.toLocalTime().toString(Qt::ISODate);
+    }
+
+    if (!cached || cached->isStale()) {
+        fetchAvailableImages();
+    }
+}
+
+void DistroboxManager::fetchAvailableImages()
+{
+    if (m_loadingAvailableImages) {
+        return;
+    }
+    m_loadingAvailableImages = true;
+    Q_EMIT loadingAvailableImagesChanged();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(DistroboxCli::availableImagesCommand(), AvailableImagesTimeout);
+    CommandExecutor::onFinished(future, this, [this, timer](const CommandResult &result) {
+        m_loadingAvailableImages = false;
+        Q_EMIT loadingAvailableImagesChanged();
+
+        const DistroboxCli::AvailableImages images = result.success() ? DistroboxCli::parseAvailableImages(result.text()) : DistroboxCli::AvailableImages();
+        if (images.fullNames.isEmpty()) {
+            qWarning() << "Could not list the available images" << QString::fromUtf8(result.errorOutput).trimmed();
+            return;
+        }
+
+        qDebug() << "Fetched" << images.fullNames.size() << "available images in" << timer.elapsed() << "ms";
+        ImageCatalog::save(images);
+
+        if (images.displayNames == m_availableImages && images.fullNames == m_fullImageNames) {
+            return;
+        }
         m_availableImages = images.displayNames;
         m_fullImageNames = images.fullNames;
+        Q_EMIT availableImagesChanged(DistroboxCli::availableImagesJson(images));
+    });
+}
+
+void DistroboxManager::runContainerOperation(const QString &name,
+                                             const QString &operation,
+                                             const QString &command,
+                                             int timeoutMs,
+                                             const std::function<QFuture<ApiResponse>(EngineApiClient *)> &apiCall)
+{
+    EngineApiClient *shared = apiCall ? EngineApiClient::instance() : nullptr;
+    if (!shared) {
+        runCommandOperation(name, operation, command, timeoutMs);
+        return;
     }
 
-    return DistroboxCli::availableImagesJson(DistroboxCli::AvailableImages{m_availableImages, m_fullImageNames});
+    // Starting or stopping can take minutes, on the shared connection it would hold up every listing
+    auto *api = new EngineApiClient(shared->socketPath(), this);
+    const quint64 serial = ++m_operationSerial;
+    m_operations.insert(name, PendingOperation{serial, {}, api});
+
+    EngineApiClient::onFinished(apiCall(api), this, [this, name, operation, command, timeoutMs, serial, api](const ApiResponse &response) {
+        auto it = m_operations.find(name);
+        if (it != m_operations.end() && it->serial == serial) {
+            m_operations.erase(it);
+        }
+        api->deleteLater();
+
+        if (response.canceled) {
+            Q_EMIT containerOperationFinished(name, operation, false);
+            return;
+        }
+
+        if (!response.reachable()) {
+            runCommandOperation(name, operation, command, timeoutMs);
+            return;
+        }
+
+        if (!response.success()) {
+            qWarning() << "Container" << operation << "failed for" << name << response.statusCode << response.body.trimmed();
+        }
+        Q_EMIT containerOperationFinished(name, operation, response.success());
+    });
+}
+
+void DistroboxManager::runCommandOperation(const QString &name, const QString &operation, const QString &command, int timeoutMs)
+{
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(command, timeoutMs);
+    const quint64 serial = ++m_operationSerial;
+    m_operations.insert(name, PendingOperation{serial, future});
+
+    CommandExecutor::onFinished(future, this, [this, name, operation, serial](const CommandResult &result) {
+        // Only forget the operation if it wasn't superseded by a newer one
+        auto it = m_operations.find(name);
+        if (it != m_operations.end() && it->serial == serial) {
+            m_operations.erase(it);
+        }
+
+        if (!result.success()) {
+            qWarning() << "Container" << operation << "failed for" << name << (result.timedOut ? "(timed out)" : "")
+                       << QString::fromUtf8(result.errorOutput).trimmed();
+        }
+
+        Q_EMIT containerOperationFinished(name, operation, result.success());
+    });
 }
 
 // Creates a new container with specified name and base image
-bool DistroboxManager::createContainer(const QString &name, const QString &image, const QString &args)
+ContainerCreateJob *DistroboxManager::createContainer(const QString &name, const QString &image, const QString &args)
 {
     // Construct distrobox create command
     QString command = u"distrobox create --name %1 --image %2 --yes"_s.arg(name, image);
@@ -246,9 +535,43 @@ bool DistroboxManager::createContainer(const QString &name, const QString &image
         command += QLatin1Char(' ') + args;
     }
 
-    bool success;
-    DistroboxCli::runCommand(command, success);
-    return success;
+    ContainerFilesystem::invalidate(name);
+
+    // Image pulls can legitimately take a long time, so rely on cancellation instead of a timeout
+    auto *job = new ContainerCreateJob(name, image, command, this);
+    m_createJobs.insert(name, job);
+    connect(job, &ContainerCreateJob::finished, this, [this, name, job](bool success) {
+        if (m_createJobs.value(name) == job) {
+            m_createJobs.remove(name);
+        }
+        if (!success) {
+            qWarning() << "Container create failed for" << name << job->lastLine();
+        }
+        Q_EMIT containerOperationFinished(name, u"create"_s, success);
+        job->deleteLater();
+    });
+    job->start();
+    return job;
+}
+
+ImagePull *DistroboxManager::prepullImage(const QString &image)
+{
+    const QString trimmedImage = image.trimmed();
+    if (!m_prepullImage.isEmpty() && ImagePuller::normalizedReference(m_prepullImage) != ImagePuller::normalizedReference(trimmedImage)) {
+        ImagePuller::instance()->release(m_prepullImage, this);
+    }
+
+    m_prepullImage = trimmedImage;
+    if (trimmedImage.isEmpty()) {
+        return nullptr;
+    }
+
+    // Holding it again is a no-op, the dialog may ask for the same image repeatedly
+    ImagePull *pull = ImagePuller::instance()->pull(trimmedImage, this);
+    if (!pull) {
+        m_prepullImage.clear();
+    }
+    return pull;
 }
 
 // Opens an interactive shell in the specified container
@@ -259,40 +582,59 @@ bool DistroboxManager::enterContainer(const QString &name)
 }
 
 // Removes a container
-bool DistroboxManager::removeContainer(const QString &name)
+void DistroboxManager::removeContainer(const QString &name)
 {
+    // An open session would keep the container busy
+    ShellSession::closeContainerSession(name);
+    ContainerFilesystem::invalidate(name);
+    ApplicationCatalog::removeCache(name);
+
     // Use -f flag to force removal without confirmation
-    QString command = u"distrobox rm -f %1"_s.arg(name);
-    bool success;
-    DistroboxCli::runCommand(command, success);
-    return success;
+    runContainerOperation(name, u"remove"_s, u"distrobox rm -f %1"_s.arg(name), ContainerOperationTimeout);
 }
 
 // Starts a stopped container
-bool DistroboxManager::startContainer(const QString &name)
+void DistroboxManager::startContainer(const QString &name)
 {
-    QString command = u"podman start %1"_s.arg(name);
-    bool success;
-    DistroboxCli::runCommand(command, success);
-    return success;
+    runContainerOperation(name, u"start"_s, u"podman start %1"_s.arg(name), ContainerOperationTimeout, [name](EngineApiClient *api) {
+        return api->startContainer(name);
+    });
 }
 
 // Stops a running container
-bool DistroboxManager::stopContainer(const QString &name)
+void DistroboxManager::stopContainer(const QString &name)
 {
-    QString command = u"distrobox-stop %1 -Y"_s.arg(name);
-    bool success;
-    DistroboxCli::runCommand(command, success);
-    return success;
+    ShellSession::closeContainerSession(name);
+    runContainerOperation(name, u"stop"_s, u"distrobox-stop %1 -Y"_s.arg(name), ContainerOperationTimeout, [name](EngineApiClient *api) {
+        return api->stopContainer(name);
+    });
 }
 
 // Reboots a container (stop then start)
-bool DistroboxManager::rebootContainer(const QString &name)
+void DistroboxManager::rebootContainer(const QString &name)
 {
-    QString command = u"distrobox-stop %1 -Y && podman start %1"_s.arg(name);
-    bool success;
-    DistroboxCli::runCommand(command, success);
-    return success;
+    ShellSession::closeContainerSession(name);
+    runContainerOperation(name, u"reboot"_s, u"distrobox-stop %1 -Y && podman start %1"_s.arg(name), ContainerOperationTimeout);
+}
+
+// Cancels the pending operation of a container, if any
+void DistroboxManager::cancelOperation(const QString &name)
+{
+    if (const QPointer<ContainerCreateJob> job = m_createJobs.value(name)) {
+        job->cancel();
+        return;
+    }
+
+    auto it = m_operations.find(name);
+    if (it == m_operations.end()) {
+        return;
+    }
+
+    if (it->api) {
+        it->api->cancelAll();
+    } else {
+        it->future.cancel();
+    }
 }
 
 // Clone a container to a user-provided name
@@ -332,6 +674,9 @@ bool DistroboxManager::assembleContainer(const QString &iniFile)
         trimmedFile = trimmedFile.mid(7);
     }
 
+    // The portal path stays readable from inside the sandbox, the host path is for distrobox
+    const QString portalFile = trimmedFile;
+
     // Resolve potential portal FUSE path to actual host path
     trimmedFile = resolveDocumentPortalPath(trimmedFile);
 
@@ -349,7 +694,39 @@ bool DistroboxManager::assembleContainer(const QString &iniFile)
         Q_EMIT self->containerAssembleFinished(success);
     };
 
-    return launchCommandInTerminal(command, QDir::homePath(), callback);
+    // Pull the images first through the shared puller, which also joins pulls the create
+    // dialog already started. distrobox then finds them in place.
+    const QStringList images = manifestImages(portalFile);
+    auto *holder = new QObject(this);
+    QList<ImagePull *> pulls;
+    for (const QString &image : images) {
+        if (ImagePull *pull = ImagePuller::instance()->pull(image, holder)) {
+            if (!pull->isFinished()) {
+                pulls.append(pull);
+            }
+        }
+    }
+
+    if (pulls.isEmpty()) {
+        holder->deleteLater();
+        return launchCommandInTerminal(command, QDir::homePath(), callback);
+    }
+
+    // A failed pull is left to distrobox, which reports it in the terminal
+    qDebug() << "Assembling" << trimmedFile << "after pulling" << pulls.size() << "of" << images.size() << "images";
+    Q_EMIT containerAssemblePulling(images);
+    auto remaining = std::make_shared<int>(int(pulls.size()));
+    for (ImagePull *pull : std::as_const(pulls)) {
+        connect(pull, &ImagePull::finished, holder, [this, holder, remaining, command, callback]() {
+            if (--*remaining > 0) {
+                return;
+            }
+            holder->deleteLater();
+            // A terminal that fails to start reports through the callback as well
+            launchCommandInTerminal(command, QDir::homePath(), callback);
+        });
+    }
+    return true;
 }
 
 // Upgrades all packages in a container
@@ -362,13 +739,14 @@ bool DistroboxManager::upgradeContainer(const QString &name)
     return launchCommandInTerminal(command);
 }
 
-bool DistroboxManager::upgradeAllContainer()
+void DistroboxManager::upgradeAllContainers()
 {
-    QString message = i18n("Press any key to close this terminal…");
-    QString upgradeCmd = u"distrobox upgrade --all && echo '' && echo '%1' && read -s -n 1"_s.arg(message);
-    QString command = u"sh -c \"%1\""_s.arg(upgradeCmd);
-
-    return launchCommandInTerminal(command);
+    // distrobox upgrade --all would go through the containers one after the other
+    QStringList names;
+    for (const DistroboxCli::ContainerInfo &container : m_containerModel->rows()) {
+        names << container.name;
+    }
+    m_upgradeScheduler->upgrade(names);
 }
 
 bool DistroboxManager::launchCommandInTerminal(const QString &command, const QString &workingDirectory, const std::function<void(bool)> &onFinished)
@@ -383,9 +761,9 @@ QString DistroboxManager::getDistroColor(const QString &image)
 }
 
 // Returns an Icon associated with the distribution for UI purposes
-QString DistroboxManager::getDistroIcon(const QString &container)
+QString DistroboxManager::getDistroIcon(const QString &container, const QString &image)
 {
-    return DistroIcons::resolveDistroboxIcon(container);
+    return DistroIcons::resolveDistroboxIcon(container, image);
 }
 
 // Generates .desktop files for applications in containers
@@ -408,10 +786,8 @@ bool DistroboxManager::generateEntry(const QString &name)
 // Installs a Package File with the Containers Package Manager
 // Doesnt like POSIX sh and wants GNU bash for launching in the Terminal
 // TODO: Make the function use POSIX sh to increase portability
-bool DistroboxManager::installPackageInContainer(const QString &name, const QString &packagePath, const QString &image)
+void DistroboxManager::installPackageInContainer(const QString &name, const QString &packagePath, const QString &image)
 {
-    QString homeDir = QDir::homePath();
-
     // Remove "file://" prefix if present
     QString actualPackagePath = packagePath;
     if (actualPackagePath.startsWith(u"file://"_s))
@@ -420,7 +796,23 @@ bool DistroboxManager::installPackageInContainer(const QString &name, const QStr
     // Resolve document portal FUSE path to host path if needed
     actualPackagePath = resolveDocumentPortalPath(actualPackagePath);
 
-    const auto installCmd = PackageInstallCommand::forImage(image, actualPackagePath);
+    // The container's os-release knows its distribution better than the image name
+    readContainerFile(name, u"/etc/os-release"_s, this, [this, name, actualPackagePath, image](const std::optional<QByteArray> &osRelease) {
+        launchPackageInstall(name, actualPackagePath, image, osRelease);
+    });
+}
+
+bool DistroboxManager::launchPackageInstall(const QString &name, const QString &actualPackagePath, const QString &image, const std::optional<QByteArray> &osRelease)
+{
+    QString homeDir = QDir::homePath();
+
+    std::optional<QString> installCmd;
+    if (osRelease) {
+        installCmd = PackageInstallCommand::forOsRelease(*osRelease, actualPackagePath);
+    }
+    if (!installCmd) {
+        installCmd = PackageInstallCommand::forImage(image, actualPackagePath);
+    }
     if (!installCmd) {
         const QString message = i18n(
             "Cannot automatically install packages for this distribution.\n"
@@ -460,256 +852,463 @@ bool DistroboxManager::isFlatpak() const
 
 bool DistroboxManager::isContainerEngineAvailable() const
 {
-    // Check if podman is available
-    bool success = false;
-    QString podmanCheck = DistroboxCli::runCommand(QStringLiteral("which podman"), success);
-    if (success && !podmanCheck.trimmed().isEmpty()) {
-        return true;
+    // Probed once and kept current by watching PATH and the engine sockets
+    return EngineProbe::instance()->isEngineAvailable();
+}
+
+QVariantMap DistroboxManager::iconCacheStatistics() const
+{
+    return IconCache::instance()->statistics().toVariant();
+}
+
+ApplicationListModel *DistroboxManager::applicationsModel(const QString &container)
+{
+    return applicationModels(container).applications;
+}
+
+ApplicationListModel *DistroboxManager::exportedAppsModel(const QString &container)
+{
+    return applicationModels(container).exported;
+}
+
+DistroboxManager::ApplicationModels &DistroboxManager::applicationModels(const QString &container)
+{
+    ApplicationModels &models = m_applicationModels[container];
+    if (!models.applications) {
+        models.applications = new ApplicationListModel(this);
+        models.exported = new ApplicationListModel(this);
+        models.exported->setApplications(exportedApplications(container));
     }
-    
-    // Check if docker is available
-    QString dockerCheck = DistroboxCli::runCommand(QStringLiteral("which docker"), success);
-    if (success && !dockerCheck.trimmed().isEmpty()) {
-        return true;
+    return models;
+}
+
+void DistroboxManager::dropApplicationModels(const QString &container)
+{
+    const ApplicationModels models = m_applicationModels.take(container);
+    if (models.applications) {
+        models.applications->deleteLater();
+        models.exported->deleteLater();
     }
-    
-    return false;
 }
 
-QVariantList DistroboxManager::allApps(const QString &container)
+void DistroboxManager::loadApplications(const QString &container)
 {
-    qDebug() << "=== allApps for container:" << container << "===";
+    QElapsedTimer timer;
+    timer.start();
+
+    const QString locale = QLocale::system().name();
+    const QString id = containerId(container);
+
+    // Show the last known catalog right away and check it for changes in the background
+    const ApplicationModels &models = applicationModels(container);
+    models.exported->setApplications(exportedApplications(container));
+
+    if (const auto cached = ApplicationCatalog::loadCache(container, id, locale)) {
+        models.applications->setApplications(applicationList(container, *cached));
+        qDebug() << "Served" << models.applications->count() << "cached apps of" << container << "in" << timer.elapsed() << "ms";
+        Q_EMIT applicationsLoaded(container);
+        revalidateApplications(container, *cached);
+        return;
+    }
 
-    QString findCmd = QStringLiteral("find /usr/share/applications -type f -name '*.desktop' ! -exec grep -q '^NoDisplay=true' {} \\; -print");
-    QString output = u"distrobox enter %1 -- sh -c %2"_s.arg(container, KShell::quoteArg(findCmd));
-    bool success = false;
-    QString raw = DistroboxCli::runCommand(output, success);
-    QVariantList list;
-    if (!success) {
-        qDebug() << "Find command failed for container:" << container;
-        return list;
+    // Read the desktop files from the host when the container's layers are accessible,
+    // so the container doesn't even have to be running
+    QList<ApplicationCatalog::Entry> entries;
+    const ContainerFilesystem filesystem = ContainerFilesystem::forContainer(container);
+    if (const auto scanned = ApplicationCatalog::scanFilesystem(filesystem, locale)) {
+        entries = *scanned;
+        qDebug() << "Read" << entries.size() << "desktop files from the container filesystem in" << timer.elapsed() << "ms";
+    } else {
+        // One scan of every applications directory through the container's shell, parsed as the records arrive
+        scanApplications(container, filesystem.dataDirectories());
+        return;
     }
 
-    for (const QString &line : raw.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts)) {
-        if (!line.endsWith(QStringLiteral(".desktop"))) {
-            continue;
-        }
+    ApplicationCatalog::saveCache(container, id, locale, entries);
 
-        // Extract basename from the full path
-        QString basename = line;
-        if (basename.startsWith(QStringLiteral("/usr/share/applications/"))) {
-            basename.remove(0, 24);
-        }
-        if (basename.endsWith(QStringLiteral(".desktop"))) {
-            basename.chop(8);
-        }
+    models.applications->setApplications(applicationList(container, entries));
+    qDebug() << "Total apps found:" << models.applications->count() << "in" << timer.elapsed() << "ms";
+    Q_EMIT applicationsLoaded(container);
+}
 
-        // Read desktop file from container
-        QString readCmd = QStringLiteral("cat %1").arg(KShell::quoteArg(line));
-        QString desktopOutput = u"distrobox enter %1 -- sh -c %2"_s.arg(container, KShell::quoteArg(readCmd));
-        bool readSuccess = false;
-        QString desktopContent = DistroboxCli::runCommand(desktopOutput, readSuccess);
+void DistroboxManager::scanApplications(const QString &container, const QStringList &dataDirectories)
+{
+    const QString locale = QLocale::system().name();
+    const QString id = containerId(container);
 
-        if (!readSuccess) {
-            continue;
+    struct Scan {
+        ApplicationCatalog::Parser parser;
+        QList<ApplicationCatalog::Entry> entries;
+        QElapsedTimer timer;
+    };
+    const auto scan = std::make_shared<Scan>();
+    scan->timer.start();
+
+    const QFuture<CommandResult> future = ShellSession::forContainer(container)->run(ApplicationCatalog::scanScript(locale, dataDirectories),
+                                                                                     CommandExecutor::DefaultTimeout,
+                                                                                     [scan](const QByteArray &chunk) {
+                                                                                         scan->entries += scan->parser.feed(chunk);
+                                                                                     });
+    CommandExecutor::onFinished(future, this, [this, container, id, locale, scan](const CommandResult &result) {
+        scan->entries += scan->parser.finish();
+
+        // A window may have dropped the models in the meantime, e.g. because the container was removed
+        if (!m_applicationModels.contains(container)) {
+            Q_EMIT applicationsLoaded(container);
+            return;
         }
+        ApplicationListModel *applications = m_applicationModels.value(container).applications;
 
-        // Parse desktop file content with proper localization handling
-        QVariantMap app;
-        app[QStringLiteral("basename")] = basename;
+        if (!result.success()) {
+            qDebug() << "Application scan failed for container:" << container << QString::fromUtf8(result.errorOutput).trimmed();
+            applications->setApplications({});
+            Q_EMIT applicationsLoaded(container);
+            return;
+        }
 
-        QString name = basename;
-        QString icon;
-        QString genericName; // For debugging
+        qDebug() << "Scanned" << scan->entries.size() << "desktop files in" << scan->timer.elapsed() << "ms";
+        ApplicationCatalog::saveCache(container, id, locale, scan->entries);
+        applications->setApplications(applicationList(container, scan->entries));
+        Q_EMIT applicationsLoaded(container);
+    });
+}
 
-        // Prefer English name, fall back to generic name
-        QString englishName;
+QList<ApplicationListModel::Application> DistroboxManager::applicationList(const QString &container, const QList<ApplicationCatalog::Entry> &entries)
+{
+    QList<ApplicationListModel::Application> list;
+    list.reserve(entries.size());
 
-        for (const QString &desktopLine : desktopContent.split(QChar::fromLatin1('\n'), Qt::SkipEmptyParts)) {
-            if (desktopLine.startsWith(QStringLiteral("Name[en]="))) {
-                englishName = desktopLine.mid(8); // Remove "Name[en]="
-            } else if (desktopLine.startsWith(QStringLiteral("Name=")) && name == basename) {
-                name = desktopLine.mid(5); // Remove "Name=" (only use as fallback)
-            } else if (desktopLine.startsWith(QStringLiteral("Icon="))) {
-                icon = desktopLine.mid(5); // Remove "Icon="
-            } else if (desktopLine.startsWith(QStringLiteral("GenericName="))) {
-                genericName = desktopLine.mid(12); // For debugging
-            }
-        }
+    const QHash<QString, HostDesktopIndex::Entry> exports = HostDesktopIndex::instance()->exportsOf(container);
 
-        // Prefer English name if available
-        if (!englishName.isEmpty()) {
-            name = englishName;
+    QHash<QString, QString> &desktopFiles = m_desktopFiles[container];
+    desktopFiles.clear();
+
+    QStringList icons;
+    for (const ApplicationCatalog::Entry &entry : entries) {
+        if (entry.isVisibleApplication()) {
+            icons << entry.icon;
         }
+    }
+
+    // Rows are published with the icons already cached, the others follow once fetched
+    QStringList missingIcons;
+    const QHash<QString, QString> iconSources = ContainerIcons::cachedIcons(container, icons, &missingIcons);
+    fetchApplicationIcons(container, missingIcons);
 
-        app[QStringLiteral("name")] = name;
-        app[QStringLiteral("icon")] = icon;
-        app[QStringLiteral("genericName")] = genericName; // For debugging
-        app[QStringLiteral("sourceFile")] = line; // For debugging
+    for (const ApplicationCatalog::Entry &entry : entries) {
+        desktopFiles.insert(entry.basename, entry.path);
+        if (!entry.isVisibleApplication()) {
+            continue;
+        }
 
-        const QString iconSource = cacheIconFromContainer(container, basename, icon);
-        if (!iconSource.isEmpty()) {
-            app[QStringLiteral("iconSource")] = iconSource;
+        ApplicationListModel::Application app;
+        app.basename = entry.basename;
+        app.name = entry.displayName();
+        app.icon = entry.icon;
+        if (iconSources.contains(entry.icon)) {
+            app.iconSource = IconImageProvider::containerIconUrl(container, entry.icon);
         }
+        app.exported = exports.contains(entry.basename);
 
-        qDebug() << "App:" << name << "| Basename:" << basename << "| Generic:" << genericName << "| Source:" << line;
         list << app;
     }
 
-    qDebug() << "Total apps found:" << list.size();
     return list;
 }
 
-QVariantList DistroboxManager::exportedApps(const QString &container)
+void DistroboxManager::fetchApplicationIcons(const QString &container, const QStringList &icons)
 {
-    QVariantList list;
-    bool isFlatpakRuntime = DistroboxCli::isFlatpak();
-    QStringList searchPaths;
+    ContainerIcons::fetchIcons(container, icons, this, [this, container](const QHash<QString, QString> &sources) {
+        // A window may have dropped the models in the meantime
+        if (sources.isEmpty() || !m_applicationModels.contains(container)) {
+            return;
+        }
 
-    if (isFlatpakRuntime) {
-        // Flatpak build only has read access to the host exports directory
-        searchPaths = {QDir::homePath() + QStringLiteral("/.local/share/applications")};
-    } else {
-        searchPaths = {QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation)};
+        ApplicationListModel *applications = m_applicationModels.value(container).applications;
+        const QList<ApplicationListModel::Application> rows = applications->rows();
+        for (ApplicationListModel::Application app : rows) {
+            if (app.iconSource.isEmpty() && sources.contains(app.icon)) {
+                app.iconSource = IconImageProvider::containerIconUrl(container, app.icon);
+                applications->insertOrUpdate(app);
+            }
+        }
+    });
+}
+
+void DistroboxManager::revalidateApplications(const QString &container, const QList<ApplicationCatalog::Entry> &known)
+{
+    if (m_revalidatingApplications.contains(container)) {
+        return;
     }
+    m_revalidatingApplications.insert(container);
 
-    QStringList patterns;
-    patterns << QStringLiteral("%1-*.desktop").arg(container);
+    const QString locale = QLocale::system().name();
+    const QString id = containerId(container);
+    QElapsedTimer timer;
+    timer.start();
 
-    for (const QString &searchPath : searchPaths) {
-        QDir dir(searchPath);
-        if (!dir.exists()) {
-            continue;
+    QPointer<DistroboxManager> self(this);
+    auto finish = [self, container, id, locale, known, timer](const std::optional<QList<ApplicationCatalog::Entry>> &entries) {
+        if (!self) {
+            return;
         }
+        self->m_revalidatingApplications.remove(container);
 
-        for (const QFileInfo &file : dir.entryInfoList(patterns, QDir::Files)) {
-            QString fileName = file.fileName();
-            if (!fileName.endsWith(QStringLiteral(".desktop"))) {
-                continue;
-            }
+        if (!entries) {
+            qDebug() << "Could not revalidate the applications of" << container << "- keeping the cached catalog";
+            return;
+        }
+        if (*entries == known) {
+            qDebug() << "Cached applications of" << container << "are current, checked in" << timer.elapsed() << "ms";
+            return;
+        }
 
-            // Skip clone files explicitly
-            if (fileName.endsWith(QStringLiteral("clone.desktop"), Qt::CaseInsensitive)
-                || fileName.contains(QStringLiteral("-clone.desktop"), Qt::CaseInsensitive)) {
-                continue;
-            }
+        ApplicationCatalog::saveCache(container, id, locale, *entries);
+        qDebug() << "Applications of" << container << "changed, rescanned in" << timer.elapsed() << "ms";
+        // A window may have dropped the models in the meantime, e.g. because the container was removed
+        if (self->m_applicationModels.contains(container)) {
+            self->applicationModels(container).applications->setApplications(self->applicationList(container, *entries));
+        }
+    };
 
-            // Extract basename from filename
-            QString prefix = container + QLatin1String("-");
-            QString basename = fileName;
-            if (basename.startsWith(prefix)) {
-                basename.remove(0, prefix.length());
-            }
-            if (basename.endsWith(QStringLiteral(".desktop"))) {
-                basename.chop(8);
-            }
+    // Stat every desktop file on the host and parse only the changed ones, off the GUI thread
+    const ContainerFilesystem filesystem = ContainerFilesystem::forContainer(container);
+    if (filesystem.isValid()) {
+        QThreadPool::globalInstance()->start([filesystem, locale, known, finish]() {
+            const std::optional<QList<ApplicationCatalog::Entry>> entries = ApplicationCatalog::scanFilesystem(filesystem, locale, known);
+            QMetaObject::invokeMethod(
+                QCoreApplication::instance(),
+                [finish, entries]() {
+                    finish(entries);
+                },
+                Qt::QueuedConnection);
+        });
+        return;
+    }
 
-            // Skip if we already found this app
-            bool alreadyExists = false;
-            for (const QVariant &existingApp : list) {
-                QVariantMap existingMap = existingApp.toMap();
-                if (existingMap[QStringLiteral("basename")].toString() == basename) {
-                    alreadyExists = true;
-                    break;
-                }
-            }
-            if (alreadyExists) {
-                continue;
-            }
+    // The container only sends full records for desktop files that changed since the cached scan
+    const QFuture<CommandResult> future = ShellSession::forContainer(container)->run(ApplicationCatalog::scanScript(locale, filesystem.dataDirectories(), known));
+    CommandExecutor::onFinished(future, this, [container, finish, known](const CommandResult &result) {
+        if (!result.success()) {
+            qWarning() << "Application revalidation failed for" << container << "with exit code" << result.exitCode
+                       << QString::fromUtf8(result.errorOutput).trimmed();
+            finish(std::nullopt);
+            return;
+        }
 
-            QSettings desktop(file.filePath(), QSettings::IniFormat);
-            QVariantMap app;
-            app[QStringLiteral("basename")] = basename;
+        ApplicationCatalog::Parser parser;
+        QList<ApplicationCatalog::Entry> scanned = parser.feed(result.output);
+        scanned += parser.finish();
+        finish(ApplicationCatalog::mergeUnchanged(scanned, known));
+    });
+}
 
-            QString fullName = desktop.value(QStringLiteral("Desktop Entry/Name"), basename).toString();
-            QString icon = desktop.value(QStringLiteral("Desktop Entry/Icon"), QString()).toString();
+QList<ApplicationListModel::Application> DistroboxManager::exportedApplications(const QString &container) const
+{
+    QList<ApplicationListModel::Application> list;
 
-            app[QStringLiteral("name")] = fullName.section(QStringLiteral(" (on "), 0, 0);
-            app[QStringLiteral("icon")] = icon;
+    const QHash<QString, HostDesktopIndex::Entry> exports = HostDesktopIndex::instance()->exportsOf(container);
+    QStringList basenames = exports.keys();
+    basenames.sort();
 
-            qDebug() << "Exported app:" << app[QStringLiteral("name")].toString() << "| Basename:" << basename << "| File:" << fileName;
-            list << app;
-        }
+    for (const QString &basename : std::as_const(basenames)) {
+        const HostDesktopIndex::Entry &entry = exports[basename];
+        const QString fullName = entry.name.isEmpty() ? basename : entry.name;
+
+        ApplicationListModel::Application app;
+        app.basename = basename;
+        app.name = fullName.section(QStringLiteral(" (on "), 0, 0);
+        app.icon = entry.icon;
+        app.exported = true;
+        list << app;
     }
 
     return list;
 }
 
+void DistroboxManager::refreshExportedApps()
+{
+    for (auto it = m_applicationModels.constBegin(); it != m_applicationModels.constEnd(); ++it) {
+        const QList<ApplicationListModel::Application> exported = exportedApplications(it.key());
+        it->exported->setApplications(exported);
+
+        QSet<QString> basenames;
+        for (const ApplicationListModel::Application &app : exported) {
+            basenames.insert(app.basename);
+        }
+        it->applications->updateExported(basenames);
+    }
+}
+
 bool DistroboxManager::exportApp(const QString &basename, const QString &container)
 {
-    // Construct the full path to the desktop file in the container
-    QString desktopPath = QStringLiteral("/usr/share/applications/") + basename + QStringLiteral(".desktop");
-    QString command = u"distrobox enter %1 -- distrobox-export --app %2"_s.arg(KShell::quoteArg(container), KShell::quoteArg(desktopPath));
+    QString command = u"distrobox-export --app %1"_s.arg(KShell::quoteArg(desktopFilePath(basename, container)));
 
     bool success;
-    QString output = DistroboxCli::runCommand(command, success);
+    QString output = runContainerCommand(container, command, success);
 
     qDebug() << "Export" << basename << ":" << (success ? "SUCCESS" : "FAILED") << "Output:" << output;
+
+    if (success) {
+        applyExportState(basename, container, true);
+    }
     return success;
 }
 
+QString DistroboxManager::desktopFilePath(const QString &basename, const QString &container) const
+{
+    // Use the desktop file found by the last scan, it isn't necessarily in /usr/share/applications
+    const QString path = m_desktopFiles.value(container).value(basename);
+    return path.isEmpty() ? u"/usr/share/applications/%1.desktop"_s.arg(basename) : path;
+}
+
+void DistroboxManager::applyExportState(const QString &basename, const QString &container, bool exported)
+{
+    // Only the affected rows change; the desktop file index catches up with the details
+    if (!m_applicationModels.contains(container)) {
+        return;
+    }
+
+    const ApplicationModels &models = applicationModels(container);
+    models.applications->setExported(basename, exported);
+    if (!exported) {
+        models.exported->remove(basename);
+    } else if (const auto app = models.applications->application(basename)) {
+        models.exported->insertOrUpdate(*app);
+    }
+}
+
 bool DistroboxManager::isAppExportedByOtherContainers(const QString &basename, const QString &excludeContainer)
 {
-    qDebug() << "Checking if" << basename << "is exported by containers other than" << excludeContainer;
+    QSet<QString> containers = HostDesktopIndex::instance()->containersExporting(basename);
+    containers.remove(excludeContainer);
 
-    bool isFlatpakRuntime = DistroboxCli::isFlatpak();
-    QStringList searchPaths;
+    qDebug() << basename << "is exported by containers other than" << excludeContainer << ":" << containers;
+    return !containers.isEmpty();
+}
 
-    if (isFlatpakRuntime) {
-        searchPaths = {QDir::homePath() + QStringLiteral("/.local/share/applications")};
-    } else {
-        searchPaths = {QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation)};
+bool DistroboxManager::unexportApp(const QString &basename, const QString &container)
+{
+    const bool success = removeExport(basename, container);
+    if (success) {
+        applyExportState(basename, container, false);
     }
+    return success;
+}
 
-    qDebug() << "Searching in paths:" << searchPaths;
+void DistroboxManager::exportApps(const QStringList &basenames, const QString &container)
+{
+    runApplicationBatch(container, u"export"_s, basenames);
+}
 
-    for (const QString &searchPath : searchPaths) {
-        QDir dir(searchPath);
-        if (!dir.exists()) {
-            qDebug() << "Search path does not exist:" << searchPath;
-            continue;
-        }
+void DistroboxManager::unexportApps(const QStringList &basenames, const QString &container)
+{
+    runApplicationBatch(container, u"unexport"_s, basenames);
+}
 
-        // Look for any desktop files that match the pattern *-{basename}.desktop
-        // but exclude the specific container we're checking against
-        QStringList nameFilters;
-        nameFilters << QStringLiteral("*-%1.desktop").arg(basename);
+void DistroboxManager::runApplicationBatch(const QString &container, const QString &operation, const QStringList &basenames)
+{
+    const bool exporting = operation == QLatin1String("export");
+
+    struct Batch {
+        QList<std::optional<bool>> results;
+        QStringList errors;
+        int done = 0;
+        QByteArray pending;
+        QElapsedTimer timer;
+    };
+    const auto batch = std::make_shared<Batch>();
+    batch->results.resize(basenames.size());
+    batch->errors.resize(basenames.size());
+    batch->timer.start();
 
-        qDebug() << "Looking for files matching pattern:" << nameFilters << "in" << searchPath;
+    const auto report = [this, container, operation, exporting, basenames, batch](qsizetype index, bool success, const QString &error = QString()) {
+        if (batch->results.at(index).has_value()) {
+            return;
+        }
+        batch->results[index] = success;
+        ++batch->done;
+        if (success) {
+            applyExportState(basenames.at(index), container, exporting);
+        } else {
+            batch->errors[index] = error;
+            qWarning() << "Failed to" << operation << basenames.at(index) << "from" << container << ":" << error;
+        }
+        Q_EMIT applicationBatchProgress(container, operation, basenames.at(index), success, batch->done, basenames.size());
+    };
 
-        QFileInfoList matchingFiles = dir.entryInfoList(nameFilters, QDir::Files);
-        qDebug() << "Found" << matchingFiles.size() << "matching files";
+    const auto finish = [this, container, operation, basenames, batch]() {
+        QVariantList results;
+        for (qsizetype i = 0; i < basenames.size(); ++i) {
+            results.append(QVariantMap{{u"basename"_s, basenames.at(i)}, {u"success"_s, batch->results.at(i).value_or(false)}, {u"error"_s, batch->errors.at(i)}});
+        }
+        qDebug() << "Batch" << operation << "of" << basenames.size() << "applications in" << container << "took" << batch->timer.elapsed() << "ms";
+        Q_EMIT applicationBatchFinished(container, operation, results);
+    };
+
+    // Every application prints "<index> <exit code> <end of stderr on one line>" as soon as it is done
+    QString script = u"err=$(mktemp) || exit 125\ntrap 'rm -f \"$err\"' EXIT\n"_s;
+    const QString reportLine = u"code=$?; printf '%s %s %s\\n' %1 \"$code\" \"$(tail -c %2 \"$err\" | tr '\\n' ' ')\"\n"_s;
+    bool queued = false;
+    for (qsizetype i = 0; i < basenames.size(); ++i) {
+        const QString &basename = basenames.at(i);
+        const QString desktopPath = KShell::quoteArg(desktopFilePath(basename, container));
+        if (exporting) {
+            script += u"distrobox-export --app %1 >/dev/null 2>\"$err\"; "_s.arg(desktopPath);
+            script += reportLine.arg(QString::number(i), QString::number(MaximumBatchErrorSize));
+            queued = true;
+        } else if (isAppExportedByOtherContainers(basename, container)) {
+            // distrobox-export --delete would take the icons the other containers still use along
+            report(i, removeExportedDesktopFile(basename, container));
+        } else {
+            script += u"{ distrobox-export --app %1 --delete || distrobox-export --app %2 --delete; } >/dev/null 2>\"$err\"; "_s.arg(KShell::quoteArg(basename), desktopPath);
+            script += reportLine.arg(QString::number(i), QString::number(MaximumBatchErrorSize));
+            queued = true;
+        }
+    }
 
-        for (const QFileInfo &file : matchingFiles) {
-            QString fileName = file.fileName();
-            qDebug() << "Examining file:" << fileName;
+    if (!queued) {
+        finish();
+        return;
+    }
 
-            // Skip clone files
-            if (fileName.endsWith(QStringLiteral("clone.desktop"), Qt::CaseInsensitive)
-                || fileName.contains(QStringLiteral("-clone.desktop"), Qt::CaseInsensitive)) {
-                qDebug() << "Skipping clone file:" << fileName;
+    const auto onOutput = [container, exporting, basenames, batch, report](const QByteArray &chunk) {
+        batch->pending += chunk;
+        qsizetype newline;
+        while ((newline = batch->pending.indexOf('\n')) >= 0) {
+            const QList<QByteArray> fields = batch->pending.left(newline).split(' ');
+            batch->pending.remove(0, newline + 1);
+            bool ok = false;
+            const qsizetype index = fields.size() >= 2 ? fields.at(0).toLongLong(&ok) : -1;
+            if (!ok || index < 0 || index >= basenames.size()) {
                 continue;
             }
 
-            // Extract container name from filename (format: container-basename.desktop)
-            QString containerFromFile = fileName;
-            containerFromFile.remove(QStringLiteral("-%1.desktop").arg(basename));
+            // As with unexportApp(), removing the desktop file is the last resort
+            const bool success = fields.at(1) == "0";
+            const QString error = QString::fromUtf8(fields.mid(2).join(' ')).simplified();
+            report(index, success || (!exporting && removeExportedDesktopFile(basenames.at(index), container)), error);
+        }
+    };
 
-            qDebug() << "Extracted container name:" << containerFromFile << "from file:" << fileName;
+    const int timeoutMs = CommandExecutor::DefaultTimeout * int(basenames.size());
+    const QFuture<CommandResult> future = ShellSession::forContainer(container)->run(script, timeoutMs, onOutput);
+    CommandExecutor::onFinished(future, this, [container, exporting, basenames, batch, report, finish](const CommandResult &result) {
+        if (!result.success()) {
+            qWarning() << "Application batch in" << container << "ended early:" << result.errorOutput.trimmed();
+        }
 
-            // If this file belongs to a different container, the app is exported by others
-            if (containerFromFile != excludeContainer) {
-                qDebug() << "Found" << basename << "exported by another container:" << containerFromFile;
-                return true;
+        // Applications the script didn't get to failed; unexports still fall back to removing the desktop file
+        for (qsizetype i = 0; i < basenames.size(); ++i) {
+            if (!batch->results.at(i).has_value()) {
+                report(i, !exporting && removeExportedDesktopFile(basenames.at(i), container), QString::fromUtf8(result.errorOutput).simplified());
             }
         }
-    }
-
-    qDebug() << "No other containers found exporting" << basename;
-    return false;
+        finish();
+    });
 }
 
-bool DistroboxManager::unexportApp(const QString &basename, const QString &container)
+bool DistroboxManager::removeExport(const QString &basename, const QString &container)
 {
     qDebug() << "=== UNEXPORT OPERATION START ===";
     qDebug() << "Attempting to unexport:" << basename << "from container:" << container;
@@ -724,46 +1323,19 @@ bool DistroboxManager::unexportApp(const QString &basename, const QString &conta
 
         // Only remove the specific container's desktop file, don't use distrobox-export --delete
         // which might remove shared icons/metadata
-        if (!DistroboxCli::isFlatpak()) {
-            QString appsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
-            QString desktopFileName = container + QLatin1String("-") + basename + QLatin1String(".desktop");
-            QString fullDesktopPath = appsPath + QLatin1String("/") + desktopFileName;
-            QFile desktopFile(fullDesktopPath);
-
-            qDebug() << "Target desktop file:" << fullDesktopPath;
-            qDebug() << "Desktop file exists:" << desktopFile.exists();
-
-            if (desktopFile.exists()) {
-                qDebug() << "Attempting manual removal of desktop file:" << desktopFileName;
-                if (desktopFile.remove()) {
-                    qDebug() << "SUCCESS: Manual removal completed successfully";
-                    qDebug() << "=== UNEXPORT OPERATION END (SUCCESS) ===";
-                    return true;
-                } else {
-                    qDebug() << "FAILURE: Manual removal failed - could not delete file";
-                    qDebug() << "=== UNEXPORT OPERATION END (FAILED) ===";
-                    return false;
-                }
-            } else {
-                qDebug() << "FAILURE: Desktop file does not exist:" << desktopFileName;
-                qDebug() << "=== UNEXPORT OPERATION END (FAILED) ===";
-                return false;
-            }
-        } else {
-            qDebug() << "FAILURE: Manual removal skipped - read-only access inside Flatpak runtime";
-            qDebug() << "=== UNEXPORT OPERATION END (FAILED) ===";
-            return false;
-        }
+        const bool removed = removeExportedDesktopFile(basename, container);
+        qDebug() << (removed ? "=== UNEXPORT OPERATION END (SUCCESS) ===" : "=== UNEXPORT OPERATION END (FAILED) ===");
+        return removed;
     } else {
         qDebug() << "DECISION: App" << basename << "is only exported by this container";
         qDebug() << "STRATEGY: Safe to use distrobox-export --delete (will remove icons/metadata)";
 
         // First try with just the basename (how distrobox-export expects it)
-        QString command = u"distrobox enter %1 -- distrobox-export --app %2 --delete"_s.arg(KShell::quoteArg(container), KShell::quoteArg(basename));
-        qDebug() << "Executing command:" << command;
+        QString command = u"distrobox-export --app %1 --delete"_s.arg(KShell::quoteArg(basename));
+        qDebug() << "Executing command in" << container << ":" << command;
 
         bool success;
-        QString output = DistroboxCli::runCommand(command, success);
+        QString output = runContainerCommand(container, command, success);
         qDebug() << "Command result - Success:" << success << "Output:" << output;
 
         if (success) {
@@ -775,11 +1347,10 @@ bool DistroboxManager::unexportApp(const QString &basename, const QString &conta
         qDebug() << "First attempt failed, trying with full path approach...";
 
         // If that fails, try with the full path
-        QString desktopPath = QStringLiteral("/usr/share/applications/") + basename + QStringLiteral(".desktop");
-        QString altCommand = u"distrobox enter %1 -- distrobox-export --app %2 --delete"_s.arg(KShell::quoteArg(container), KShell::quoteArg(desktopPath));
-        qDebug() << "Executing alternative command:" << altCommand;
+        QString altCommand = u"distrobox-export --app %1 --delete"_s.arg(KShell::quoteArg(desktopFilePath(basename, container)));
+        qDebug() << "Executing alternative command in" << container << ":" << altCommand;
 
-        output = DistroboxCli::runCommand(altCommand, success);
+        output = runContainerCommand(container, altCommand, success);
         qDebug() << "Alternative command result - Success:" << success << "Output:" << output;
 
         if (success) {
@@ -792,29 +1363,10 @@ bool DistroboxManager::unexportApp(const QString &basename, const QString &conta
         qDebug() << "Final command output:" << output;
 
         // As a last resort, try to manually remove the desktop file
-        if (!DistroboxCli::isFlatpak()) {
-            QString appsPath = QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
-            QString desktopFileName = container + QLatin1String("-") + basename + QLatin1String(".desktop");
-            QString fullDesktopPath = appsPath + QLatin1String("/") + desktopFileName;
-            QFile desktopFile(fullDesktopPath);
-
-            qDebug() << "Fallback: Target desktop file:" << fullDesktopPath;
-            qDebug() << "Fallback: Desktop file exists:" << desktopFile.exists();
-
-            if (desktopFile.exists()) {
-                qDebug() << "Fallback: Attempting manual removal of:" << desktopFileName;
-                if (desktopFile.remove()) {
-                    qDebug() << "SUCCESS: Fallback manual removal successful";
-                    qDebug() << "=== UNEXPORT OPERATION END (SUCCESS) ===";
-                    return true;
-                } else {
-                    qDebug() << "FAILURE: Fallback manual removal failed";
-                }
-            } else {
-                qDebug() << "FAILURE: Fallback - desktop file does not exist";
-            }
-        } else {
-            qDebug() << "Fallback: Manual removal skipped - read-only access inside Flatpak runtime";
+        if (removeExportedDesktopFile(basename, container)) {
+            qDebug() << "SUCCESS: Fallback manual removal successful";
+            qDebug() << "=== UNEXPORT OPERATION END (SUCCESS) ===";
+            return true;
         }
 
         qDebug() << "FAILURE: All unexport attempts exhausted";
@@ -6,11 +6,35 @@
 
 #pragma once
 
+#include "applicationcatalog.h"
+#include "applicationlistmodel.h"
+#include "commandexecutor.h"
+#include "containercreatejob.h"
+#include "containerlistmodel.h"
+#include "containermetrics.h"
+#include "diskusage.h"
+#include "distroboxcli.h"
+#include "engineapiclient.h"
+#include "imagepuller.h"
+#include "upgradescheduler.h"
+
+#include <QByteArray>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QHash>
+#include <QList>
 #include <QObject>
+#include <QPointer>
+#include <QSet>
 #include <QString>
 #include <QStringList>
+#include <QVariantList>
+#include <QVariantMap>
 #include <functional>
+#include <optional>
+
+class ContainerEventWatcher;
 
 /**
  * @class DistroboxManager
@@ -25,13 +49,46 @@ class DistroboxManager : public QObject
 {
     Q_OBJECT
 
+    /**
+     * @brief Whether container changes are followed through the engine's event stream
+     *
+     * While true the container list updates itself and callers don't need to refresh
+     * after an operation.
+     */
+    Q_PROPERTY(bool watchingContainerEvents READ isWatchingContainerEvents NOTIFY watchingContainerEventsChanged)
+
+    /**
+     * @brief Whether the list of available images is being fetched from distrobox
+     */
+    Q_PROPERTY(bool loadingAvailableImages READ isLoadingAvailableImages NOTIFY loadingAvailableImagesChanged)
+
+    /**
+     * @brief The known containers, updated row by row by refreshes and container events
+     */
+    Q_PROPERTY(ContainerListModel *containers READ containerModel CONSTANT)
+
+    /**
+     * @brief Upgrades running or done in the background, see UpgradeScheduler
+     */
+    Q_PROPERTY(UpgradeScheduler *upgrades READ upgradeScheduler CONSTANT)
+
+    /**
+     * @brief Resource usage of the running containers, see ContainerMetrics
+     */
+    Q_PROPERTY(ContainerMetrics *metrics READ containerMetrics CONSTANT)
+
+    /**
+     * @brief Storage used by the containers and their images, see DiskUsage
+     */
+    Q_PROPERTY(DiskUsage *diskUsage READ diskUsage CONSTANT)
+
 public:
     /**
      * @brief Constructs a DistroboxManager object
      * @param parent The parent QObject (optional)
      *
-     * During construction, it initializes the list of available images
-     * that can be used to create containers.
+     * Nothing is fetched during construction; the list of available images is
+     * loaded on first use, see listAvailableImages().
      */
     explicit DistroboxManager(QObject *parent = nullptr);
 
@@ -69,20 +126,62 @@ public Q_SLOTS:
      */
     QString listContainers();
 
+    /**
+     * @brief Lists all existing Distrobox containers without blocking the caller
+     *
+     * The result is applied to the containers model, containersRefreshed() tells when it's done.
+     */
+    void refreshContainers();
+
+    /**
+     * @brief Whether container changes are followed through the engine's event stream
+     */
+    bool isWatchingContainerEvents() const;
+
+    ContainerListModel *containerModel() const;
+
+    UpgradeScheduler *upgradeScheduler() const;
+
+    ContainerMetrics *containerMetrics() const;
+
+    DiskUsage *diskUsage() const;
+
     /**
      * @brief Lists all available container images
      * @return JSON string containing array of available images with display and full names
+     *
+     * Never blocks on distrobox: the list saved by an earlier run is returned, possibly
+     * empty, and fetched again in the background if it is missing or out of date.
+     * availableImagesChanged() reports the fetched list.
      */
     QString listAvailableImages();
 
+    /**
+     * @brief Whether the list of available images is being fetched from distrobox
+     */
+    bool isLoadingAvailableImages() const;
+
     /**
      * @brief Creates a new Distrobox container
      * @param name Name for the new container
      * @param image Base image to use for the container
      * @param args Additional arguments to pass to distrobox create command
-     * @return true if container creation was successful, false otherwise
+     *
+     * Runs asynchronously; completion is reported through containerOperationFinished()
+     * with the operation "create".
+     * @return Job reporting the image pull and the output of distrobox, deleted once it finished
      */
-    bool createContainer(const QString &name, const QString &image, const QString &args);
+    ContainerCreateJob *createContainer(const QString &name, const QString &image, const QString &args);
+
+    /**
+     * @brief Starts pulling an image in the background, ahead of createContainer()
+     * @param image Image to pull; an empty string just drops the previous pre-pull
+     *
+     * Only one pre-pull is held at a time, selecting another image gives up the previous
+     * one. createContainer() joins the pull instead of starting its own.
+     * @return The shared pull, nullptr if the engine API isn't reachable
+     */
+    Q_INVOKABLE ImagePull *prepullImage(const QString &image);
 
     /**
      * @brief Opens an interactive shell in the specified container
@@ -94,30 +193,40 @@ public Q_SLOTS:
     /**
      * @brief Removes a Distrobox container
      * @param name Name of the container to remove
-     * @return true if container removal was successful, false otherwise
+     *
+     * Completion is reported through containerOperationFinished() with the operation "remove".
      */
-    bool removeContainer(const QString &name);
+    void removeContainer(const QString &name);
 
     /**
      * @brief Starts a stopped Distrobox container
      * @param name Name of the container to start
-     * @return true if container start was successful, false otherwise
+     *
+     * Completion is reported through containerOperationFinished() with the operation "start".
      */
-    bool startContainer(const QString &name);
+    void startContainer(const QString &name);
 
     /**
      * @brief Stops a running Distrobox container
      * @param name Name of the container to stop
-     * @return true if container stop was successful, false otherwise
+     *
+     * Completion is reported through containerOperationFinished() with the operation "stop".
      */
-    bool stopContainer(const QString &name);
+    void stopContainer(const QString &name);
 
     /**
      * @brief Reboots a Distrobox container
      * @param name Name of the container to reboot
-     * @return true if container reboot was successful, false otherwise
+     *
+     * Completion is reported through containerOperationFinished() with the operation "reboot".
      */
-    bool rebootContainer(const QString &name);
+    void rebootContainer(const QString &name);
+
+    /**
+     * @brief Cancels the pending create/remove/start/stop/reboot operation of a container
+     * @param name Name of the container
+     */
+    void cancelOperation(const QString &name);
 
     /**
      * @brief Upgrades packages in the specified container
@@ -142,10 +251,11 @@ public Q_SLOTS:
     bool assembleContainer(const QString &iniFile);
 
     /**
-     * @brief Upgrades packages in all containers
-     * @return true if upgrades were successful, false otherwise
+     * @brief Upgrades packages in all containers, several at a time
+     *
+     * Progress and logs are reported by the upgrades model.
      */
-    bool upgradeAllContainer();
+    void upgradeAllContainers();
 
     /**
      * @brief Gets a color associated with the distribution
@@ -157,9 +267,10 @@ public Q_SLOTS:
     /**
      * @brief Gets an Icon associated with the distribution
      * @param container Container name
+     * @param image Base image name, used for the distribution's logo if the container has no icon
      * @return Icon for the distribution or generic Fallback
      */
-    QString getDistroIcon(const QString &container);
+    QString getDistroIcon(const QString &container, const QString &image = QString());
 
     /**
      * @brief Generates desktop entry files for container applications
@@ -173,9 +284,10 @@ public Q_SLOTS:
      * @param name Container name
      * @param packagePath Path to the package file to install
      * @param image Base image name (used to determine package manager)
-     * @return true if package installation was successful, false otherwise
+     *
+     * The terminal opens once the container's /etc/os-release was read.
      */
-    bool installPackageInContainer(const QString &name, const QString &packagePath, const QString &image);
+    void installPackageInContainer(const QString &name, const QString &packagePath, const QString &image);
 
     /**
      * @brief Checks if the application is running as a Flatpak
@@ -186,22 +298,46 @@ public Q_SLOTS:
     /**
      * @brief Checks if Podman or Docker is installed on the system
      * @return true if either Podman or Docker is available, false otherwise
+     *
+     * Answered from the EngineProbe cache; containerEnginesChanged() tells when it changes.
      */
     bool isContainerEngineAvailable() const;
 
     /**
-     * @brief Lists available applications inside the given container
+     * @brief Counters of the icon cache, for diagnostics
+     * @return Map with hits, misses, negativeHits, evictions, entries and bytes
+     */
+    QVariantMap iconCacheStatistics() const;
+
+    /**
+     * @brief Model of the applications installed in the given container
+     *
+     * Created empty on first use and filled by loadApplications(); the same model is
+     * returned for as long as the container exists.
+     * @param container Name of the container
+     */
+    Q_INVOKABLE ApplicationListModel *applicationsModel(const QString &container);
+
+    /**
+     * @brief Model of the applications exported from the given container
+     *
+     * Kept current as desktop files on the host change, including exports done outside
+     * Kontainer.
      * @param container Name of the container
-     * @return QVariantList of AvailableApp structs representing available applications
      */
-    Q_INVOKABLE QVariantList allApps(const QString &container);
+    Q_INVOKABLE ApplicationListModel *exportedAppsModel(const QString &container);
 
     /**
-     * @brief Lists applications exported from the given container
+     * @brief Fills the application models of the given container
+     *
+     * Every XDG applications directory of the container is scanned in a single pass;
+     * entries marked NoDisplay or Hidden are left out. Once scanned, the catalog is
+     * served from disk and revalidated in the background; changes found then are
+     * applied to the model row by row. A scan through the container's shell runs in the
+     * background; applicationsLoaded() tells when the models are filled.
      * @param container Name of the container
-     * @return QVariantList of ExportedApp structs representing exported applications
      */
-    Q_INVOKABLE QVariantList exportedApps(const QString &container);
+    Q_INVOKABLE void loadApplications(const QString &container);
 
     /**
      * @brief Exports an application from a container to the host system
@@ -219,6 +355,28 @@ public Q_SLOTS:
      */
     Q_INVOKABLE bool unexportApp(const QString &basename, const QString &container);
 
+    /**
+     * @brief Exports several applications of a container in the background
+     *
+     * The whole selection runs as one script in the container's shell session instead of
+     * one distrobox enter per application. Every application is reported through
+     * applicationBatchProgress() as soon as it is done, the end through
+     * applicationBatchFinished() with the operation "export".
+     * @param basenames Basenames of the applications to export
+     * @param container Name of the container
+     */
+    Q_INVOKABLE void exportApps(const QStringList &basenames, const QString &container);
+
+    /**
+     * @brief Removes several exported applications of a container in the background
+     *
+     * Works like exportApps() with the operation "unexport". Applications other containers
+     * export as well only lose this container's desktop file, as with unexportApp().
+     * @param basenames Basenames of the exported applications
+     * @param container Name of the container the applications were exported from
+     */
+    Q_INVOKABLE void unexportApps(const QStringList &basenames, const QString &container);
+
 Q_SIGNALS:
     /**
      * @brief Emitted when a container clone operation finishes.
@@ -233,9 +391,241 @@ Q_SIGNALS:
      */
     void containerAssembleFinished(bool success);
 
+    /**
+     * @brief Emitted when an assembly has to wait for its images to be pulled first
+     * @param images Images listed in the manifest
+     */
+    void containerAssemblePulling(const QStringList &images);
+
+    /**
+     * @brief Emitted when refreshContainers() has updated the containers model,
+     *        and whenever a container event changed it afterwards.
+     */
+    void containersRefreshed();
+
+    /**
+     * @brief Emitted when a Distrobox container was created.
+     * @param name Name of the new container.
+     */
+    void containerAdded(const QString &name);
+
+    /**
+     * @brief Emitted when a Distrobox container was removed.
+     * @param name Name the container had.
+     */
+    void containerRemoved(const QString &name);
+
+    /**
+     * @brief Emitted when a Distrobox container was started or stopped.
+     * @param name Name of the container.
+     * @param status New engine status, e.g. "Up" or "Exited".
+     */
+    void containerStatusChanged(const QString &name, const QString &status);
+
+    /**
+     * @brief Emitted when a Distrobox container was renamed.
+     */
+    void containerRenamed(const QString &oldName, const QString &newName);
+
+    void watchingContainerEventsChanged();
+
+    /**
+     * @brief Emitted when a container engine was installed or removed, or more was learned about one.
+     */
+    void containerEnginesChanged();
+
+    /**
+     * @brief Emitted when a fetched list of available images differs from the one returned before.
+     * @param imagesJson Same format as listAvailableImages().
+     */
+    void availableImagesChanged(const QString &imagesJson);
+
+    void loadingAvailableImagesChanged();
+
+    /**
+     * @brief Emitted when an asynchronous container operation finishes.
+     * @param name Name of the container the operation ran on.
+     * @param operation One of "create", "remove", "start", "stop" or "reboot".
+     * @param success Whether the command completed successfully.
+     */
+    void containerOperationFinished(const QString &name, const QString &operation, bool success);
+
+    /**
+     * @brief Emitted for every application of exportApps() or unexportApps() once it is done.
+     * @param container Name of the container.
+     * @param operation "export" or "unexport".
+     * @param basename Basename of the application.
+     * @param success Whether the application was exported or unexported.
+     * @param done Number of applications of the batch done so far.
+     * @param total Number of applications in the batch.
+     */
+    void applicationBatchProgress(const QString &container, const QString &operation, const QString &basename, bool success, int done, int total);
+
+    /**
+     * @brief Emitted when loadApplications() has filled the models of a container, or gave up.
+     * @param container Name of the container.
+     */
+    void applicationsLoaded(const QString &container);
+
+    /**
+     * @brief Emitted when exportApps() or unexportApps() has gone through every application.
+     * @param results One map per application with "basename", "success" and "error", the end of
+     *        the application's stderr if it failed, in the order requested.
+     */
+    void applicationBatchFinished(const QString &container, const QString &operation, const QVariantList &results);
+
 private:
     QStringList m_availableImages; ///< List of available container base images
     QStringList m_fullImageNames; ///< List of full image names/URLs
+    bool m_availableImagesLoaded = false; ///< Whether the saved image list was read
+    bool m_loadingAvailableImages = false;
+
+    struct PendingOperation {
+        quint64 serial = 0;
+        QFuture<CommandResult> future;
+        QPointer<EngineApiClient> api; ///< Connection of an operation going through the engine API
+    };
+    QHash<QString, PendingOperation> m_operations; ///< Pending operation per container name
+    QHash<QString, QPointer<ContainerCreateJob>> m_createJobs; ///< Running creation per container name
+    QString m_prepullImage; ///< Image of the pre-pull held by the manager, empty if none
+    quint64 m_operationSerial = 0;
+
+    struct ApplicationModels {
+        ApplicationListModel *applications = nullptr;
+        ApplicationListModel *exported = nullptr;
+    };
+    QHash<QString, QHash<QString, QString>> m_desktopFiles; ///< Desktop file path per application basename, per container
+    QSet<QString> m_revalidatingApplications; ///< Containers whose cached catalog is being revalidated
+    QHash<QString, ApplicationModels> m_applicationModels; ///< Models handed out to the applications windows, per container
+
+    ContainerEventWatcher *m_eventWatcher;
+    QList<DistroboxCli::ContainerInfo> m_containers; ///< Last known container list, kept current by m_eventWatcher
+    ContainerListModel *m_containerModel; ///< m_containers for QML
+    UpgradeScheduler *m_upgradeScheduler;
+    ContainerMetrics *m_containerMetrics; ///< Samples the running containers of m_containerModel
+    DiskUsage *m_diskUsage; ///< Fills in the sizes of m_containers
+
+    /**
+     * @brief Replaces the known container list, applying only the differences to the model
+     */
+    void setContainers(const QList<DistroboxCli::ContainerInfo> &containers);
+
+    /**
+     * @brief Index of the container with the given engine ID in m_containers, or -1
+     */
+    qsizetype containerIndex(const QString &id) const;
+
+    /**
+     * @brief Reads the saved image list and fetches a new one if it is missing or stale
+     */
+    void loadAvailableImages();
+
+    /**
+     * @brief Fetches the image list from distrobox in the background
+     */
+    void fetchAvailableImages();
+
+    /**
+     * @brief Engine ID of the container named @p name, empty if it isn't known
+     */
+    QString containerId(const QString &name) const;
+
+    /**
+     * @brief Returns the application models of @p container, creating them if needed
+     */
+    ApplicationModels &applicationModels(const QString &container);
+
+    /**
+     * @brief Deletes the application models of a container that is gone
+     */
+    void dropApplicationModels(const QString &container);
+
+    /**
+     * @brief Turns catalog entries into rows of applicationsModel(), fetching icons that aren't cached yet
+     */
+    QList<ApplicationListModel::Application> applicationList(const QString &container, const QList<ApplicationCatalog::Entry> &entries);
+
+    /**
+     * @brief Fetches @p icons in the background and sets them on the application rows of @p container
+     */
+    void fetchApplicationIcons(const QString &container, const QStringList &icons);
+
+    /**
+     * @brief Rows of exportedAppsModel(), read from the host's desktop file index
+     */
+    QList<ApplicationListModel::Application> exportedApplications(const QString &container) const;
+
+    /**
+     * @brief Brings every exported list and exported flag up to date with the host's desktop files
+     */
+    void refreshExportedApps();
+
+    /**
+     * @brief Unexports an application, see unexportApp()
+     */
+    bool removeExport(const QString &basename, const QString &container);
+
+    /**
+     * @brief Desktop file of an application inside the container, as found by the last scan
+     */
+    QString desktopFilePath(const QString &basename, const QString &container) const;
+
+    /**
+     * @brief Runs exportApps() or unexportApps() as a single script in the container's session
+     */
+    void runApplicationBatch(const QString &container, const QString &operation, const QStringList &basenames);
+
+    /**
+     * @brief Brings the application models up to date after one application was (un)exported
+     */
+    void applyExportState(const QString &basename, const QString &container, bool exported);
+
+    /**
+     * @brief Rescans the applications of @p container in the background, reading only changed desktop files
+     * @param known Entries the caller got from the cache
+     */
+    void revalidateApplications(const QString &container, const QList<ApplicationCatalog::Entry> &known);
+
+    /**
+     * @brief Opens a terminal installing @p actualPackagePath, see installPackageInContainer()
+     * @param osRelease The container's /etc/os-release, if it could be read
+     */
+    bool launchPackageInstall(const QString &name, const QString &actualPackagePath, const QString &image, const std::optional<QByteArray> &osRelease);
+
+    /**
+     * @brief Scans the applications of @p container through its shell session and fills its models
+     */
+    void scanApplications(const QString &container, const QStringList &dataDirectories);
+
+    void handleContainerCreated(const QString &id, const QString &name, const QString &image, const QHash<QString, QString> &attributes);
+    void handleContainerStatus(const QString &id, const QString &status);
+    void handleContainerRemoved(const QString &id);
+    void handleContainerRenamed(const QString &id, const QString &newName);
+
+    /**
+     * @brief Runs a container operation, through the engine API when possible
+     * @param name Container the operation applies to
+     * @param operation Operation name reported through containerOperationFinished()
+     * @param command CLI command to execute when the API is not reachable
+     * @param timeoutMs Timeout in milliseconds for the CLI command, or CommandExecutor::NoTimeout
+     * @param apiCall Optional API request performing the same operation
+     */
+    void runContainerOperation(const QString &name,
+                               const QString &operation,
+                               const QString &command,
+                               int timeoutMs,
+                               const std::function<QFuture<ApiResponse>(EngineApiClient *)> &apiCall = {});
+
+    /**
+     * @brief Runs a container operation through the CommandExecutor
+     */
+    void runCommandOperation(const QString &name, const QString &operation, const QString &command, int timeoutMs);
+
+    /**
+     * @brief Lists containers through the engine CLI, reporting through containersRefreshed()
+     * @param timer Timer started when the refresh was requested
+     */
+    void refreshContainersWithCli(const QElapsedTimer &timer);
 
     /**
      * @brief Checks if an application with the given basename is exported by other containers
@@ -0,0 +1,631 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "engineapiclient.h"
+#include "engineprobe.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QPointer>
+#include <QTimer>
+#include <QUrl>
+#include <unistd.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+QString socketFromHostVariable(const char *variable)
+{
+    const QString value = qEnvironmentVariable(variable);
+    if (value.startsWith(u"unix://"_s)) {
+        return value.mid(7);
+    }
+    return {};
+}
+
+QString runtimeDirectory()
+{
+    const QString runtimeDir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+    if (!runtimeDir.isEmpty()) {
+        return runtimeDir;
+    }
+    return u"/run/user/%1"_s.arg(getuid());
+}
+
+QByteArray encodedName(const QString &name)
+{
+    return QUrl::toPercentEncoding(name);
+}
+}
+
+EngineApiClient::EngineApiClient(const QString &socketPath, QObject *parent)
+    : QObject(parent)
+    , m_socketPath(socketPath)
+    , m_socket(new QLocalSocket(this))
+    , m_timeoutTimer(new QTimer(this))
+{
+    m_timeoutTimer->setSingleShot(true);
+
+    connect(m_socket, &QLocalSocket::connected, this, &EngineApiClient::writeCurrent);
+    connect(m_socket, &QLocalSocket::readyRead, this, &EngineApiClient::readResponse);
+    connect(m_socket, &QLocalSocket::disconnected, this, &EngineApiClient::handleDisconnect);
+    connect(m_socket, &QLocalSocket::errorOccurred, this, [this](QLocalSocket::LocalSocketError) {
+        if (m_socket->state() != QLocalSocket::ConnectedState) {
+            handleDisconnect();
+        }
+    });
+
+    connect(m_timeoutTimer, &QTimer::timeout, this, [this]() {
+        if (!m_current) {
+            return;
+        }
+
+        qWarning() << "Engine API request timed out:" << m_current->method << m_current->path;
+        const Request request = *m_current;
+        m_current.reset();
+        m_buffer.clear();
+        m_streamHeader.reset();
+
+        // Drop the connection, a late answer would otherwise be read as the next response
+        m_socket->abort();
+        complete(request, ApiResponse{});
+    });
+}
+
+EngineApiClient::~EngineApiClient() = default;
+
+EngineApiClient *EngineApiClient::instance()
+{
+    static QPointer<EngineApiClient> client;
+
+    // The socket comes and goes with the engine service, and moves when another engine is preferred
+    static const QMetaObject::Connection engineChanges =
+        connect(EngineProbe::instance(), &EngineProbe::capabilitiesChanged, QCoreApplication::instance(), []() {
+            if (client && client->socketPath() != defaultSocketPath()) {
+                qDebug() << "Engine API socket changed, dropping the connection to" << client->socketPath();
+                client->deleteLater();
+                client = nullptr;
+            }
+        });
+    Q_UNUSED(engineChanges)
+
+    // Looked up again while missing, podman.socket may only be activated later
+    if (!client) {
+        const QString socketPath = defaultSocketPath();
+        if (!socketPath.isEmpty()) {
+            client = new EngineApiClient(socketPath, QCoreApplication::instance());
+        }
+    }
+    return client;
+}
+
+QString EngineApiClient::defaultSocketPath()
+{
+    const QString manager = qEnvironmentVariable("DBX_CONTAINER_MANAGER");
+
+    QStringList candidates;
+    if (manager.isEmpty() || manager == QLatin1String("podman")) {
+        candidates << socketFromHostVariable("CONTAINER_HOST") << runtimeDirectory() + u"/podman/podman.sock"_s;
+    }
+
+    // distrobox prefers podman, so only talk to Docker when podman can't be the engine
+    const EngineInfo *engine = EngineProbe::instance()->capabilities().preferredEngine();
+    const bool podmanMissing = engine && engine->name != QLatin1String("podman");
+    if (manager == QLatin1String("docker") || (manager.isEmpty() && podmanMissing)) {
+        candidates << socketFromHostVariable("DOCKER_HOST") << u"/var/run/docker.sock"_s;
+    }
+
+    for (const QString &candidate : std::as_const(candidates)) {
+        if (!candidate.isEmpty() && QFileInfo::exists(candidate)) {
+            return candidate;
+        }
+    }
+
+    return {};
+}
+
+QString EngineApiClient::socketPath() const
+{
+    return m_socketPath;
+}
+
+QFuture<ApiResponse> EngineApiClient::get(const QString &path, int timeoutMs)
+{
+    return enqueue("GET", path, {}, timeoutMs);
+}
+
+QFuture<ApiResponse> EngineApiClient::post(const QString &path, const QByteArray &body, int timeoutMs)
+{
+    return enqueue("POST", path, body, timeoutMs);
+}
+
+QFuture<ApiResponse> EngineApiClient::stream(const QByteArray &method, const QString &path, const BodyHandler &onBody, int timeoutMs)
+{
+    return enqueue(method, path, {}, timeoutMs, onBody);
+}
+
+QFuture<ApiResponse> EngineApiClient::listContainers()
+{
+    return get(u"/containers/json?all=true"_s);
+}
+
+QFuture<ApiResponse> EngineApiClient::inspectContainer(const QString &name)
+{
+    return get(u"/containers/%1/json"_s.arg(QString::fromLatin1(encodedName(name))));
+}
+
+QFuture<ApiResponse> EngineApiClient::startContainer(const QString &name)
+{
+    // Containers using --init can take a while to boot systemd
+    return post(u"/containers/%1/start"_s.arg(QString::fromLatin1(encodedName(name))), {}, 120000);
+}
+
+QFuture<ApiResponse> EngineApiClient::stopContainer(const QString &name)
+{
+    return post(u"/containers/%1/stop"_s.arg(QString::fromLatin1(encodedName(name))), {}, 120000);
+}
+
+QFuture<ApiResponse> EngineApiClient::containerStats(const QString &name)
+{
+    return get(u"/containers/%1/stats?stream=false"_s.arg(QString::fromLatin1(encodedName(name))));
+}
+
+QFuture<ApiResponse> EngineApiClient::containerSizes(const QStringList &ids, int timeoutMs)
+{
+    const QJsonObject filters{{u"id"_s, QJsonArray::fromStringList(ids)}};
+    const QByteArray filtersJson = QJsonDocument(filters).toJson(QJsonDocument::Compact);
+    return get(u"/containers/json?all=true&size=true&filters=%1"_s.arg(QString::fromLatin1(QUrl::toPercentEncoding(QString::fromUtf8(filtersJson)))), timeoutMs);
+}
+
+QFuture<ApiResponse> EngineApiClient::listImages()
+{
+    return get(u"/images/json?shared-size=true"_s);
+}
+
+QFuture<ApiResponse> EngineApiClient::pullImage(const QString &image, const BodyHandler &onProgress)
+{
+    // Without a tag the Docker API pulls every tag of the repository
+    QString reference = image;
+    QString tag;
+    const qsizetype lastSlash = reference.lastIndexOf(QLatin1Char('/'));
+    const qsizetype colon = reference.indexOf(QLatin1Char(':'), lastSlash + 1);
+    if (!reference.contains(QLatin1Char('@'))) {
+        if (colon > lastSlash) {
+            tag = reference.mid(colon + 1);
+            reference.truncate(colon);
+        } else {
+            tag = u"latest"_s;
+        }
+    }
+
+    QString path = u"/images/create?fromImage=%1"_s.arg(QString::fromLatin1(encodedName(reference)));
+    if (!tag.isEmpty()) {
+        path += u"&tag=%1"_s.arg(QString::fromLatin1(encodedName(tag)));
+    }
+
+    // A registry may take a while between layers, but not minutes without a word
+    return stream("POST", path, onProgress, 120000);
+}
+
+QList<DistroboxCli::ContainerInfo> EngineApiClient::parseContainers(const QJsonDocument &document)
+{
+    QList<DistroboxCli::ContainerInfo> result;
+
+    const QJsonArray containers = document.array();
+    for (const QJsonValue &value : containers) {
+        const QJsonObject object = value.toObject();
+
+        // Same criteria as distrobox list: the manager label or the distrobox-init mount
+        bool isDistrobox = object.value(u"Labels"_s).toObject().value(u"manager"_s).toString() == QLatin1String("distrobox");
+        if (!isDistrobox) {
+            const QJsonArray mounts = object.value(u"Mounts"_s).toArray();
+            for (const QJsonValue &mount : mounts) {
+                if (mount.toObject().value(u"Source"_s).toString().contains(u"distrobox"_s)) {
+                    isDistrobox = true;
+                    break;
+                }
+            }
+        }
+        if (!isDistrobox) {
+            continue;
+        }
+
+        DistroboxCli::ContainerInfo info;
+        info.id = object.value(u"Id"_s).toString();
+        const QJsonArray names = object.value(u"Names"_s).toArray();
+        info.name = names.isEmpty() ? QString() : names.first().toString();
+        if (info.name.startsWith(QLatin1Char('/'))) {
+            info.name.remove(0, 1);
+        }
+        info.image = object.value(u"Image"_s).toString();
+        info.created = QDateTime::fromSecsSinceEpoch(object.value(u"Created"_s).toInteger());
+        if (object.contains(u"SizeRw"_s)) {
+            info.size = object.value(u"SizeRw"_s).toInteger();
+        }
+
+        // Older Podman versions report the bare state instead of the "Up 2 hours" text
+        const QString state = object.value(u"State"_s).toString();
+        info.status = object.value(u"Status"_s).toString();
+        if (state == QLatin1String("running") && !info.status.startsWith(u"Up"_s)) {
+            info.status = u"Up"_s;
+        } else if (state == QLatin1String("exited") && !info.status.startsWith(u"Exited"_s)) {
+            info.status = u"Exited"_s;
+        } else if (info.status.isEmpty()) {
+            info.status = state.isEmpty() ? QString() : state.at(0).toUpper() + state.mid(1);
+        }
+
+        result.append(info);
+    }
+
+    return result;
+}
+
+void EngineApiClient::onFinished(const QFuture<ApiResponse> &future, QObject *context, const std::function<void(const ApiResponse &)> &handler)
+{
+    auto *watcher = new QFutureWatcher<ApiResponse>(context);
+    QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, [watcher, handler]() {
+        const QFuture<ApiResponse> finishedFuture = watcher->future();
+        const ApiResponse response = finishedFuture.resultCount() > 0 ? finishedFuture.result() : ApiResponse{};
+        watcher->deleteLater();
+        if (handler) {
+            handler(response);
+        }
+    });
+    watcher->setFuture(future);
+}
+
+void EngineApiClient::cancelAll()
+{
+    ApiResponse response;
+    response.canceled = true;
+
+    const QQueue<Request> queued = m_queue;
+    m_queue.clear();
+    for (const Request &request : queued) {
+        request.promise->addResult(response);
+        request.promise->finish();
+    }
+
+    if (m_current) {
+        const Request request = *m_current;
+        m_current.reset();
+        m_buffer.clear();
+        m_streamHeader.reset();
+        m_timeoutTimer->stop();
+
+        // Drop the connection, a late answer would otherwise be read as the next response
+        m_socket->abort();
+        request.promise->addResult(response);
+        request.promise->finish();
+    }
+}
+
+QFuture<ApiResponse> EngineApiClient::enqueue(const QByteArray &method, const QString &path, const QByteArray &body, int timeoutMs, const BodyHandler &onBody)
+{
+    Request request;
+    request.method = method;
+    request.path = path;
+    request.body = body;
+    request.timeoutMs = timeoutMs;
+    request.onBody = onBody;
+    request.promise = std::make_shared<QPromise<ApiResponse>>();
+    request.promise->start();
+
+    QFuture<ApiResponse> future = request.promise->future();
+    m_queue.enqueue(request);
+    sendNext();
+    return future;
+}
+
+void EngineApiClient::sendNext()
+{
+    if (m_current || m_queue.isEmpty()) {
+        return;
+    }
+
+    m_current = m_queue.dequeue();
+    m_buffer.clear();
+    m_streamHeader.reset();
+    m_receivedData = false;
+
+    if (m_current->timeoutMs > 0) {
+        m_timeoutTimer->start(m_current->timeoutMs);
+    }
+
+    switch (m_socket->state()) {
+    case QLocalSocket::ConnectedState:
+        writeCurrent();
+        break;
+    case QLocalSocket::UnconnectedState:
+        m_socket->connectToServer(m_socketPath);
+        break;
+    default:
+        // Still connecting or closing, connected() / disconnected() pick it up
+        break;
+    }
+}
+
+void EngineApiClient::writeCurrent()
+{
+    if (!m_current) {
+        return;
+    }
+
+    QByteArray request = m_current->method + ' ' + m_current->path.toUtf8() + " HTTP/1.1\r\n";
+    request += "Host: d\r\n";
+    request += "Connection: keep-alive\r\n";
+    if (m_current->method == "POST" || !m_current->body.isEmpty()) {
+        request += "Content-Type: application/json\r\n";
+        request += "Content-Length: " + QByteArray::number(m_current->body.size()) + "\r\n";
+    }
+    request += "\r\n";
+    request += m_current->body;
+
+    m_socket->write(request);
+}
+
+void EngineApiClient::readResponse()
+{
+    m_buffer += m_socket->readAll();
+    if (!m_current) {
+        // Unsolicited data, nothing is waiting for it
+        m_buffer.clear();
+        return;
+    }
+
+    m_receivedData = true;
+
+    ApiResponse response;
+    bool complete;
+    if (m_current->onBody) {
+        if (m_current->timeoutMs > 0) {
+            m_timeoutTimer->start(m_current->timeoutMs);
+        }
+        complete = parseStream(response, false);
+    } else {
+        complete = parseBuffer(response, false);
+    }
+
+    if (complete) {
+        finishCurrent(response);
+        if (m_closeAfterResponse) {
+            m_socket->disconnectFromServer();
+        }
+    }
+}
+
+void EngineApiClient::handleDisconnect()
+{
+    if (!m_current) {
+        return;
+    }
+
+    ApiResponse response;
+    if (m_receivedData) {
+        // Responses without a length are terminated by the server closing the connection
+        if (m_current->onBody) {
+            parseStream(response, true);
+        } else {
+            parseBuffer(response, true);
+        }
+        finishCurrent(response);
+        return;
+    }
+
+    // The server may have dropped an idle keep-alive connection, so try once on a fresh one
+    if (!m_current->retried) {
+        Request request = *m_current;
+        request.retried = true;
+        m_current.reset();
+        m_timeoutTimer->stop();
+        m_queue.prepend(request);
+        QMetaObject::invokeMethod(this, &EngineApiClient::sendNext, Qt::QueuedConnection);
+        return;
+    }
+
+    finishCurrent(response);
+}
+
+void EngineApiClient::finishCurrent(const ApiResponse &response)
+{
+    if (!m_current) {
+        return;
+    }
+
+    const Request request = *m_current;
+    m_current.reset();
+    m_buffer.clear();
+    m_streamHeader.reset();
+    complete(request, response);
+}
+
+void EngineApiClient::complete(const Request &request, const ApiResponse &response)
+{
+    m_timeoutTimer->stop();
+
+    request.promise->addResult(response);
+    request.promise->finish();
+
+    QMetaObject::invokeMethod(this, &EngineApiClient::sendNext, Qt::QueuedConnection);
+}
+
+std::optional<EngineApiClient::Header> EngineApiClient::parseHeader(const QByteArray &header)
+{
+    const QList<QByteArray> lines = header.split('\n');
+    const QList<QByteArray> statusLine = lines.first().trimmed().split(' ');
+    if (statusLine.size() < 2) {
+        return std::nullopt;
+    }
+
+    Header result;
+    result.statusCode = statusLine.at(1).toInt();
+    for (qsizetype i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines.at(i).trimmed();
+        const qsizetype colon = line.indexOf(':');
+        if (colon < 0) {
+            continue;
+        }
+
+        const QByteArray name = line.left(colon).trimmed().toLower();
+        const QByteArray value = line.mid(colon + 1).trimmed();
+        if (name == "content-length") {
+            result.contentLength = value.toLongLong();
+        } else if (name == "transfer-encoding") {
+            result.chunked = value.toLower().contains("chunked");
+        } else if (name == "connection") {
+            result.closeAfter = value.toLower() == "close";
+        }
+    }
+    return result;
+}
+
+bool EngineApiClient::parseBuffer(ApiResponse &response, bool connectionClosed)
+{
+    const qsizetype headerEnd = m_buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return false;
+    }
+
+    const std::optional<Header> header = parseHeader(m_buffer.left(headerEnd));
+    if (!header) {
+        return false;
+    }
+    response.statusCode = header->statusCode;
+    const qint64 contentLength = header->contentLength;
+    const bool chunked = header->chunked;
+    const bool closeAfter = header->closeAfter;
+
+    const qsizetype bodyStart = headerEnd + 4;
+    bool complete = false;
+
+    if (response.statusCode == 204 || response.statusCode == 304 || response.statusCode / 100 == 1) {
+        complete = true;
+    } else if (chunked) {
+        QByteArray body;
+        qsizetype pos = bodyStart;
+        while (true) {
+            const qsizetype lineEnd = m_buffer.indexOf("\r\n", pos);
+            if (lineEnd < 0) {
+                break;
+            }
+
+            bool ok = false;
+            const qint64 chunkSize = m_buffer.mid(pos, lineEnd - pos).split(';').first().trimmed().toLongLong(&ok, 16);
+            if (!ok) {
+                break;
+            }
+
+            pos = lineEnd + 2;
+            if (chunkSize == 0) {
+                complete = m_buffer.size() >= pos + 2;
+                break;
+            }
+            if (m_buffer.size() < pos + chunkSize + 2) {
+                break;
+            }
+
+            body += m_buffer.mid(pos, chunkSize);
+            pos += chunkSize + 2;
+        }
+        response.body = body;
+    } else if (contentLength >= 0) {
+        if (m_buffer.size() >= bodyStart + contentLength) {
+            response.body = m_buffer.mid(bodyStart, contentLength);
+            complete = true;
+        }
+    } else if (connectionClosed) {
+        response.body = m_buffer.mid(bodyStart);
+        complete = true;
+    }
+
+    if (!complete && connectionClosed) {
+        // Truncated response, report what we got as a transport failure
+        response.statusCode = 0;
+        return true;
+    }
+
+    m_closeAfterResponse = closeAfter;
+    return complete;
+}
+
+bool EngineApiClient::parseStream(ApiResponse &response, bool connectionClosed)
+{
+    if (!m_streamHeader) {
+        const qsizetype headerEnd = m_buffer.indexOf("\r\n\r\n");
+        const std::optional<Header> header = headerEnd < 0 ? std::nullopt : parseHeader(m_buffer.left(headerEnd));
+        if (!header) {
+            return connectionClosed;
+        }
+        m_streamHeader = header;
+        m_streamRemaining = header->contentLength;
+        m_buffer.remove(0, headerEnd + 4);
+    }
+
+    // Handled parts of the body are dropped from the buffer, so long streams don't pile up
+    const int statusCode = m_streamHeader->statusCode;
+    response.statusCode = statusCode;
+    bool complete = false;
+
+    if (statusCode == 204 || statusCode == 304 || statusCode / 100 == 1) {
+        complete = true;
+    } else if (m_streamHeader->chunked) {
+        while (true) {
+            const qsizetype lineEnd = m_buffer.indexOf("\r\n");
+            if (lineEnd < 0) {
+                break;
+            }
+
+            bool ok = false;
+            const qint64 chunkSize = m_buffer.left(lineEnd).split(';').first().trimmed().toLongLong(&ok, 16);
+            if (!ok) {
+                break;
+            }
+
+            if (chunkSize == 0) {
+                complete = m_buffer.size() >= lineEnd + 4;
+                break;
+            }
+            if (m_buffer.size() < lineEnd + 2 + chunkSize + 2) {
+                break;
+            }
+
+            const QByteArray chunk = m_buffer.mid(lineEnd + 2, chunkSize);
+            m_buffer.remove(0, lineEnd + 2 + chunkSize + 2);
+            m_current->onBody(chunk);
+        }
+    } else if (m_streamRemaining >= 0) {
+        const qint64 available = qMin<qint64>(m_streamRemaining, m_buffer.size());
+        if (available > 0) {
+            const QByteArray chunk = m_buffer.left(available);
+            m_buffer.remove(0, available);
+            m_streamRemaining -= available;
+            m_current->onBody(chunk);
+        }
+        complete = m_streamRemaining == 0;
+    } else {
+        if (!m_buffer.isEmpty()) {
+            const QByteArray chunk = m_buffer;
+            m_buffer.clear();
+            m_current->onBody(chunk);
+        }
+        complete = connectionClosed;
+    }
+
+    if (!complete && connectionClosed) {
+        // Truncated response, report what we got as a transport failure
+        response.statusCode = 0;
+        return true;
+    }
+
+    m_closeAfterResponse = m_streamHeader->closeAfter;
+    return complete;
+}
@@ -0,0 +1,201 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QByteArray>
+#include <QFuture>
+#include <QJsonDocument>
+#include <QObject>
+#include <QPromise>
+#include <QQueue>
+#include <QString>
+#include <QStringList>
+#include <functional>
+#include <memory>
+#include <optional>
+
+class QLocalSocket;
+class QTimer;
+
+/**
+ * @struct ApiResponse
+ * @brief HTTP response received from the container engine API
+ */
+struct ApiResponse {
+    int statusCode = 0; ///< HTTP status code, 0 if the request never got an answer
+    QByteArray body; ///< Response body with any chunked transfer encoding removed
+    bool canceled = false; ///< The request was canceled through EngineApiClient::cancelAll()
+
+    /**
+     * @brief Whether the engine could be reached at all
+     */
+    bool reachable() const
+    {
+        return statusCode != 0;
+    }
+
+    /**
+     * @brief Whether the request succeeded, "not modified" (already started/stopped) included
+     */
+    bool success() const
+    {
+        return (statusCode >= 200 && statusCode < 300) || statusCode == 304;
+    }
+
+    QJsonDocument json() const
+    {
+        return QJsonDocument::fromJson(body);
+    }
+};
+
+/**
+ * @class EngineApiClient
+ * @brief Minimal HTTP/1.1 client for the Docker-compatible REST API of Podman and Docker
+ *
+ * Talks to the engine over its local Unix socket, reusing a single keep-alive
+ * connection for consecutive requests. Requests are sent one at a time in the order
+ * they were queued. Only the Docker-compatible endpoints are used, which both the
+ * Podman service and the Docker daemon serve.
+ */
+class EngineApiClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultTimeout = 10000; ///< Default per-request timeout in milliseconds
+
+    using BodyHandler = std::function<void(const QByteArray &chunk)>;
+
+    /**
+     * @brief Creates a client for the socket at @p socketPath
+     */
+    explicit EngineApiClient(const QString &socketPath, QObject *parent = nullptr);
+    ~EngineApiClient() override;
+
+    /**
+     * @brief Returns the shared client for the engine distrobox uses, or nullptr if it has no API socket
+     *
+     * The socket is looked up again while there is none, and the client is replaced when
+     * EngineProbe notices the engine or its socket changed.
+     */
+    static EngineApiClient *instance();
+
+    /**
+     * @brief Finds the API socket of the engine distrobox uses
+     * @return Socket path, or an empty string if none is reachable
+     */
+    static QString defaultSocketPath();
+
+    QString socketPath() const;
+
+    QFuture<ApiResponse> get(const QString &path, int timeoutMs = DefaultTimeout);
+    QFuture<ApiResponse> post(const QString &path, const QByteArray &body = {}, int timeoutMs = DefaultTimeout);
+
+    /**
+     * @brief Sends a request whose response body is handed to @p onBody as it arrives
+     *
+     * The body is not collected in the ApiResponse. @p timeoutMs applies to the time
+     * without any data rather than to the whole request, so long streams such as image
+     * pulls only time out when they stall.
+     */
+    QFuture<ApiResponse> stream(const QByteArray &method, const QString &path, const BodyHandler &onBody, int timeoutMs = DefaultTimeout);
+
+    QFuture<ApiResponse> listContainers();
+    QFuture<ApiResponse> inspectContainer(const QString &name);
+    QFuture<ApiResponse> startContainer(const QString &name);
+    QFuture<ApiResponse> stopContainer(const QString &name);
+    QFuture<ApiResponse> containerStats(const QString &name);
+
+    /**
+     * @brief Lists the containers with the given IDs along with their writable layer size
+     *
+     * The engine walks each writable layer for this, so it can take a while.
+     */
+    QFuture<ApiResponse> containerSizes(const QStringList &ids, int timeoutMs = DefaultTimeout);
+
+    /**
+     * @brief Lists the images, with the bytes each shares with other images
+     */
+    QFuture<ApiResponse> listImages();
+
+    /**
+     * @brief Pulls @p image, handing the engine's JSON progress messages to @p onProgress
+     *
+     * The messages are newline separated JSON objects; chunks don't necessarily end at a
+     * message boundary.
+     */
+    QFuture<ApiResponse> pullImage(const QString &image, const BodyHandler &onProgress);
+
+    /**
+     * @brief Cancels every queued request and the one in flight
+     *
+     * Their futures finish with a response that has canceled set.
+     */
+    void cancelAll();
+
+    /**
+     * @brief Converts a /containers/json response into distrobox containers
+     */
+    static QList<DistroboxCli::ContainerInfo> parseContainers(const QJsonDocument &document);
+
+    /**
+     * @brief Invokes @p handler with the response of @p future on the thread of @p context
+     */
+    static void onFinished(const QFuture<ApiResponse> &future, QObject *context, const std::function<void(const ApiResponse &)> &handler);
+
+private:
+    struct Request {
+        QByteArray method;
+        QString path;
+        QByteArray body;
+        int timeoutMs = DefaultTimeout;
+        bool retried = false;
+        BodyHandler onBody; ///< Set for streamed requests
+        std::shared_ptr<QPromise<ApiResponse>> promise;
+    };
+
+    struct Header {
+        int statusCode = 0;
+        qint64 contentLength = -1;
+        bool chunked = false;
+        bool closeAfter = false;
+    };
+
+    static std::optional<Header> parseHeader(const QByteArray &header);
+
+    QFuture<ApiResponse> enqueue(const QByteArray &method, const QString &path, const QByteArray &body, int timeoutMs, const BodyHandler &onBody = {});
+    void sendNext();
+    void writeCurrent();
+    void readResponse();
+    void finishCurrent(const ApiResponse &response);
+    void complete(const Request &request, const ApiResponse &response);
+    void handleDisconnect();
+
+    /**
+     * @brief Tries to parse a complete response from m_buffer
+     * @return true once the full response is available in @p response
+     */
+    bool parseBuffer(ApiResponse &response, bool connectionClosed);
+
+    /**
+     * @brief Hands the body received so far for a streamed request to its handler
+     * @return true once the response is complete
+     */
+    bool parseStream(ApiResponse &response, bool connectionClosed);
+
+    QString m_socketPath;
+    QLocalSocket *m_socket;
+    QTimer *m_timeoutTimer;
+    QQueue<Request> m_queue;
+    std::optional<Request> m_current;
+    QByteArray m_buffer;
+    std::optional<Header> m_streamHeader; ///< Header of the streamed response being read, the body follows in m_buffer
+    qint64 m_streamRemaining = -1; ///< Body bytes still expected for a streamed response with a length
+    bool m_receivedData = false;
+    bool m_closeAfterResponse = false;
+};
@@ -0,0 +1,253 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "engineprobe.h"
+#include "commandexecutor.h"
+#include "distroboxcli.h"
+
+#include <KShell>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QTimer>
+#include <unistd.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+const QStringList EngineNames = {u"podman"_s, u"docker"_s};
+
+// Coalesces the bursts of changes package managers cause
+constexpr int InvalidateDelay = 1000;
+
+// Prints "<engine>|<path>" for every installed engine
+const char DetectScript[] = R"SH(
+for engine in podman docker; do
+    path=$(command -v "$engine") && printf '%s|%s\n' "$engine" "$path"
+done
+)SH";
+
+// Prints "<engine>|<version>|<rootless>|<storage driver>|<socket>" for every installed engine
+const char DetailsScript[] = R"SH(
+for engine in podman docker; do
+    command -v "$engine" >/dev/null 2>&1 || continue
+    case "$engine" in
+        podman) info=$(podman info --format '{{.Version.Version}}|{{.Host.Security.Rootless}}|{{.Store.GraphDriverName}}|{{.Host.RemoteSocket.Path}}' 2>/dev/null) ;;
+        docker) info=$(docker info --format '{{.ServerVersion}}|{{.SecurityOptions}}|{{.Driver}}|' 2>/dev/null) ;;
+    esac
+    printf '%s|%s\n' "$engine" "$info"
+done
+)SH";
+
+QString runtimeDirectory()
+{
+    const QString runtimeDir = qEnvironmentVariable("XDG_RUNTIME_DIR");
+    return runtimeDir.isEmpty() ? u"/run/user/%1"_s.arg(getuid()) : runtimeDir;
+}
+
+// API socket of @p engine as seen from this process, empty if there is none
+QString reachableSocket(const QString &engine, const QString &reportedSocket, bool rootless)
+{
+    QStringList candidates;
+    if (engine == QLatin1String("podman")) {
+        QString socket = reportedSocket;
+        if (socket.startsWith(QLatin1String("unix://"))) {
+            socket.remove(0, 7);
+        }
+        candidates << socket << runtimeDirectory() + u"/podman/podman.sock"_s;
+    } else if (rootless) {
+        candidates << runtimeDirectory() + u"/docker.sock"_s;
+    } else {
+        candidates << u"/var/run/docker.sock"_s;
+    }
+
+    for (const QString &candidate : std::as_const(candidates)) {
+        if (!candidate.isEmpty() && QFileInfo::exists(candidate)) {
+            return candidate;
+        }
+    }
+    return {};
+}
+}
+
+bool EngineCapabilities::isEngineAvailable() const
+{
+    return !engines.isEmpty();
+}
+
+const EngineInfo *EngineCapabilities::preferredEngine() const
+{
+    const QString manager = qEnvironmentVariable("DBX_CONTAINER_MANAGER");
+    for (const EngineInfo &engine : engines) {
+        if (manager.isEmpty() || engine.name == manager) {
+            return &engine;
+        }
+    }
+    return nullptr;
+}
+
+EngineProbe *EngineProbe::instance()
+{
+    static EngineProbe *probe = new EngineProbe(QCoreApplication::instance());
+    return probe;
+}
+
+EngineProbe::EngineProbe(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_invalidateTimer(new QTimer(this))
+{
+    m_invalidateTimer->setSingleShot(true);
+    m_invalidateTimer->setInterval(InvalidateDelay);
+    connect(m_invalidateTimer, &QTimer::timeout, this, [this]() {
+        const bool wasAvailable = m_capabilities.isEngineAvailable();
+        invalidate();
+        detectEngines();
+        qDebug() << "Container engines changed, available:" << wasAvailable << "->" << m_capabilities.isEngineAvailable();
+        Q_EMIT capabilitiesChanged();
+    });
+
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_invalidateTimer, qOverload<>(&QTimer::start));
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, m_invalidateTimer, qOverload<>(&QTimer::start));
+}
+
+EngineCapabilities EngineProbe::capabilities()
+{
+    if (!m_known || (!m_capabilities.isEngineAvailable() && m_negativeResultExpiry.hasExpired())) {
+        detectEngines();
+    }
+    return m_capabilities;
+}
+
+bool EngineProbe::isEngineAvailable()
+{
+    return capabilities().isEngineAvailable();
+}
+
+void EngineProbe::invalidate()
+{
+    m_known = false;
+    ++m_generation;
+    m_probingDetails = false;
+}
+
+void EngineProbe::detectEngines()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    EngineCapabilities capabilities;
+    if (DistroboxCli::isFlatpak()) {
+        bool success = false;
+        const QString output = DistroboxCli::runCommand(u"sh -c %1"_s.arg(KShell::quoteArg(QString::fromLatin1(DetectScript))), success);
+        for (const QString &line : output.split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+            const QString name = line.section(QLatin1Char('|'), 0, 0);
+            if (EngineNames.contains(name)) {
+                capabilities.engines.append(EngineInfo{name, line.section(QLatin1Char('|'), 1)});
+            }
+        }
+    } else {
+        for (const QString &name : EngineNames) {
+            const QString path = QStandardPaths::findExecutable(name);
+            if (!path.isEmpty()) {
+                capabilities.engines.append(EngineInfo{name, path});
+            }
+        }
+    }
+
+    m_capabilities = capabilities;
+    m_known = true;
+    m_negativeResultExpiry = DistroboxCli::isFlatpak() ? QDeadlineTimer(NegativeResultLifetime) : QDeadlineTimer(QDeadlineTimer::Forever);
+
+    QStringList names;
+    for (const EngineInfo &engine : std::as_const(m_capabilities.engines)) {
+        names << engine.name;
+    }
+    qDebug() << "Detected container engines" << names << "in" << timer.elapsed() << "ms";
+
+    watchPaths();
+    if (m_capabilities.isEngineAvailable()) {
+        probeDetails();
+    }
+}
+
+void EngineProbe::probeDetails()
+{
+    if (m_probingDetails) {
+        return;
+    }
+    m_probingDetails = true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const quint64 generation = m_generation;
+    const QFuture<CommandResult> future = CommandExecutor::instance()->run(u"sh -c %1"_s.arg(KShell::quoteArg(QString::fromLatin1(DetailsScript))));
+    CommandExecutor::onFinished(future, this, [this, generation, timer](const CommandResult &result) {
+        if (generation != m_generation) {
+            return;
+        }
+        m_probingDetails = false;
+
+        for (const QString &line : result.text().split(QLatin1Char('\n'), Qt::SkipEmptyParts)) {
+            const QStringList fields = line.split(QLatin1Char('|'));
+            if (fields.size() < 5) {
+                continue;
+            }
+
+            for (EngineInfo &engine : m_capabilities.engines) {
+                if (engine.name != fields.at(0)) {
+                    continue;
+                }
+                engine.version = fields.at(1).trimmed();
+                engine.rootless = engine.name == QLatin1String("podman") ? fields.at(2).trimmed() == QLatin1String("true")
+                                                                         : fields.at(2).contains(QLatin1String("rootless"));
+                engine.storageDriver = fields.at(3).trimmed();
+                engine.apiSocket = reachableSocket(engine.name, fields.at(4).trimmed(), engine.rootless);
+                engine.detailsProbed = true;
+
+                qDebug() << "Container engine" << engine.name << engine.version << (engine.rootless ? "rootless" : "rootful") << "storage"
+                         << engine.storageDriver << "socket" << engine.apiSocket;
+            }
+        }
+
+        qDebug() << "Probed container engine details in" << timer.elapsed() << "ms";
+        Q_EMIT capabilitiesChanged();
+    });
+}
+
+void EngineProbe::watchPaths()
+{
+    QStringList paths;
+
+    // Inside Flatpak PATH is the sandbox's, installing an engine on the host doesn't show up there
+    if (!DistroboxCli::isFlatpak()) {
+        for (const QString &directory : qEnvironmentVariable("PATH").split(QLatin1Char(':'), Qt::SkipEmptyParts)) {
+            if (QFileInfo(directory).isDir()) {
+                paths << QDir(directory).canonicalPath();
+            }
+        }
+    }
+
+    // Sockets appear and disappear as the engine services start and stop
+    for (const QString &socketPath : {runtimeDirectory() + u"/podman"_s, u"/var/run/docker.sock"_s, runtimeDirectory() + u"/docker.sock"_s}) {
+        if (QFileInfo::exists(socketPath)) {
+            paths << socketPath;
+        }
+    }
+
+    paths.removeDuplicates();
+    const QStringList watched = m_watcher->files() + m_watcher->directories();
+    for (const QString &path : std::as_const(paths)) {
+        if (!watched.contains(path)) {
+            m_watcher->addPath(path);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QDeadlineTimer>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @struct EngineInfo
+ * @brief What EngineProbe found out about one container engine
+ */
+struct EngineInfo {
+    QString name; ///< "podman" or "docker"
+    QString path; ///< Executable on the host
+    QString version; ///< Empty until the details were probed
+    bool rootless = false;
+    QString storageDriver; ///< e.g. "overlay"; empty if unknown
+    QString apiSocket; ///< API socket reachable from this process, empty if none
+    bool detailsProbed = false; ///< Whether version, mode, storage driver and socket are known
+};
+
+/**
+ * @struct EngineCapabilities
+ * @brief Container engines installed on the host
+ */
+struct EngineCapabilities {
+    QList<EngineInfo> engines; ///< Installed engines, in distrobox's order of preference
+
+    bool isEngineAvailable() const;
+
+    /**
+     * @brief The engine distrobox uses: DBX_CONTAINER_MANAGER if set, podman before docker otherwise
+     * @return The engine, or nullptr if none is installed
+     */
+    const EngineInfo *preferredEngine() const;
+};
+
+/**
+ * @class EngineProbe
+ * @brief Detects the host's container engines once and keeps the result current
+ *
+ * Which engines are installed is looked up on first use: with no process at all on
+ * the host, and with a single host command inside Flatpak. Versions, rootless mode,
+ * storage driver and API socket follow from one more command in the background.
+ *
+ * The result is cached until a watched PATH directory or engine socket directory
+ * changes. Inside Flatpak the host's PATH can't be watched, so a negative result
+ * is only trusted for NegativeResultLifetime.
+ */
+class EngineProbe : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int NegativeResultLifetime = 10000; ///< Milliseconds
+
+    /**
+     * @brief Returns the application-wide probe
+     */
+    static EngineProbe *instance();
+
+    explicit EngineProbe(QObject *parent = nullptr);
+
+    /**
+     * @brief Current capabilities, looking the installed engines up if they aren't known
+     *
+     * Details are filled in asynchronously; capabilitiesChanged() is emitted once they are.
+     */
+    EngineCapabilities capabilities();
+
+    bool isEngineAvailable();
+
+    /**
+     * @brief Forgets the cached result, the next call to capabilities() probes again
+     */
+    void invalidate();
+
+Q_SIGNALS:
+    void capabilitiesChanged();
+
+private:
+    void detectEngines();
+    void probeDetails();
+    void watchPaths();
+
+    EngineCapabilities m_capabilities;
+    bool m_known = false;
+    bool m_probingDetails = false;
+    quint64 m_generation = 0; ///< Incremented by invalidate(), so stale detail probes are ignored
+    QDeadlineTimer m_negativeResultExpiry;
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_invalidateTimer;
+};
@@ -0,0 +1,258 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "hostdesktopindex.h"
+#include "distroboxcli.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QStandardPaths>
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Exporting writes several files in a row, one rescan covers them all
+constexpr int RescanDelay = 200;
+
+const QString DesktopSuffix = u".desktop"_s;
+
+// Reads Name and Icon of the [Desktop Entry] group; QSettings would split values at commas
+void parseDesktopFile(const QString &path, HostDesktopIndex::Entry &entry)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return;
+    }
+
+    bool inDesktopEntry = false;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.startsWith('[')) {
+            if (inDesktopEntry) {
+                break;
+            }
+            inDesktopEntry = line == "[Desktop Entry]";
+            continue;
+        }
+        if (!inDesktopEntry) {
+            continue;
+        }
+
+        const qsizetype equals = line.indexOf('=');
+        if (equals < 0) {
+            continue;
+        }
+        const QByteArray key = line.left(equals).trimmed();
+        if (key == "Name") {
+            entry.name = QString::fromUtf8(line.mid(equals + 1).trimmed());
+        } else if (key == "Icon") {
+            entry.icon = QString::fromUtf8(line.mid(equals + 1).trimmed());
+        }
+    }
+}
+
+// Distrobox leaves "*clone.desktop" files behind that aren't applications
+bool isCloneFile(const QString &fileName)
+{
+    return fileName.endsWith(u"clone.desktop"_s, Qt::CaseInsensitive);
+}
+
+// Closest directory of @p path that exists, so its creation can be noticed
+QString existingAncestor(const QString &path)
+{
+    QDir dir(path);
+    while (!dir.exists() && !dir.isRoot()) {
+        if (!dir.cdUp()) {
+            break;
+        }
+    }
+    return dir.exists() ? dir.absolutePath() : QString();
+}
+}
+
+HostDesktopIndex *HostDesktopIndex::instance()
+{
+    static HostDesktopIndex *index = new HostDesktopIndex(QCoreApplication::instance());
+    return index;
+}
+
+HostDesktopIndex::HostDesktopIndex(QObject *parent)
+    : QObject(parent)
+    , m_watcher(new QFileSystemWatcher(this))
+    , m_rescanTimer(new QTimer(this))
+{
+    if (DistroboxCli::isFlatpak()) {
+        m_directories = {QDir::homePath() + u"/.var/app/io.github.DenysMb.Kontainer/data/applications"_s,
+                         QDir::homePath() + u"/.var/app/io.github.DenysMb.Kontainer/.local/share/applications"_s,
+                         u"/var/lib/flatpak/exports/share/applications"_s,
+                         QDir::homePath() + u"/.local/share/flatpak/exports/share/applications"_s};
+    }
+    m_directories << exportDirectory();
+    m_directories.removeDuplicates();
+
+    m_rescanTimer->setSingleShot(true);
+    m_rescanTimer->setInterval(RescanDelay);
+    connect(m_rescanTimer, &QTimer::timeout, this, &HostDesktopIndex::rescan);
+    connect(m_watcher, &QFileSystemWatcher::directoryChanged, m_rescanTimer, qOverload<>(&QTimer::start));
+    connect(m_watcher, &QFileSystemWatcher::fileChanged, m_rescanTimer, qOverload<>(&QTimer::start));
+
+    QElapsedTimer timer;
+    timer.start();
+    for (const QString &directory : std::as_const(m_directories)) {
+        scanDirectory(directory);
+    }
+    rebuildExports();
+    watch();
+
+    qsizetype files = 0;
+    for (const auto &entries : std::as_const(m_files)) {
+        files += entries.size();
+    }
+    qDebug() << "Indexed" << files << "host desktop files in" << timer.elapsed() << "ms";
+}
+
+QString HostDesktopIndex::exportDirectory()
+{
+    // Inside Flatpak the host's directory is mounted read-only at its usual place
+    if (DistroboxCli::isFlatpak()) {
+        return QDir::homePath() + u"/.local/share/applications"_s;
+    }
+    return QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation);
+}
+
+QHash<QString, HostDesktopIndex::Entry> HostDesktopIndex::exportsOf(const QString &container) const
+{
+    return m_exportsByContainer.value(container);
+}
+
+QSet<QString> HostDesktopIndex::containersExporting(const QString &basename) const
+{
+    return m_exportsByBasename.value(basename);
+}
+
+std::optional<HostDesktopIndex::Entry> HostDesktopIndex::find(const QString &fileName) const
+{
+    for (const QString &directory : m_directories) {
+        const auto files = m_files.constFind(directory);
+        if (files == m_files.constEnd()) {
+            continue;
+        }
+        const auto it = files->constFind(fileName);
+        if (it != files->constEnd()) {
+            return *it;
+        }
+    }
+    return std::nullopt;
+}
+
+void HostDesktopIndex::rescan()
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    bool changed = false;
+    for (const QString &directory : std::as_const(m_directories)) {
+        changed |= scanDirectory(directory);
+    }
+    watch();
+
+    if (changed) {
+        rebuildExports();
+        qDebug() << "Host desktop files changed, reindexed in" << timer.elapsed() << "ms";
+        Q_EMIT this->changed();
+    }
+}
+
+bool HostDesktopIndex::scanDirectory(const QString &directory)
+{
+    const QHash<QString, Entry> previous = m_files.value(directory);
+    QHash<QString, Entry> entries;
+
+    const QFileInfoList files = QDir(directory).entryInfoList({u"*.desktop"_s}, QDir::Files);
+    entries.reserve(files.size());
+    bool changed = false;
+
+    for (const QFileInfo &file : files) {
+        const QString fileName = file.fileName();
+        const auto known = previous.constFind(fileName);
+        if (known != previous.constEnd() && known->modified == file.lastModified()) {
+            entries.insert(fileName, *known);
+            continue;
+        }
+
+        Entry entry;
+        entry.path = file.filePath();
+        entry.modified = file.lastModified();
+        parseDesktopFile(entry.path, entry);
+        entries.insert(fileName, entry);
+        changed = true;
+    }
+
+    changed |= entries.size() != previous.size();
+    m_files.insert(directory, entries);
+    return changed;
+}
+
+void HostDesktopIndex::rebuildExports()
+{
+    m_exportsByContainer.clear();
+    m_exportsByBasename.clear();
+
+    const QHash<QString, Entry> exported = m_files.value(exportDirectory());
+    for (auto it = exported.constBegin(); it != exported.constEnd(); ++it) {
+        if (isCloneFile(it.key())) {
+            continue;
+        }
+
+        const QString stem = it.key().chopped(DesktopSuffix.size());
+        for (qsizetype dash = stem.indexOf(QLatin1Char('-')); dash >= 0; dash = stem.indexOf(QLatin1Char('-'), dash + 1)) {
+            const QString container = stem.left(dash);
+            const QString basename = stem.mid(dash + 1);
+            if (container.isEmpty() || basename.isEmpty()) {
+                continue;
+            }
+            m_exportsByContainer[container].insert(basename, *it);
+            m_exportsByBasename[basename].insert(container);
+        }
+    }
+}
+
+void HostDesktopIndex::watch()
+{
+    QSet<QString> paths;
+    for (const QString &directory : std::as_const(m_directories)) {
+        // A directory that doesn't exist yet is noticed through its parent
+        const QString path = existingAncestor(directory);
+        if (!path.isEmpty()) {
+            paths.insert(path);
+        }
+    }
+
+    // Editing a file in place doesn't touch its directory, so the files are watched too
+    for (const auto &entries : std::as_const(m_files)) {
+        for (const Entry &entry : entries) {
+            paths.insert(entry.path);
+        }
+    }
+
+    const QStringList watchedList = m_watcher->directories() + m_watcher->files();
+    const QSet<QString> watched(watchedList.cbegin(), watchedList.cend());
+
+    const QSet<QString> removed = watched - paths;
+    if (!removed.isEmpty()) {
+        m_watcher->removePaths(removed.values());
+    }
+    const QSet<QString> added = paths - watched;
+    if (!added.isEmpty()) {
+        m_watcher->addPaths(added.values());
+    }
+}
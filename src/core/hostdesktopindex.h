@@ -0,0 +1,99 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <optional>
+
+class QFileSystemWatcher;
+class QTimer;
+
+/**
+ * @class HostDesktopIndex
+ * @brief In-memory index of the desktop files on the host
+ *
+ * distrobox-export writes "<container>-<basename>.desktop" files to the host's
+ * applications directory, and "distrobox generate-entry" writes "<container>.desktop".
+ * Instead of listing and parsing those directories on every question, the index
+ * reads them once, answers from memory and keeps itself current with a
+ * QFileSystemWatcher on the directories and the indexed files. On changes only the
+ * files whose modification time differs are parsed again.
+ *
+ * Exported files are indexed both by container and by basename. Container names
+ * may contain dashes, so a file is listed under every split of its name; lookups
+ * always use a full container name or basename, which makes this exact.
+ *
+ * GUI thread only.
+ */
+class HostDesktopIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @struct Entry
+     * @brief The parts of a desktop file the application uses
+     */
+    struct Entry {
+        QString path;
+        QString name; ///< Unlocalized Name, empty if missing
+        QString icon; ///< Icon, empty if missing
+        QDateTime modified;
+    };
+
+    /**
+     * @brief Returns the application-wide index, built on first use
+     */
+    static HostDesktopIndex *instance();
+
+    explicit HostDesktopIndex(QObject *parent = nullptr);
+
+    /**
+     * @brief Directory distrobox-export writes to, as seen from this process
+     */
+    static QString exportDirectory();
+
+    /**
+     * @brief Exported applications of @p container, by basename
+     */
+    QHash<QString, Entry> exportsOf(const QString &container) const;
+
+    /**
+     * @brief Containers that exported an application with @p basename
+     */
+    QSet<QString> containersExporting(const QString &basename) const;
+
+    /**
+     * @brief Looks a desktop file up by name, e.g. "mybox.desktop"
+     * @return The file from the first directory that has it
+     */
+    std::optional<Entry> find(const QString &fileName) const;
+
+Q_SIGNALS:
+    /**
+     * @brief Emitted after desktop files were added, changed or removed
+     */
+    void changed();
+
+private:
+    void rescan();
+    bool scanDirectory(const QString &directory);
+    void rebuildExports();
+    void watch();
+
+    QStringList m_directories; ///< In lookup order
+    QHash<QString, QHash<QString, Entry>> m_files; ///< Directory -> file name -> entry
+    QHash<QString, QHash<QString, Entry>> m_exportsByContainer; ///< Container -> basename -> entry
+    QHash<QString, QSet<QString>> m_exportsByBasename; ///< Basename -> containers
+    QFileSystemWatcher *m_watcher;
+    QTimer *m_rescanTimer;
+};
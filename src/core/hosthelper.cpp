@@ -0,0 +1,189 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "hosthelper.h"
+#include "distroboxcli.h"
+#include "shellsession.h"
+
+#include <KShell>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QPointer>
+#include <QThread>
+#include <optional>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// The helper is cheap to keep and expensive to start inside Flatpak
+constexpr int HelperIdleTimeout = 5 * 60 * 1000;
+
+// Temporary files keep the frames exact: $(...) would drop NUL bytes and trailing newlines
+const QString ScriptPrologue = uR"SH(
+out=$(mktemp) && err=$(mktemp) || exit 125
+trap 'rm -f "$out" "$err"' EXIT
+)SH"_s;
+
+// Helpers kept for CommandExecutor between commands
+constexpr qsizetype MaximumIdleSessions = 4;
+
+QList<QPointer<ShellSession>> &idleSessions()
+{
+    static QList<QPointer<ShellSession>> sessions;
+    return sessions;
+}
+
+// Reads "<number> <number> ...\n" at @p position, advancing it past the line
+std::optional<QList<qint64>> readHeader(const QByteArray &output, qsizetype &position, qsizetype fields)
+{
+    const qsizetype newline = output.indexOf('\n', position);
+    if (newline < 0) {
+        return std::nullopt;
+    }
+
+    const QList<QByteArray> parts = output.mid(position, newline - position).simplified().split(' ');
+    position = newline + 1;
+    if (parts.size() != fields) {
+        return std::nullopt;
+    }
+
+    QList<qint64> numbers;
+    for (const QByteArray &part : parts) {
+        bool ok = false;
+        numbers << part.toLongLong(&ok);
+        if (!ok) {
+            return std::nullopt;
+        }
+    }
+    return numbers;
+}
+}
+
+namespace HostHelper
+{
+bool isEnabled()
+{
+    if (QThread::currentThread() != QCoreApplication::instance()->thread()) {
+        return false;
+    }
+
+    static const bool enabled = []() {
+        const QByteArray setting = qgetenv("KONTAINER_HOST_HELPER");
+        if (!setting.isEmpty()) {
+            return setting != "0";
+        }
+        return DistroboxCli::isFlatpak();
+    }();
+    return enabled;
+}
+
+ShellSession *session()
+{
+    static QPointer<ShellSession> helper;
+    if (!helper) {
+        // hostShellArguments() puts flatpak-spawn --host in front inside Flatpak
+        helper = new ShellSession(u"sh"_s, QCoreApplication::instance());
+        helper->setIdleTimeout(HelperIdleTimeout);
+    }
+    return helper;
+}
+
+ShellSession *acquireSession()
+{
+    auto &idle = idleSessions();
+    while (!idle.isEmpty()) {
+        if (ShellSession *helper = idle.takeLast()) {
+            return helper;
+        }
+    }
+
+    auto *helper = new ShellSession(u"sh"_s, QCoreApplication::instance());
+    helper->setIdleTimeout(HelperIdleTimeout);
+    return helper;
+}
+
+void releaseSession(ShellSession *session)
+{
+    auto &idle = idleSessions();
+    if (!session || idle.contains(session)) {
+        return;
+    }
+
+    // Helpers beyond what is usually busy at once are ended instead of kept
+    if (idle.size() >= MaximumIdleSessions) {
+        session->deleteLater();
+        return;
+    }
+    idle.append(session);
+}
+
+CommandResult run(const QString &command, int timeoutMs)
+{
+    return session()->runBlocking(command, timeoutMs);
+}
+
+QList<CommandResult> runBatch(const QStringList &commands, int timeoutMs)
+{
+    if (commands.isEmpty()) {
+        return {};
+    }
+
+    const CommandResult result = session()->runBlocking(batchScript(commands), timeoutMs);
+    QList<CommandResult> results = parseBatch(result.output, commands.size());
+    if (!result.success()) {
+        qWarning() << "Host helper batch failed after" << results.size() << "of" << commands.size() << "commands" << result.errorOutput.trimmed();
+    }
+
+    // Commands the batch didn't get to count as failed, with the reason of the batch
+    while (results.size() < commands.size()) {
+        CommandResult missing;
+        missing.timedOut = result.timedOut;
+        missing.canceled = result.canceled;
+        missing.errorOutput = result.errorOutput;
+        results.append(missing);
+    }
+    return results;
+}
+
+QString batchScript(const QStringList &commands)
+{
+    QString script = ScriptPrologue;
+    for (const QString &command : commands) {
+        script += u"sh -c %1 >\"$out\" 2>\"$err\" </dev/null; code=$?; printf '%s %s %s\\n' \"$code\" \"$(wc -c <\"$out\")\" \"$(wc -c <\"$err\")\"; cat \"$out\" \"$err\"\n"_s.arg(
+            KShell::quoteArg(command));
+    }
+    return script;
+}
+
+QList<CommandResult> parseBatch(const QByteArray &output, qsizetype count)
+{
+    QList<CommandResult> results;
+    qsizetype position = 0;
+
+    while (results.size() < count) {
+        const std::optional<QList<qint64>> header = readHeader(output, position, 3);
+        if (!header) {
+            break;
+        }
+
+        const qint64 outputSize = header->at(1);
+        const qint64 errorSize = header->at(2);
+        if (outputSize < 0 || errorSize < 0 || position + outputSize + errorSize > output.size()) {
+            qWarning() << "Truncated host helper batch after" << results.size() << "results";
+            break;
+        }
+
+        CommandResult result;
+        result.exitCode = int(header->at(0));
+        result.output = output.mid(position, outputSize);
+        result.errorOutput = output.mid(position + outputSize, errorSize);
+        position += outputSize + errorSize;
+        results.append(result);
+    }
+
+    return results;
+}
+}
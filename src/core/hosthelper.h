@@ -0,0 +1,83 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "commandexecutor.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+class ShellSession;
+
+/**
+ * @brief Long-lived helper shells on the host for host commands
+ *
+ * Inside Flatpak every host command normally costs a "flatpak-spawn --host" call, i.e.
+ * a D-Bus round trip and a new host process. A helper is a shell started once through
+ * flatpak-spawn that receives requests on stdin and answers on stdout (see ShellSession
+ * for the framing), so commands only pay for the shell fork.
+ *
+ * session() serves the synchronous callers. CommandExecutor takes a helper of its own
+ * per running command from a pool, so its commands run concurrently and don't queue
+ * behind each other. Batches run several commands in one request and return every
+ * result as a length-prefixed frame.
+ *
+ * The helpers are used inside Flatpak unless KONTAINER_HOST_HELPER=0 is set. Outside
+ * Flatpak they are only used with KONTAINER_HOST_HELPER=1, which runs the same protocol
+ * over a local shell for testing.
+ */
+namespace HostHelper
+{
+/**
+ * @brief Whether host commands should go through the helper
+ *
+ * Always false on threads other than the GUI thread, the helper lives there.
+ */
+bool isEnabled();
+
+/**
+ * @brief Returns the helper shell of the synchronous callers, started on first use
+ */
+ShellSession *session();
+
+/**
+ * @brief Takes an idle helper from the pool, creating one if there is none
+ *
+ * Give it back with releaseSession() once its command finished.
+ */
+ShellSession *acquireSession();
+
+/**
+ * @brief Returns a helper taken with acquireSession() to the pool
+ */
+void releaseSession(ShellSession *session);
+
+/**
+ * @brief Runs @p command on the host and waits for its result
+ */
+CommandResult run(const QString &command, int timeoutMs = CommandExecutor::DefaultTimeout);
+
+/**
+ * @brief Runs @p commands one after the other in a single request
+ * @return One result per command, in order; results of commands that didn't run are marked failed
+ */
+QList<CommandResult> runBatch(const QStringList &commands, int timeoutMs = CommandExecutor::DefaultTimeout);
+
+/**
+ * @brief Returns the script running @p commands and printing their results as frames
+ *
+ * Each frame is a header line "<exit code> <stdout size> <stderr size>" followed by the
+ * raw standard output and standard error.
+ */
+QString batchScript(const QStringList &commands);
+
+/**
+ * @brief Splits the output of batchScript() into one result per command
+ */
+QList<CommandResult> parseBatch(const QByteArray &output, qsizetype count);
+}
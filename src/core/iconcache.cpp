@@ -0,0 +1,395 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "iconcache.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QSet>
+#include <QStandardPaths>
+#include <QTimer>
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Bump when the layout of the cache directory changes
+constexpr int IndexVersion = 1;
+
+const QString IndexFileName = u"index.json"_s;
+
+// Icons are stored in bursts, e.g. while a list of applications is decoded
+constexpr int SyncDelay = 2000;
+
+qint64 now()
+{
+    return QDateTime::currentSecsSinceEpoch();
+}
+}
+
+QVariantMap IconCache::Statistics::toVariant() const
+{
+    QVariantMap map;
+    map[u"hits"_s] = hits;
+    map[u"misses"_s] = misses;
+    map[u"negativeHits"_s] = negativeHits;
+    map[u"evictions"_s] = evictions;
+    map[u"entries"_s] = entries;
+    map[u"bytes"_s] = bytes;
+    return map;
+}
+
+IconCache *IconCache::instance()
+{
+    static IconCache cache;
+    return &cache;
+}
+
+IconCache::IconCache()
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheBase.isEmpty()) {
+        m_directory = QDir(cacheBase).filePath(u"kontainer/icons"_s);
+        QDir().mkpath(m_directory);
+    }
+    load();
+}
+
+IconCache::~IconCache()
+{
+    sync();
+}
+
+QString IconCache::entryKey(const QString &container, const QString &key)
+{
+    return container + QLatin1Char('|') + key;
+}
+
+IconCache::Lookup IconCache::lookup(const QString &container, const QString &key, QString *path)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QString cacheKey = entryKey(container, key);
+    auto it = m_entries.find(cacheKey);
+    if (it == m_entries.end()) {
+        ++m_statistics.misses;
+        return Lookup::Miss;
+    }
+
+    if (it->fileName.isEmpty()) {
+        if (now() - it->lastUsed < m_negativeTtl) {
+            ++m_statistics.negativeHits;
+            return Lookup::Missing;
+        }
+        // Long enough ago that the container may have the icon by now
+        removeEntry(cacheKey);
+        ++m_statistics.misses;
+        return Lookup::Miss;
+    }
+
+    const QString filePath = QDir(m_directory).filePath(it->fileName);
+    if (!QFileInfo::exists(filePath)) {
+        removeEntry(cacheKey);
+        ++m_statistics.misses;
+        return Lookup::Miss;
+    }
+
+    it->lastUsed = now();
+    m_dirty = true;
+    ++m_statistics.hits;
+    if (path) {
+        *path = filePath;
+    }
+    return Lookup::Hit;
+}
+
+QString IconCache::store(const QString &container, const QString &key, const QByteArray &data, const QString &suffix)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (m_directory.isEmpty() || data.isEmpty()) {
+        return {};
+    }
+
+    // Icon values can be paths or contain characters that aren't valid in file names
+    const QString cacheKey = entryKey(container, key);
+    const QString hash = QString::fromLatin1(QCryptographicHash::hash(cacheKey.toUtf8(), QCryptographicHash::Sha1).toHex());
+    QString fileName = hash + QLatin1Char('.') + (suffix.isEmpty() ? u"png"_s : suffix);
+    if (!container.isEmpty()) {
+        fileName.prepend(container + QLatin1Char('/'));
+    }
+
+    const QString filePath = QDir(m_directory).filePath(fileName);
+    QDir().mkpath(QFileInfo(filePath).path());
+
+    removeEntry(cacheKey);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit()) {
+        qWarning() << "Cannot cache icon" << key << "of" << container << file.errorString();
+        return {};
+    }
+
+    m_entries.insert(cacheKey, Entry{fileName, data.size(), now()});
+    m_bytes += data.size();
+    m_dirty = true;
+    scheduleSync();
+
+    evict();
+    return m_entries.contains(cacheKey) ? filePath : QString();
+}
+
+void IconCache::storeMissing(const QString &container, const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+
+    const QString cacheKey = entryKey(container, key);
+    removeEntry(cacheKey);
+    m_entries.insert(cacheKey, Entry{QString(), 0, now()});
+    m_dirty = true;
+    scheduleSync();
+}
+
+void IconCache::purgeContainer(const QString &container)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        const QString prefix = container + QLatin1Char('|');
+        const QStringList keys = m_entries.keys();
+        for (const QString &key : keys) {
+            if (key.startsWith(prefix)) {
+                removeEntry(key);
+            }
+        }
+
+        if (!m_directory.isEmpty() && !container.isEmpty()) {
+            QDir(QDir(m_directory).filePath(container)).removeRecursively();
+        }
+        m_dirty = true;
+    }
+
+    qDebug() << "Purged cached icons of" << container;
+    sync();
+}
+
+void IconCache::scheduleSync()
+{
+    QCoreApplication *application = QCoreApplication::instance();
+    if (!application) {
+        return;
+    }
+
+    // The timer lives on the GUI thread, stores may come from decoder threads. Not restarted
+    // while running, so a steady stream of stores still reaches the disk every SyncDelay.
+    QMetaObject::invokeMethod(
+        application,
+        [this, application]() {
+            static QTimer *timer = [this, application]() {
+                auto *syncTimer = new QTimer(application);
+                syncTimer->setSingleShot(true);
+                syncTimer->setInterval(SyncDelay);
+                QObject::connect(syncTimer, &QTimer::timeout, syncTimer, [this]() {
+                    sync();
+                });
+                return syncTimer;
+            }();
+            if (!timer->isActive()) {
+                timer->start();
+            }
+        },
+        Qt::QueuedConnection);
+}
+
+void IconCache::sync()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if (!m_dirty || m_directory.isEmpty()) {
+        return;
+    }
+
+    QJsonObject entries;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        QJsonObject entry;
+        if (!it->fileName.isEmpty()) {
+            entry[u"file"_s] = it->fileName;
+            entry[u"size"_s] = it->size;
+        }
+        entry[u"lastUsed"_s] = it->lastUsed;
+        entries[it.key()] = entry;
+    }
+
+    QJsonObject index;
+    index[u"version"_s] = IndexVersion;
+    index[u"entries"_s] = entries;
+
+    QSaveFile file(QDir(m_directory).filePath(IndexFileName));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write the icon cache index" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    if (file.commit()) {
+        m_dirty = false;
+    } else {
+        qWarning() << "Cannot write the icon cache index" << file.errorString();
+    }
+}
+
+IconCache::Statistics IconCache::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics statistics = m_statistics;
+    statistics.bytes = m_bytes;
+    statistics.entries = std::count_if(m_entries.cbegin(), m_entries.cend(), [](const Entry &entry) {
+        return !entry.fileName.isEmpty();
+    });
+    return statistics;
+}
+
+qint64 IconCache::sizeBudget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_sizeBudget;
+}
+
+void IconCache::setSizeBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_sizeBudget = bytes;
+    evict();
+}
+
+qint64 IconCache::negativeTtl() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_negativeTtl;
+}
+
+void IconCache::setNegativeTtl(qint64 seconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_negativeTtl = seconds;
+}
+
+void IconCache::load()
+{
+    if (m_directory.isEmpty()) {
+        return;
+    }
+
+    QFile file(QDir(m_directory).filePath(IndexFileName));
+    QJsonObject index;
+    if (file.open(QIODevice::ReadOnly)) {
+        index = QJsonDocument::fromJson(file.readAll()).object();
+    }
+
+    const QDir directory(m_directory);
+    const qint64 currentTime = now();
+
+    if (index.value(QLatin1String("version")).toInt() == IndexVersion) {
+        const QJsonObject entries = index.value(QLatin1String("entries")).toObject();
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            const QJsonObject object = it.value().toObject();
+
+            Entry entry;
+            entry.fileName = object.value(QLatin1String("file")).toString();
+            entry.size = object.value(QLatin1String("size")).toInteger();
+            entry.lastUsed = object.value(QLatin1String("lastUsed")).toInteger();
+
+            if (entry.fileName.isEmpty()) {
+                if (currentTime - entry.lastUsed < m_negativeTtl) {
+                    m_entries.insert(it.key(), entry);
+                }
+                continue;
+            }
+
+            // Files deleted behind our back are forgotten
+            const QFileInfo info(directory.filePath(entry.fileName));
+            if (!info.isFile()) {
+                continue;
+            }
+            entry.size = info.size();
+            m_entries.insert(it.key(), entry);
+            m_bytes += entry.size;
+        }
+    }
+
+    // Anything the index doesn't know about is left over from older versions or interrupted writes
+    QSet<QString> referenced;
+    for (const Entry &entry : std::as_const(m_entries)) {
+        if (!entry.fileName.isEmpty()) {
+            referenced.insert(entry.fileName);
+        }
+    }
+
+    qsizetype orphans = 0;
+    QDirIterator it(m_directory, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QString fileName = directory.relativeFilePath(path);
+        if (fileName != IndexFileName && !referenced.contains(fileName)) {
+            QFile::remove(path);
+            ++orphans;
+        }
+    }
+
+    m_dirty = orphans > 0 || m_entries.size() != index.value(QLatin1String("entries")).toObject().size();
+    evict();
+
+    qDebug() << "Icon cache holds" << referenced.size() << "icons," << m_bytes << "bytes; removed" << orphans << "unindexed files";
+}
+
+void IconCache::evict()
+{
+    if (m_bytes <= m_sizeBudget) {
+        return;
+    }
+
+    QList<QPair<qint64, QString>> files;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        if (!it->fileName.isEmpty()) {
+            files.append({it->lastUsed, it.key()});
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    for (const auto &file : std::as_const(files)) {
+        if (m_bytes <= m_sizeBudget) {
+            break;
+        }
+        removeEntry(file.second);
+        ++m_statistics.evictions;
+    }
+    m_dirty = true;
+}
+
+void IconCache::removeEntry(const QString &key)
+{
+    const auto it = m_entries.constFind(key);
+    if (it == m_entries.constEnd()) {
+        return;
+    }
+
+    if (!it->fileName.isEmpty()) {
+        QFile::remove(QDir(m_directory).filePath(it->fileName));
+        m_bytes -= it->size;
+    }
+    m_entries.erase(it);
+    m_dirty = true;
+}
@@ -0,0 +1,130 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVariantMap>
+
+/**
+ * @class IconCache
+ * @brief Bounded on-disk cache of icons copied out of containers
+ *
+ * Files live below the cache directory, one subdirectory per container, and an index
+ * next to them records what each file is and when it was last used. The index
+ * survives restarts, so icons are not transferred again after relaunching.
+ *
+ * Icons a container doesn't have are remembered as well, but only for
+ * negativeTtl() seconds, since installing a package may add them later. When the
+ * files exceed sizeBudget() bytes the least recently used ones are evicted.
+ *
+ * All methods may be called from any thread.
+ */
+class IconCache
+{
+public:
+    static constexpr qint64 DefaultSizeBudget = 64 * 1024 * 1024; ///< Bytes
+    static constexpr qint64 DefaultNegativeTtl = 60 * 60; ///< Seconds
+
+    /**
+     * @brief Outcome of lookup()
+     */
+    enum class Lookup {
+        Miss, ///< Nothing known about the icon
+        Hit, ///< The icon is cached
+        Missing, ///< The container doesn't have the icon, as of a recent transfer
+    };
+
+    /**
+     * @struct Statistics
+     * @brief Counters since the application started, for diagnostics
+     */
+    struct Statistics {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 negativeHits = 0; ///< Lookups answered by a remembered missing icon
+        quint64 evictions = 0; ///< Files removed to stay within the size budget
+        qsizetype entries = 0; ///< Cached files
+        qint64 bytes = 0; ///< Total size of the cached files
+
+        QVariantMap toVariant() const;
+    };
+
+    /**
+     * @brief Returns the application-wide cache, loading its index on first use
+     */
+    static IconCache *instance();
+
+    /**
+     * @brief Looks an icon up
+     * @param container Container the icon comes from, empty for images of the host
+     * @param key Icon value from the desktop file, or any other key the caller stores under
+     * @param path Set to the cached file on Lookup::Hit
+     */
+    Lookup lookup(const QString &container, const QString &key, QString *path = nullptr);
+
+    /**
+     * @brief Stores the contents of an icon
+     * @param suffix File extension, used by image readers to pick a format
+     * @return Path of the cached file, or an empty string if it couldn't be written
+     */
+    QString store(const QString &container, const QString &key, const QByteArray &data, const QString &suffix);
+
+    /**
+     * @brief Remembers that @p container doesn't have the icon
+     */
+    void storeMissing(const QString &container, const QString &key);
+
+    /**
+     * @brief Deletes everything cached for @p container, e.g. after it was removed
+     */
+    void purgeContainer(const QString &container);
+
+    /**
+     * @brief Writes the index if it changed since it was last written
+     *
+     * Changes are also written on their own a moment after they were made, so they
+     * survive a crash.
+     */
+    void sync();
+
+    Statistics statistics() const;
+
+    qint64 sizeBudget() const;
+    void setSizeBudget(qint64 bytes);
+
+    qint64 negativeTtl() const;
+    void setNegativeTtl(qint64 seconds);
+
+private:
+    struct Entry {
+        QString fileName; ///< Relative to the cache directory, empty for missing icons
+        qint64 size = 0;
+        qint64 lastUsed = 0; ///< Seconds since the epoch; for missing icons when they were found missing
+    };
+
+    IconCache();
+    ~IconCache();
+    Q_DISABLE_COPY(IconCache)
+
+    void load();
+    void evict();
+    void scheduleSync();
+    void removeEntry(const QString &key);
+
+    static QString entryKey(const QString &container, const QString &key);
+
+    mutable QMutex m_mutex;
+    QString m_directory;
+    QHash<QString, Entry> m_entries; ///< By "container|key"
+    qint64 m_bytes = 0;
+    qint64 m_sizeBudget = DefaultSizeBudget;
+    qint64 m_negativeTtl = DefaultNegativeTtl;
+    bool m_dirty = false;
+    Statistics m_statistics;
+};
@@ -0,0 +1,194 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "iconimageprovider.h"
+#include "iconcache.h"
+
+#include <QBuffer>
+#include <QCache>
+#include <QDateTime>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThread>
+#include <QUrl>
+#include <algorithm>
+#include <iterator>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Sizes icons are rasterized at; the UI draws them at small and medium icon sizes times the scale factor
+constexpr int StandardSizes[] = {16, 22, 32, 48, 64, 96, 128, 256};
+constexpr int DefaultSize = 64;
+
+// Decoded images shared between requests, in KiB
+constexpr int DecodedCacheCost = 16 * 1024;
+
+QMutex decodedMutex;
+QCache<QString, QImage> decodedImages(DecodedCacheCost);
+
+int variantSize(const QSize &requestedSize)
+{
+    const int requested = requestedSize.isValid() ? std::max(requestedSize.width(), requestedSize.height()) : DefaultSize;
+    for (int size : StandardSizes) {
+        if (size >= requested) {
+            return size;
+        }
+    }
+    return StandardSizes[std::size(StandardSizes) - 1];
+}
+
+// Reads @p path scaled to fit a @p size square; vector images are rendered at that size directly
+QImage rasterize(const QString &path, int size, QString &error)
+{
+    QImageReader reader(path);
+    const QSize originalSize = reader.size();
+    if (originalSize.isValid() && (reader.supportsOption(QImageIOHandler::ScaledSize) || originalSize.width() > size || originalSize.height() > size)) {
+        reader.setScaledSize(originalSize.scaled(size, size, Qt::KeepAspectRatio));
+    }
+
+    QImage image = reader.read();
+    if (image.isNull()) {
+        error = reader.errorString();
+        return {};
+    }
+
+    // Readers without ScaledSize support return the original size
+    if (image.width() > size || image.height() > size) {
+        image = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
+}
+
+IconImageProvider::IconImageProvider()
+{
+    m_pool.setMaxThreadCount(std::max(2, QThread::idealThreadCount() / 2));
+}
+
+IconImageProvider::~IconImageProvider()
+{
+    m_pool.waitForDone();
+}
+
+QString IconImageProvider::containerIconUrl(const QString &container, const QString &icon)
+{
+    return u"image://%1/container/%2/%3"_s.arg(QLatin1String(ProviderId), container, QString::fromLatin1(QUrl::toPercentEncoding(icon)));
+}
+
+QString IconImageProvider::hostIconUrl(const QString &path)
+{
+    return u"image://%1/host/%2"_s.arg(QLatin1String(ProviderId), QString::fromLatin1(QUrl::toPercentEncoding(path)));
+}
+
+QQuickImageResponse *IconImageProvider::requestImageResponse(const QString &id, const QSize &requestedSize)
+{
+    auto *response = new IconImageResponse(id, requestedSize);
+    m_pool.start(response);
+    return response;
+}
+
+IconImageResponse::IconImageResponse(const QString &id, const QSize &requestedSize)
+    : m_id(id)
+    , m_requestedSize(requestedSize)
+{
+    // The engine deletes the response once finished() was emitted
+    setAutoDelete(false);
+    connect(this, &IconImageResponse::decoded, this, &IconImageResponse::handleDecoded, Qt::QueuedConnection);
+}
+
+QQuickTextureFactory *IconImageResponse::textureFactory() const
+{
+    return QQuickTextureFactory::textureFactoryForImage(m_image);
+}
+
+QString IconImageResponse::errorString() const
+{
+    return m_error;
+}
+
+void IconImageResponse::handleDecoded(const QImage &image, const QString &error)
+{
+    m_image = image;
+    m_error = error;
+    Q_EMIT finished();
+}
+
+void IconImageResponse::run()
+{
+    const int size = variantSize(m_requestedSize);
+
+    // One variant per source and size; replaced sources are noticed by their mtime
+    QString container;
+    QString sourcePath;
+    QString variantKey;
+    if (m_id.startsWith(QLatin1String("container/"))) {
+        container = m_id.section(QLatin1Char('/'), 1, 1);
+        const QString icon = QUrl::fromPercentEncoding(m_id.section(QLatin1Char('/'), 2).toUtf8());
+        if (container.isEmpty() || IconCache::instance()->lookup(container, icon, &sourcePath) != IconCache::Lookup::Hit) {
+            Q_EMIT decoded({}, u"Icon %1 of %2 is not cached"_s.arg(icon, container));
+            return;
+        }
+        variantKey = icon + u"@%1"_s.arg(size);
+    } else if (m_id.startsWith(QLatin1String("host/"))) {
+        sourcePath = QUrl::fromPercentEncoding(m_id.mid(5).toUtf8());
+        const QFileInfo info(sourcePath);
+        if (!info.isFile()) {
+            Q_EMIT decoded({}, u"%1 does not exist"_s.arg(sourcePath));
+            return;
+        }
+        variantKey = sourcePath + u"@%1"_s.arg(size);
+    } else {
+        Q_EMIT decoded({}, u"Unknown icon %1"_s.arg(m_id));
+        return;
+    }
+
+    const QDateTime sourceModified = QFileInfo(sourcePath).lastModified();
+    const QString decodedKey = container + QLatin1Char('|') + variantKey + QLatin1Char('@') + QString::number(sourceModified.toSecsSinceEpoch());
+    {
+        QMutexLocker locker(&decodedMutex);
+        if (const QImage *image = decodedImages.object(decodedKey)) {
+            Q_EMIT decoded(*image, {});
+            return;
+        }
+    }
+
+    IconCache *cache = IconCache::instance();
+    QString error;
+    QImage image;
+
+    // A variant older than its source is stale; storing the new one under the same key replaces it
+    QString variantPath;
+    if (cache->lookup(container, variantKey, &variantPath) == IconCache::Lookup::Hit
+        && QFileInfo(variantPath).lastModified() >= sourceModified) {
+        image = QImage(variantPath);
+    }
+
+    if (image.isNull()) {
+        image = rasterize(sourcePath, size, error);
+        if (image.isNull()) {
+            qWarning() << "Cannot decode icon" << sourcePath << error;
+            Q_EMIT decoded({}, error);
+            return;
+        }
+
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        if (image.save(&buffer, "PNG")) {
+            cache->store(container, variantKey, png, u"png"_s);
+        }
+    }
+
+    {
+        QMutexLocker locker(&decodedMutex);
+        decodedImages.insert(decodedKey, new QImage(image), std::max<qsizetype>(1, image.sizeInBytes() / 1024));
+    }
+    Q_EMIT decoded(image, {});
+}
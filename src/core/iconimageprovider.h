@@ -0,0 +1,79 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QImage>
+#include <QQuickAsyncImageProvider>
+#include <QRunnable>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+
+/**
+ * @class IconImageProvider
+ * @brief Serves application and container icons to QML as image://kontainer-icon/ URLs
+ *
+ * Icons are decoded and rasterized on a thread pool instead of the GUI thread, at the
+ * smallest standard icon size covering the requested size. The rasterized variants are
+ * stored in the IconCache, so a large SVG or 512px PNG is only decoded once, and the
+ * decoded images are shared in memory between every delegate showing them.
+ *
+ * Two kinds of IDs are understood:
+ * - container/<container>/<icon>: an icon of a container, as cached by ContainerIcons
+ * - host/<path>: an image file on the host
+ * where <icon> and <path> are percent-encoded.
+ */
+class IconImageProvider : public QQuickAsyncImageProvider
+{
+public:
+    static constexpr auto ProviderId = "kontainer-icon";
+
+    IconImageProvider();
+    ~IconImageProvider() override;
+
+    /**
+     * @brief URL of the icon @p icon of @p container, which must be in the IconCache
+     */
+    static QString containerIconUrl(const QString &container, const QString &icon);
+
+    /**
+     * @brief URL of the image file @p path on the host
+     */
+    static QString hostIconUrl(const QString &path);
+
+    QQuickImageResponse *requestImageResponse(const QString &id, const QSize &requestedSize) override;
+
+private:
+    QThreadPool m_pool;
+};
+
+/**
+ * @class IconImageResponse
+ * @brief Decodes one icon for IconImageProvider on its thread pool
+ */
+class IconImageResponse : public QQuickImageResponse, public QRunnable
+{
+    Q_OBJECT
+
+public:
+    IconImageResponse(const QString &id, const QSize &requestedSize);
+
+    QQuickTextureFactory *textureFactory() const override;
+    QString errorString() const override;
+
+    void run() override;
+
+Q_SIGNALS:
+    void decoded(const QImage &image, const QString &error);
+
+private:
+    void handleDecoded(const QImage &image, const QString &error);
+
+    QString m_id;
+    QSize m_requestedSize;
+    QImage m_image;
+    QString m_error;
+};
@@ -0,0 +1,93 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "imagecatalog.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimeZone>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+QString cacheFilePath()
+{
+    const QString cacheBase = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (cacheBase.isEmpty()) {
+        return {};
+    }
+    return QDir(cacheBase).filePath(u"kontainer/images.json"_s);
+}
+}
+
+namespace ImageCatalog
+{
+bool Cached::isStale() const
+{
+    return !fetched.isValid() || fetched.secsTo(QDateTime::currentDateTimeUtc()) >= TimeToLive;
+}
+
+std::optional<Cached> load()
+{
+    QFile file(cacheFilePath());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return std::nullopt;
+    }
+
+    const QJsonObject catalog = QJsonDocument::fromJson(file.readAll()).object();
+    const QJsonArray images = catalog.value(QLatin1String("images")).toArray();
+    if (images.isEmpty()) {
+        return std::nullopt;
+    }
+
+    Cached cached;
+    cached.fetched = QDateTime::fromSecsSinceEpoch(catalog.value(QLatin1String("fetched")).toInteger(), QTimeZone::UTC);
+    for (const QJsonValue &value : images) {
+        const QJsonObject image = value.toObject();
+        cached.images.displayNames << image.value(QLatin1String("display")).toString();
+        cached.images.fullNames << image.value(QLatin1String("full")).toString();
+    }
+    return cached;
+}
+
+void save(const DistroboxCli::AvailableImages &images)
+{
+    const QString path = cacheFilePath();
+    if (path.isEmpty()) {
+        return;
+    }
+    QDir().mkpath(QFileInfo(path).path());
+
+    QJsonArray array;
+    for (qsizetype i = 0; i < images.displayNames.size() && i < images.fullNames.size(); ++i) {
+        QJsonObject image;
+        image[u"display"_s] = images.displayNames.at(i);
+        image[u"full"_s] = images.fullNames.at(i);
+        array.append(image);
+    }
+
+    QJsonObject catalog;
+    catalog[u"fetched"_s] = QDateTime::currentSecsSinceEpoch();
+    catalog[u"images"_s] = array;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Cannot write the image catalog" << file.errorString();
+        return;
+    }
+    file.write(QJsonDocument(catalog).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Cannot write the image catalog" << file.errorString();
+    }
+}
+}
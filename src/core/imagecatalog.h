@@ -0,0 +1,48 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "distroboxcli.h"
+
+#include <QDateTime>
+#include <optional>
+
+/**
+ * @brief On-disk copy of the image list printed by "distrobox create -C"
+ *
+ * Listing the images runs distrobox, which takes long enough to be noticeable, while
+ * the list only changes with distrobox updates. The last list is therefore kept in the
+ * cache directory and only fetched again once it is older than TimeToLive.
+ */
+namespace ImageCatalog
+{
+constexpr qint64 TimeToLive = 24 * 60 * 60; ///< Seconds
+
+/**
+ * @struct Cached
+ * @brief Image list loaded from disk
+ */
+struct Cached {
+    DistroboxCli::AvailableImages images;
+    QDateTime fetched; ///< When the list was fetched from distrobox
+
+    /**
+     * @brief Whether the list is older than TimeToLive and should be fetched again
+     */
+    bool isStale() const;
+};
+
+/**
+ * @brief Loads the saved image list
+ * @return The list, or std::nullopt if none was saved or it can't be read
+ */
+std::optional<Cached> load();
+
+/**
+ * @brief Saves @p images as fetched now
+ */
+void save(const DistroboxCli::AvailableImages &images);
+}
@@ -0,0 +1,240 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "imagepuller.h"
+#include "engineapiclient.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QStringList>
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Progress messages arrive many times a second during a pull, the UI doesn't need them all
+constexpr int ProgressInterval = 100;
+}
+
+ImagePull::ImagePull(const QString &image, QObject *parent)
+    : QObject(parent)
+    , m_image(image)
+{
+}
+
+QString ImagePull::image() const
+{
+    return m_image;
+}
+
+ImagePull::State ImagePull::state() const
+{
+    return m_state;
+}
+
+bool ImagePull::isFinished() const
+{
+    return m_state != Running;
+}
+
+const ImagePullProgress &ImagePull::progress() const
+{
+    return m_progress;
+}
+
+qint64 ImagePull::bytesDone() const
+{
+    return m_progress.bytesDone();
+}
+
+qint64 ImagePull::bytesTotal() const
+{
+    return m_progress.bytesTotal();
+}
+
+QString ImagePull::error() const
+{
+    return m_error;
+}
+
+void ImagePull::start(const QString &socketPath)
+{
+    m_timer.start();
+
+    auto *progressTimer = new QTimer(this);
+    progressTimer->setSingleShot(true);
+    progressTimer->setInterval(ProgressInterval);
+    connect(progressTimer, &QTimer::timeout, this, &ImagePull::progressChanged);
+
+    m_api = new EngineApiClient(socketPath, this);
+    const QFuture<ApiResponse> future = m_api->pullImage(m_image, [this, progressTimer](const QByteArray &chunk) {
+        if (m_progress.addJson(chunk) && !progressTimer->isActive()) {
+            progressTimer->start();
+        }
+    });
+
+    EngineApiClient::onFinished(future, this, [this, progressTimer](const ApiResponse &response) {
+        progressTimer->stop();
+        if (m_api) {
+            m_api->deleteLater();
+        }
+
+        if (m_state == Canceled) {
+            finish(Canceled);
+            return;
+        }
+
+        if (response.success() && m_progress.error().isEmpty()) {
+            qDebug() << "Pulled" << m_image << "through the engine API in" << m_timer.elapsed() << "ms," << m_progress.bytesTotal() << "bytes in"
+                     << m_progress.layers().size() << "layers";
+            finish(Succeeded);
+        } else {
+            m_error = m_progress.error().isEmpty() ? QString::fromUtf8(response.body).trimmed() : m_progress.error();
+            qWarning() << "Engine API pull of" << m_image << "failed:" << response.statusCode << m_error;
+            finish(Failed);
+        }
+    });
+}
+
+void ImagePull::cancel()
+{
+    if (isFinished()) {
+        return;
+    }
+
+    // Dropping the connection ends the request, its handler emits finished()
+    m_state = Canceled;
+    if (m_api) {
+        m_api->deleteLater();
+    }
+}
+
+void ImagePull::finish(State state)
+{
+    m_state = state;
+    Q_EMIT progressChanged();
+    Q_EMIT finished(state == Succeeded);
+}
+
+ImagePuller *ImagePuller::instance()
+{
+    static ImagePuller *puller = new ImagePuller(QCoreApplication::instance());
+    return puller;
+}
+
+ImagePuller::ImagePuller(QObject *parent)
+    : QObject(parent)
+{
+}
+
+QString ImagePuller::normalizedReference(const QString &image)
+{
+    const QString reference = image.trimmed();
+    if (reference.contains(QLatin1Char('@'))) {
+        return reference;
+    }
+
+    // A colon before the last slash belongs to a registry port, not a tag
+    const qsizetype lastSlash = reference.lastIndexOf(QLatin1Char('/'));
+    if (reference.indexOf(QLatin1Char(':'), lastSlash + 1) > lastSlash) {
+        return reference;
+    }
+    return reference + u":latest"_s;
+}
+
+ImagePull *ImagePuller::pull(const QString &image, QObject *holder)
+{
+    const QString socketPath = EngineApiClient::defaultSocketPath();
+    if (socketPath.isEmpty() || image.trimmed().isEmpty()) {
+        return nullptr;
+    }
+
+    const QString reference = normalizedReference(image);
+    Entry &entry = m_pulls[reference];
+    entry.holders.insert(holder);
+    connect(holder, &QObject::destroyed, this, &ImagePuller::releaseHolder, Qt::UniqueConnection);
+
+    if (entry.pull) {
+        qDebug() << "Sharing the" << (entry.pull->isFinished() ? "finished" : "running") << "pull of" << reference << "with"
+                 << entry.holders.size() << "holders";
+        return entry.pull;
+    }
+
+    auto *pull = new ImagePull(reference, this);
+    entry.pull = pull;
+
+    connect(pull, &ImagePull::finished, this, [this, reference, pull](bool success) {
+        if (!success) {
+            // Failed and canceled pulls are not worth remembering, the next request tries again
+            drop(reference, pull);
+            return;
+        }
+        QTimer::singleShot(RecentPullLifetime, pull, [this, reference, pull]() {
+            const auto it = m_pulls.find(reference);
+            if (it == m_pulls.end() || it->pull != pull) {
+                return;
+            }
+            if (it->holders.isEmpty()) {
+                drop(reference, pull);
+            } else {
+                it->expired = true;
+            }
+        });
+    });
+
+    pull->start(socketPath);
+    return pull;
+}
+
+void ImagePuller::release(const QString &image, QObject *holder)
+{
+    const QString reference = normalizedReference(image);
+    const auto it = m_pulls.find(reference);
+    if (it == m_pulls.end() || !it->holders.remove(holder) || !it->holders.isEmpty()) {
+        return;
+    }
+
+    ImagePull *pull = it->pull;
+    if (!pull) {
+        m_pulls.erase(it);
+    } else if (!pull->isFinished()) {
+        // Closing the create dialog for an assemble, or reopening it, picks the pull up again
+        QTimer::singleShot(ReleaseGracePeriod, pull, [this, reference, pull]() {
+            const auto it = m_pulls.find(reference);
+            if (it == m_pulls.end() || it->pull != pull || !it->holders.isEmpty() || pull->isFinished()) {
+                return;
+            }
+            qDebug() << "Nobody waits for" << reference << "anymore, canceling its pull";
+            m_pulls.erase(it);
+            // The finished handler deletes it once the request is gone
+            pull->cancel();
+        });
+    } else if (it->expired) {
+        drop(reference, pull);
+    }
+}
+
+void ImagePuller::releaseHolder(QObject *holder)
+{
+    QStringList references;
+    for (auto it = m_pulls.cbegin(); it != m_pulls.cend(); ++it) {
+        if (it->holders.contains(holder)) {
+            references.append(it.key());
+        }
+    }
+    for (const QString &reference : std::as_const(references)) {
+        release(reference, holder);
+    }
+}
+
+void ImagePuller::drop(const QString &reference, ImagePull *pull)
+{
+    const auto it = m_pulls.find(reference);
+    if (it != m_pulls.end() && it->pull == pull) {
+        m_pulls.erase(it);
+    }
+    pull->deleteLater();
+}
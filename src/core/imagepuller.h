@@ -0,0 +1,133 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "imagepullprogress.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+#include <QPointer>
+#include <QSet>
+#include <QString>
+#include <qqmlintegration.h>
+
+class EngineApiClient;
+
+/**
+ * @class ImagePull
+ * @brief One image pull through the engine API, shared by everyone waiting for the image
+ *
+ * Created and owned by ImagePuller.
+ */
+class ImagePull : public QObject
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Returned by distroBoxManager.prepullImage()")
+
+    Q_PROPERTY(QString image READ image CONSTANT)
+    Q_PROPERTY(State state READ state NOTIFY finished)
+    Q_PROPERTY(qint64 bytesDone READ bytesDone NOTIFY progressChanged)
+    Q_PROPERTY(qint64 bytesTotal READ bytesTotal NOTIFY progressChanged)
+
+public:
+    enum State {
+        Running,
+        Succeeded,
+        Failed,
+        Canceled,
+    };
+    Q_ENUM(State)
+
+    QString image() const;
+    State state() const;
+    bool isFinished() const;
+
+    const ImagePullProgress &progress() const;
+    qint64 bytesDone() const;
+    qint64 bytesTotal() const;
+
+    /**
+     * @brief Why the pull failed, empty if it didn't
+     */
+    QString error() const;
+
+Q_SIGNALS:
+    void progressChanged();
+    void finished(bool success);
+
+private:
+    friend class ImagePuller;
+
+    ImagePull(const QString &image, QObject *parent);
+
+    void start(const QString &socketPath);
+    void cancel();
+    void finish(State state);
+
+    QString m_image;
+    State m_state = Running;
+    ImagePullProgress m_progress;
+    QString m_error;
+    QPointer<EngineApiClient> m_api; ///< Connection of the pull; a pull would hold up every other API request
+    QElapsedTimer m_timer;
+};
+
+/**
+ * @class ImagePuller
+ * @brief Deduplicates image pulls: every request for an image shares one in-flight pull
+ *
+ * A pull runs as long as someone holds it. Holders are arbitrary objects, e.g. a
+ * ContainerCreateJob or the create dialog's pre-pull; a pull nobody holds anymore is
+ * canceled after ReleaseGracePeriod, and a holder that is destroyed releases its pulls.
+ *
+ * Successful pulls are remembered for RecentPullLifetime, so a create right after a
+ * pre-pull doesn't ask the registry again.
+ */
+class ImagePuller : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RecentPullLifetime = 10 * 60 * 1000; ///< Milliseconds
+    static constexpr int ReleaseGracePeriod = 30 * 1000; ///< Milliseconds a running pull outlives its last holder
+
+    /**
+     * @brief Returns the application-wide puller
+     */
+    static ImagePuller *instance();
+
+    explicit ImagePuller(QObject *parent = nullptr);
+
+    /**
+     * @brief Image reference used to match requests, with the implied ":latest" tag
+     */
+    static QString normalizedReference(const QString &image);
+
+    /**
+     * @brief Returns the pull of @p image for @p holder, starting one if none is running
+     * @return The pull, possibly finished already; nullptr if the engine API isn't reachable
+     */
+    ImagePull *pull(const QString &image, QObject *holder);
+
+    /**
+     * @brief Gives up @p holder's interest in @p image; a pull nobody is left for is canceled
+     */
+    void release(const QString &image, QObject *holder);
+
+private:
+    struct Entry {
+        QPointer<ImagePull> pull;
+        QSet<QObject *> holders;
+        bool expired = false; ///< Succeeded longer than RecentPullLifetime ago, dropped with its last holder
+    };
+
+    void releaseHolder(QObject *holder);
+    void drop(const QString &reference, ImagePull *pull);
+
+    QHash<QString, Entry> m_pulls; ///< By normalized reference
+};
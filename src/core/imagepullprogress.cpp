@@ -0,0 +1,189 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "imagepullprogress.h"
+
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QVariantMap>
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Statuses after which a layer needs nothing from the network anymore
+bool isDownloaded(const QString &status)
+{
+    return status == QLatin1String("Download complete") || status == QLatin1String("Verifying Checksum") || status == QLatin1String("Extracting")
+        || status == QLatin1String("Pull complete") || status == QLatin1String("Already exists");
+}
+
+bool isFinal(const QString &status)
+{
+    return status == QLatin1String("Pull complete") || status == QLatin1String("Already exists");
+}
+}
+
+bool ImagePullProgress::addJson(const QByteArray &chunk)
+{
+    m_pending += chunk;
+
+    bool changed = false;
+    qsizetype start = 0;
+    qsizetype newline;
+    while ((newline = m_pending.indexOf('\n', start)) >= 0) {
+        const QByteArray line = m_pending.mid(start, newline - start).trimmed();
+        start = newline + 1;
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        const QJsonDocument document = QJsonDocument::fromJson(line);
+        if (document.isObject()) {
+            applyMessage(document.object());
+            changed = true;
+        }
+    }
+    m_pending.remove(0, start);
+
+    // The last message isn't always followed by a newline
+    if (!m_pending.isEmpty()) {
+        const QJsonDocument document = QJsonDocument::fromJson(m_pending);
+        if (document.isObject()) {
+            applyMessage(document.object());
+            m_pending.clear();
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+bool ImagePullProgress::addLine(const QString &line)
+{
+    // podman: "Copying blob 4f4fb700ef54 done", "Copying blob sha256:4f4f... skipped: already exists"
+    static const QRegularExpression podmanBlob(uR"(^Copying blob (?:sha256:)?([0-9a-f]{12,})\b\s*(.*)$)"_s);
+    // docker: "4f4fb700ef54: Pull complete"
+    static const QRegularExpression dockerLayer(uR"(^([0-9a-f]{12}): (.+)$)"_s);
+
+    const QString trimmed = line.trimmed();
+    if (const QRegularExpressionMatch match = podmanBlob.match(trimmed); match.hasMatch()) {
+        const QString detail = match.captured(2);
+        Layer &entry = layer(match.captured(1).left(12));
+        if (detail.contains(u"already exists"_s)) {
+            entry.status = u"Already exists"_s;
+            entry.done = true;
+        } else if (detail.startsWith(u"done"_s)) {
+            entry.status = u"Pull complete"_s;
+            entry.done = true;
+        } else if (!entry.done) {
+            entry.status = u"Downloading"_s;
+        }
+        return true;
+    }
+
+    if (const QRegularExpressionMatch match = dockerLayer.match(trimmed); match.hasMatch()) {
+        Layer &entry = layer(match.captured(1));
+        entry.status = match.captured(2);
+        entry.done = entry.done || isFinal(entry.status);
+        return true;
+    }
+
+    return false;
+}
+
+const QList<ImagePullProgress::Layer> &ImagePullProgress::layers() const
+{
+    return m_layers;
+}
+
+qint64 ImagePullProgress::bytesDone() const
+{
+    qint64 bytes = 0;
+    for (const Layer &entry : m_layers) {
+        bytes += entry.current;
+    }
+    return bytes;
+}
+
+qint64 ImagePullProgress::bytesTotal() const
+{
+    qint64 bytes = 0;
+    for (const Layer &entry : m_layers) {
+        bytes += entry.total;
+    }
+    return bytes;
+}
+
+int ImagePullProgress::layersDone() const
+{
+    return int(std::count_if(m_layers.cbegin(), m_layers.cend(), [](const Layer &entry) {
+        return entry.done;
+    }));
+}
+
+QString ImagePullProgress::error() const
+{
+    return m_error;
+}
+
+QVariantList ImagePullProgress::layersVariant() const
+{
+    QVariantList list;
+    list.reserve(m_layers.size());
+    for (const Layer &entry : m_layers) {
+        list.append(QVariantMap{
+            {u"id"_s, entry.id},
+            {u"status"_s, entry.status},
+            {u"current"_s, entry.current},
+            {u"total"_s, entry.total},
+            {u"done"_s, entry.done},
+        });
+    }
+    return list;
+}
+
+void ImagePullProgress::applyMessage(const QJsonObject &message)
+{
+    // Errors come as {"error": ...} in the stream, or as {"message": ...} with an error status
+    if (message.contains(u"error"_s)) {
+        m_error = message.value(u"error"_s).toString();
+        return;
+    }
+    if (message.contains(u"message"_s) && !message.contains(u"status"_s)) {
+        m_error = message.value(u"message"_s).toString();
+        return;
+    }
+
+    // Messages without an ID, or with the tag as ID, are about the image as a whole
+    const QString id = message.value(u"id"_s).toString();
+    const QString status = message.value(u"status"_s).toString();
+    if (id.isEmpty() || status.startsWith(u"Pulling from"_s)) {
+        return;
+    }
+
+    Layer &entry = layer(id);
+    entry.status = status;
+
+    const QJsonObject detail = message.value(u"progressDetail"_s).toObject();
+    if (status == QLatin1String("Downloading")) {
+        entry.current = detail.value(u"current"_s).toInteger(entry.current);
+        entry.total = detail.value(u"total"_s).toInteger(entry.total);
+    } else if (isDownloaded(status)) {
+        entry.current = entry.total;
+    }
+    entry.done = entry.done || isFinal(status);
+}
+
+ImagePullProgress::Layer &ImagePullProgress::layer(const QString &id)
+{
+    for (Layer &entry : m_layers) {
+        if (entry.id == id) {
+            return entry;
+        }
+    }
+    m_layers.append(Layer{id});
+    return m_layers.last();
+}
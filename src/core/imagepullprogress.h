@@ -0,0 +1,73 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+#include <QString>
+#include <QVariantList>
+
+/**
+ * @class ImagePullProgress
+ * @brief Layer by layer state of an image pull, built from the engine's progress output
+ *
+ * Two sources are understood: the JSON messages of the engine API's /images/create,
+ * which carry byte counts, and the lines "podman pull" and "docker pull" print without
+ * a terminal, which only tell which layers are being fetched and which are done.
+ */
+class ImagePullProgress
+{
+public:
+    struct Layer {
+        QString id;
+        QString status; ///< Last status the engine reported, e.g. "Downloading" or "Pull complete"
+        qint64 current = 0; ///< Bytes downloaded
+        qint64 total = 0; ///< Compressed size in bytes, 0 if not known yet
+        bool done = false;
+    };
+
+    /**
+     * @brief Applies a chunk of the API's newline separated JSON messages
+     * @return true if the state changed
+     */
+    bool addJson(const QByteArray &chunk);
+
+    /**
+     * @brief Applies one line of CLI pull output
+     * @return true if the line was about a layer
+     */
+    bool addLine(const QString &line);
+
+    const QList<Layer> &layers() const;
+
+    qint64 bytesDone() const;
+
+    /**
+     * @brief Sum of the layer sizes known so far; grows while the pull discovers layers
+     */
+    qint64 bytesTotal() const;
+
+    int layersDone() const;
+
+    /**
+     * @brief Error the engine reported, empty if there was none
+     */
+    QString error() const;
+
+    /**
+     * @brief Layers as maps with "id", "status", "current", "total" and "done", for QML
+     */
+    QVariantList layersVariant() const;
+
+private:
+    void applyMessage(const QJsonObject &message);
+    Layer &layer(const QString &id);
+
+    QList<Layer> m_layers;
+    QByteArray m_pending; ///< Incomplete JSON message at the end of the last chunk
+    QString m_error;
+};
@@ -0,0 +1,187 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+
+/**
+ * @class KeyedListModel
+ * @brief List model whose rows have a unique key, updated with the fewest possible changes
+ *
+ * setRows() compares a new snapshot with the current rows by key and only emits the
+ * removals, moves, insertions and data changes needed to get there. Views keep their
+ * delegates and scroll position, and the signals emitted scale with what changed
+ * rather than with the size of the list.
+ *
+ * @tparam Row Value type of a row; must be comparable with ==
+ */
+template<typename Row>
+class KeyedListModel : public QAbstractListModel
+{
+public:
+    using QAbstractListModel::QAbstractListModel;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override
+    {
+        return parent.isValid() ? 0 : int(m_rows.size());
+    }
+
+    int count() const
+    {
+        return int(m_rows.size());
+    }
+
+    /**
+     * @brief Row of @p key, -1 if there is none
+     */
+    int rowOf(const QString &key) const
+    {
+        return m_rowByKey.value(key, -1);
+    }
+
+    const QList<Row> &rows() const
+    {
+        return m_rows;
+    }
+
+protected:
+    /**
+     * @brief Returns the key identifying @p row
+     */
+    virtual QString keyOf(const Row &row) const = 0;
+
+    /**
+     * @brief Replaces the rows by @p rows, later duplicates of a key are dropped
+     */
+    void setRows(const QList<Row> &rows)
+    {
+        QList<Row> next;
+        QSet<QString> keys;
+        next.reserve(rows.size());
+        keys.reserve(rows.size());
+        for (const Row &row : rows) {
+            const QString key = keyOf(row);
+            if (!keys.contains(key)) {
+                keys.insert(key);
+                next.append(row);
+            }
+        }
+
+        // Remove rows that are gone, a contiguous run at a time
+        for (int last = count() - 1; last >= 0; --last) {
+            if (keys.contains(keyOf(m_rows.at(last)))) {
+                continue;
+            }
+            int first = last;
+            while (first > 0 && !keys.contains(keyOf(m_rows.at(first - 1)))) {
+                --first;
+            }
+            beginRemoveRows(QModelIndex(), first, last);
+            m_rows.remove(first, last - first + 1);
+            endRemoveRows();
+            last = first;
+        }
+
+        // What is left is a subset of next; bring it into next's order, inserting the new rows
+        for (int row = 0; row < next.size(); ++row) {
+            const QString key = keyOf(next.at(row));
+
+            if (row >= count() || keyOf(m_rows.at(row)) != key) {
+                int from = -1;
+                for (int candidate = row + 1; candidate < count(); ++candidate) {
+                    if (keyOf(m_rows.at(candidate)) == key) {
+                        from = candidate;
+                        break;
+                    }
+                }
+
+                if (from < 0) {
+                    beginInsertRows(QModelIndex(), row, row);
+                    m_rows.insert(row, next.at(row));
+                    endInsertRows();
+                    continue;
+                }
+
+                beginMoveRows(QModelIndex(), from, from, QModelIndex(), row);
+                m_rows.move(from, row);
+                endMoveRows();
+            }
+
+            if (!(m_rows.at(row) == next.at(row))) {
+                m_rows[row] = next.at(row);
+                Q_EMIT dataChanged(index(row), index(row));
+            }
+        }
+
+        reindex();
+    }
+
+    /**
+     * @brief Updates the row with the key of @p value, or appends it if there is none
+     */
+    void insertOrUpdateRow(const Row &value)
+    {
+        const int row = rowOf(keyOf(value));
+        if (row >= 0) {
+            updateRow(row, value);
+            return;
+        }
+
+        beginInsertRows(QModelIndex(), count(), count());
+        m_rowByKey.insert(keyOf(value), count());
+        m_rows.append(value);
+        endInsertRows();
+    }
+
+    /**
+     * @brief Replaces row @p row by @p value if they differ
+     * @param roles Roles that may have changed, empty for all
+     */
+    void updateRow(int row, const Row &value, const QList<int> &roles = {})
+    {
+        if (m_rows.at(row) == value) {
+            return;
+        }
+
+        const QString key = keyOf(value);
+        if (keyOf(m_rows.at(row)) != key) {
+            m_rowByKey.remove(keyOf(m_rows.at(row)));
+            m_rowByKey.insert(key, row);
+        }
+        m_rows[row] = value;
+        Q_EMIT dataChanged(index(row), index(row), roles);
+    }
+
+    void removeKey(const QString &key)
+    {
+        const int row = rowOf(key);
+        if (row < 0) {
+            return;
+        }
+
+        beginRemoveRows(QModelIndex(), row, row);
+        m_rows.removeAt(row);
+        reindex();
+        endRemoveRows();
+    }
+
+private:
+    void reindex()
+    {
+        m_rowByKey.clear();
+        m_rowByKey.reserve(m_rows.size());
+        for (int row = 0; row < m_rows.size(); ++row) {
+            m_rowByKey.insert(keyOf(m_rows.at(row)), row);
+        }
+    }
+
+    QList<Row> m_rows;
+    QHash<QString, int> m_rowByKey; ///< Row per key
+};
@@ -4,9 +4,10 @@
  */
 
 #include "packageinstallcommand.h"
+#include "distroclassifier.h"
 
 #include <KShell>
-#include <QRegularExpression>
+#include <QStringList>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -15,38 +16,46 @@ namespace PackageInstallCommand
 
 std::optional<QString> forImage(const QString &image, const QString &packagePath)
 {
-    const QString imageLower = image.toLower();
-    const QString quotedPath = KShell::quoteArg(packagePath);
-
-    if (imageLower.contains(QRegularExpression(u"fedora|bluefin|ublue-os/fedora|fedoraproject\\.org/fedora"_s))) {
-        return u"sudo dnf install %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"ubuntu|toolbx/ubuntu|ubuntu-toolbox|debian|neurodebian|mint|kali|neon"_s))) {
-        return u"sudo apt install %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"opensuse|tumbleweed|leap"_s))) {
-        return u"sudo zypper install %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"arch|blackarch|ublue-os/arch|bazzite-arch|arch-toolbox"_s))) {
-        return u"sudo pacman -U --noconfirm %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"centos|rhel|rocky|alma|ubi[789]?/|amazonlinux|oracle"_s))) {
-        return u"sudo dnf install %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"alpine"_s))) {
-        return u"sudo apk add --allow-untrusted %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"void"_s))) {
-        return u"sudo xbps-install %1"_s.arg(quotedPath);
-    }
-    if (imageLower.contains(QRegularExpression(u"gentoo"_s))) {
-        return u"sudo emerge %1"_s.arg(quotedPath);
+    const QString installCommand = DistroClassifier::classify(image).installCommand;
+    if (installCommand.isEmpty()) {
+        return std::nullopt;
     }
-    if (imageLower.contains(QRegularExpression(u"slack"_s))) {
-        return u"sudo installpkg %1"_s.arg(quotedPath);
+    return installCommand.arg(KShell::quoteArg(packagePath));
+}
+
+std::optional<QString> forOsRelease(const QByteArray &osRelease, const QString &packagePath)
+{
+    QStringList ids;
+    for (const QByteArray &line : osRelease.split('\n')) {
+        const qsizetype equals = line.indexOf('=');
+        if (equals < 0) {
+            continue;
+        }
+
+        const QByteArray key = line.left(equals).trimmed();
+        if (key != "ID" && key != "ID_LIKE") {
+            continue;
+        }
+
+        QString value = QString::fromUtf8(line.mid(equals + 1)).trimmed();
+        if (value.size() >= 2 && (value.startsWith(QLatin1Char('"')) || value.startsWith(QLatin1Char('\'')))) {
+            value = value.mid(1, value.size() - 2);
+        }
+
+        const QStringList values = value.toLower().split(QLatin1Char(' '), Qt::SkipEmptyParts);
+        if (key == "ID") {
+            ids = values + ids;
+        } else {
+            ids += values;
+        }
     }
-    if (imageLower.contains(QRegularExpression(u"wolfi|chainguard"_s))) {
-        return u"sudo apk add --allow-untrusted %1"_s.arg(quotedPath);
+
+    // os-release IDs go through the same classifier as image names, e.g. "fedora" or "opensuse-tumbleweed"
+    for (const QString &id : std::as_const(ids)) {
+        const QString installCommand = DistroClassifier::classify(id).installCommand;
+        if (!installCommand.isEmpty()) {
+            return installCommand.arg(KShell::quoteArg(packagePath));
+        }
     }
 
     return std::nullopt;
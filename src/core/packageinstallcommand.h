@@ -5,10 +5,20 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QString>
 #include <optional>
 
 namespace PackageInstallCommand
 {
 std::optional<QString> forImage(const QString &image, const QString &packagePath);
+
+/**
+ * @brief Picks the install command from the container's /etc/os-release
+ *
+ * More reliable than guessing from the image name, which says nothing about
+ * custom or renamed images. ID is tried first, then every entry of ID_LIKE, each
+ * mapped through DistroClassifier like an image name.
+ */
+std::optional<QString> forOsRelease(const QByteArray &osRelease, const QString &packagePath);
 }
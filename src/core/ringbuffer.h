@@ -0,0 +1,80 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QList>
+
+/**
+ * @class RingBuffer
+ * @brief Fixed-capacity buffer that overwrites its oldest element once full
+ *
+ * The storage is allocated once, appending never allocates or moves elements.
+ * Elements are indexed from the oldest (0) to the newest (size() - 1).
+ *
+ * @tparam T Element type; must be default constructible and copyable
+ */
+template<typename T>
+class RingBuffer
+{
+public:
+    explicit RingBuffer(qsizetype capacity = 0)
+        : m_elements(capacity)
+    {
+    }
+
+    qsizetype capacity() const
+    {
+        return m_elements.size();
+    }
+
+    qsizetype size() const
+    {
+        return m_size;
+    }
+
+    bool isEmpty() const
+    {
+        return m_size == 0;
+    }
+
+    void append(const T &element)
+    {
+        if (m_elements.isEmpty()) {
+            return;
+        }
+        m_elements[(m_first + m_size) % capacity()] = element;
+        if (m_size < capacity()) {
+            ++m_size;
+        } else {
+            m_first = (m_first + 1) % capacity();
+        }
+    }
+
+    const T &at(qsizetype index) const
+    {
+        Q_ASSERT(index >= 0 && index < m_size);
+        return m_elements.at((m_first + index) % capacity());
+    }
+
+    /**
+     * @brief Newest element; the buffer must not be empty
+     */
+    const T &last() const
+    {
+        return at(m_size - 1);
+    }
+
+    void clear()
+    {
+        m_first = 0;
+        m_size = 0;
+    }
+
+private:
+    QList<T> m_elements;
+    qsizetype m_first = 0; ///< Index of the oldest element in m_elements
+    qsizetype m_size = 0;
+};
@@ -0,0 +1,434 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "shellsession.h"
+#include "distroboxcli.h"
+
+#include <KShell>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QEventLoop>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPointer>
+#include <QProcess>
+#include <QRandomGenerator>
+#include <QTimer>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Time a shell gets to exit after SIGTERM before it is killed
+constexpr int TerminateGracePeriod = 3000;
+
+// Standard error kept per script, older output is dropped
+constexpr qsizetype MaximumErrorOutput = 64 * 1024;
+
+QByteArray createMarker()
+{
+    return "KONTAINER-" + QByteArray::number(QRandomGenerator::global()->generate64(), 16);
+}
+
+QHash<QString, QPointer<ShellSession>> &containerSessions()
+{
+    static QHash<QString, QPointer<ShellSession>> sessions;
+    return sessions;
+}
+}
+
+ShellSession::ShellSession(const QString &shellCommand, QObject *parent)
+    : QObject(parent)
+    , m_shellCommand(shellCommand)
+    , m_idleTimer(new QTimer(this))
+    , m_requestTimer(new QTimer(this))
+{
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(DefaultIdleTimeout);
+    connect(m_idleTimer, &QTimer::timeout, this, &ShellSession::close);
+
+    m_requestTimer->setSingleShot(true);
+    connect(m_requestTimer, &QTimer::timeout, this, [this]() {
+        abortCurrent(true);
+    });
+}
+
+ShellSession::~ShellSession()
+{
+    for (const Request &request : std::as_const(m_queue)) {
+        request.promise->future().cancel();
+        request.promise->finish();
+    }
+    m_queue.clear();
+
+    if (m_current) {
+        m_current->promise->future().cancel();
+        m_current->promise->finish();
+        m_current.reset();
+    }
+
+    if (m_process) {
+        m_process->closeWriteChannel();
+        m_process->waitForFinished(1000);
+    }
+}
+
+ShellSession *ShellSession::forContainer(const QString &container)
+{
+    auto &sessions = containerSessions();
+    QPointer<ShellSession> &session = sessions[container];
+    if (!session) {
+        session = new ShellSession(u"distrobox enter %1 -- sh"_s.arg(KShell::quoteArg(container)), QCoreApplication::instance());
+    }
+    return session;
+}
+
+void ShellSession::closeContainerSession(const QString &container)
+{
+    const QPointer<ShellSession> session = containerSessions().value(container);
+    if (session) {
+        session->close();
+    }
+}
+
+QFuture<CommandResult> ShellSession::run(const QString &script, int timeoutMs, const OutputHandler &onOutput)
+{
+    const auto promise = enqueue(script, timeoutMs, onOutput);
+    const QFuture<CommandResult> future = promise->future();
+
+    auto *watcher = new QFutureWatcher<CommandResult>(this);
+    connect(watcher, &QFutureWatcherBase::canceled, this, [this, promise]() {
+        dropRequest(promise, false);
+    });
+    connect(watcher, &QFutureWatcherBase::finished, watcher, &QObject::deleteLater);
+    watcher->setFuture(future);
+
+    processQueue();
+    return future;
+}
+
+CommandResult ShellSession::runBlocking(const QString &script, int timeoutMs, const OutputHandler &onOutput)
+{
+    // A nested event loop keeps the window repainting while the script runs, and lets the
+    // request timer enforce the timeout
+    CommandResult result;
+    QEventLoop loop;
+    CommandExecutor::onFinished(run(script, timeoutMs, onOutput), &loop, [&loop, &result](const CommandResult &finished) {
+        result = finished;
+        loop.quit();
+    });
+    loop.exec();
+    return result;
+}
+
+std::shared_ptr<QPromise<CommandResult>> ShellSession::enqueue(const QString &script, int timeoutMs, const OutputHandler &onOutput)
+{
+    Request request;
+    request.script = script;
+    request.timeoutMs = timeoutMs;
+    request.onOutput = onOutput;
+    request.promise = std::make_shared<QPromise<CommandResult>>();
+    request.promise->start();
+
+    m_idleTimer->stop();
+    m_queue.enqueue(request);
+    return request.promise;
+}
+
+int ShellSession::idleTimeout() const
+{
+    return m_idleTimer->interval();
+}
+
+void ShellSession::setIdleTimeout(int idleTimeoutMs)
+{
+    m_idleTimer->setInterval(idleTimeoutMs);
+}
+
+bool ShellSession::isRunning() const
+{
+    return m_process && m_process->state() != QProcess::NotRunning;
+}
+
+void ShellSession::close()
+{
+    m_idleTimer->stop();
+    if (!m_process || m_current) {
+        return;
+    }
+
+    // End of input makes the shell exit on its own
+    QProcess *process = m_process;
+    discardProcess();
+    process->closeWriteChannel();
+
+    processQueue();
+}
+
+void ShellSession::ensureStarted()
+{
+    if (m_process) {
+        return;
+    }
+
+    m_process = new QProcess(this);
+    m_buffer.clear();
+    m_ready = false;
+    m_readyMarker = createMarker();
+
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &ShellSession::readOutput);
+    connect(m_process, &QProcess::readyReadStandardError, this, [this]() {
+        // Keep only the tail so a chatty script can't grow it without bound
+        m_errorBuffer += m_process->readAllStandardError();
+        if (m_errorBuffer.size() > MaximumErrorOutput) {
+            m_errorBuffer = m_errorBuffer.right(MaximumErrorOutput);
+        }
+    });
+    connect(m_process, &QProcess::finished, this, &ShellSession::handleExit);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        // Every other error is followed by finished()
+        if (error == QProcess::FailedToStart) {
+            handleExit();
+        }
+    });
+
+    qDebug() << "Starting shell session:" << m_shellCommand;
+    m_process->start(u"sh"_s, DistroboxCli::hostShellArguments(m_shellCommand));
+
+    // Whatever the shell prints before this marker (e.g. container startup messages) is discarded
+    m_process->write("printf '%s\\n' " + m_readyMarker + "\n");
+}
+
+void ShellSession::processQueue()
+{
+    if (m_current || m_queue.isEmpty()) {
+        return;
+    }
+
+    ensureStarted();
+    if (!m_ready) {
+        return;
+    }
+
+    while (!m_queue.isEmpty() && !m_current) {
+        Request request = m_queue.dequeue();
+        if (request.promise->isCanceled()) {
+            request.promise->finish();
+            continue;
+        }
+
+        request.marker = createMarker();
+        m_current = request;
+    }
+
+    if (!m_current) {
+        m_idleTimer->start();
+        return;
+    }
+
+    m_buffer.clear();
+    m_errorBuffer.clear();
+
+    // The script reaches its shell as a here-document on fd 3 rather than as an argument, which
+    // the kernel caps at 128 KiB; stdin stays /dev/null so the script can't eat the session's input.
+    // The end marker goes on its own line, preceded by a newline in case the output doesn't end with one
+    QByteArray script = m_current->script.toUtf8();
+    if (!script.endsWith('\n')) {
+        script += '\n';
+    }
+    const QByteArray request = "sh /dev/fd/3 </dev/null 3<<'" + m_current->marker + "'\n" + script + m_current->marker + "\nprintf '\\n%s %d\\n' "
+        + m_current->marker + " \"$?\"\n";
+    m_process->write(request);
+
+    if (m_current->timeoutMs > 0) {
+        m_requestTimer->start(m_current->timeoutMs);
+    }
+}
+
+void ShellSession::readOutput()
+{
+    if (!m_process) {
+        return;
+    }
+
+    m_buffer += m_process->readAllStandardOutput();
+
+    if (!m_ready) {
+        const QByteArray readyLine = m_readyMarker + '\n';
+        const qsizetype index = m_buffer.indexOf(readyLine);
+        if (index < 0) {
+            return;
+        }
+
+        m_buffer.remove(0, index + readyLine.size());
+        m_ready = true;
+        processQueue();
+        return;
+    }
+
+    if (!m_current) {
+        m_buffer.clear();
+        return;
+    }
+
+    const QByteArray terminator = '\n' + m_current->marker + ' ';
+    const qsizetype markerIndex = m_buffer.indexOf(terminator);
+    const qsizetype lineEnd = markerIndex >= 0 ? m_buffer.indexOf('\n', markerIndex + terminator.size()) : -1;
+
+    if (lineEnd < 0) {
+        // Hold back what could be the start of the end marker
+        deliverOutput(markerIndex >= 0 ? markerIndex : m_buffer.size() - terminator.size());
+        return;
+    }
+
+    deliverOutput(markerIndex);
+
+    // Standard error may still be unread, e.g. the shell's message for a script it couldn't run
+    m_errorBuffer += m_process->readAllStandardError();
+
+    CommandResult result;
+    result.output = m_buffer.left(markerIndex);
+    result.errorOutput = m_errorBuffer.right(MaximumErrorOutput);
+    result.exitCode = m_buffer.mid(markerIndex + terminator.size(), lineEnd - markerIndex - terminator.size()).toInt();
+
+    m_buffer.remove(0, lineEnd + 1);
+    m_errorBuffer.clear();
+
+    finishCurrent(result);
+    processQueue();
+}
+
+void ShellSession::deliverOutput(qsizetype available)
+{
+    if (!m_current || !m_current->onOutput || available <= m_current->delivered) {
+        return;
+    }
+
+    const QByteArray chunk = m_buffer.mid(m_current->delivered, available - m_current->delivered);
+    m_current->delivered = available;
+    m_current->onOutput(chunk);
+}
+
+void ShellSession::finishCurrent(const CommandResult &result)
+{
+    if (!m_current) {
+        return;
+    }
+
+    m_requestTimer->stop();
+
+    const auto promise = m_current->promise;
+    m_current.reset();
+
+    promise->addResult(result);
+    promise->finish();
+
+    if (m_queue.isEmpty()) {
+        m_idleTimer->start();
+    }
+}
+
+void ShellSession::abortCurrent(bool timedOut)
+{
+    if (!m_current) {
+        return;
+    }
+
+    // The script may still be running, the only way to get the shell back is a new one
+    CommandResult result;
+    result.output = m_buffer;
+    result.errorOutput = m_errorBuffer;
+    result.timedOut = timedOut;
+    result.canceled = !timedOut;
+
+    QProcess *process = m_process;
+    discardProcess();
+    if (process) {
+        // SIGTERM first so flatpak-spawn can forward it to the host process
+        process->terminate();
+        QTimer::singleShot(TerminateGracePeriod, process, [process]() {
+            if (process->state() != QProcess::NotRunning) {
+                process->kill();
+            }
+        });
+    }
+
+    finishCurrent(result);
+    processQueue();
+}
+
+void ShellSession::handleExit()
+{
+    if (!m_process) {
+        return;
+    }
+
+    const bool wasReady = m_ready;
+    const QByteArray errorOutput = m_errorBuffer + m_process->readAllStandardError();
+    if (!wasReady) {
+        qWarning() << "Shell session failed to start:" << m_shellCommand << errorOutput.trimmed();
+    }
+
+    CommandResult result;
+    result.output = m_buffer;
+    result.errorOutput = errorOutput;
+
+    discardProcess();
+    finishCurrent(result);
+
+    // A shell that never came up would fail the same way for everything still queued
+    if (!wasReady) {
+        while (!m_queue.isEmpty()) {
+            const Request request = m_queue.dequeue();
+            request.promise->addResult(result);
+            request.promise->finish();
+        }
+        return;
+    }
+
+    processQueue();
+}
+
+void ShellSession::discardProcess()
+{
+    if (!m_process) {
+        return;
+    }
+
+    QProcess *process = m_process;
+    m_process = nullptr;
+    m_ready = false;
+    m_buffer.clear();
+    m_errorBuffer.clear();
+    m_requestTimer->stop();
+
+    process->disconnect(this);
+    if (process->state() == QProcess::NotRunning) {
+        process->deleteLater();
+    } else {
+        connect(process, &QProcess::finished, process, &QObject::deleteLater);
+    }
+}
+
+void ShellSession::dropRequest(const std::shared_ptr<QPromise<CommandResult>> &promise, bool timedOut)
+{
+    if (m_current && m_current->promise == promise) {
+        abortCurrent(timedOut);
+        return;
+    }
+
+    for (qsizetype i = 0; i < m_queue.size(); ++i) {
+        if (m_queue.at(i).promise == promise) {
+            m_queue.removeAt(i);
+
+            CommandResult result;
+            result.timedOut = timedOut;
+            result.canceled = !timedOut;
+            promise->addResult(result);
+            promise->finish();
+            break;
+        }
+    }
+}
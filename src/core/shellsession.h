@@ -0,0 +1,125 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "commandexecutor.h"
+
+#include <QByteArray>
+#include <QFuture>
+#include <QObject>
+#include <QPromise>
+#include <QQueue>
+#include <QString>
+#include <functional>
+#include <memory>
+#include <optional>
+
+class QProcess;
+class QTimer;
+
+/**
+ * @class ShellSession
+ * @brief Long-lived shell that runs one script after the other over its stdin/stdout
+ *
+ * Starting a shell inside a container through "distrobox enter" takes far longer than
+ * the queries Kontainer runs there. A session starts the shell once and keeps it around
+ * until it has been idle for idleTimeout() milliseconds. Each script is sent on stdin and
+ * its output is read back up to a random end marker that also carries the exit code.
+ * Scripts run in their own shell so they can't change or terminate the session shell;
+ * they are passed as a here-document, so their size isn't limited by the argument length.
+ * A script that can't be run fails with the shell's exit code and its standard error.
+ */
+class ShellSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DefaultIdleTimeout = 60000; ///< Idle time in milliseconds before the shell exits
+
+    using OutputHandler = std::function<void(const QByteArray &chunk)>;
+
+    /**
+     * @brief Creates a session whose shell is started by the host command @p shellCommand
+     *
+     * The shell itself is only started once the first script is queued.
+     */
+    explicit ShellSession(const QString &shellCommand, QObject *parent = nullptr);
+    ~ShellSession() override;
+
+    /**
+     * @brief Returns the shared session running inside @p container
+     */
+    static ShellSession *forContainer(const QString &container);
+
+    /**
+     * @brief Ends the shared session of @p container, if there is one
+     */
+    static void closeContainerSession(const QString &container);
+
+    /**
+     * @brief Queues a script for execution in the session
+     * @param script Script, interpreted by sh
+     * @param timeoutMs Timeout in milliseconds, or CommandExecutor::NoTimeout
+     * @param onOutput Optional handler receiving standard output while the script runs
+     * @return Future holding the CommandResult, cancelable like CommandExecutor futures
+     *
+     * A script that times out or is canceled takes the shell down with it; the next
+     * script starts a fresh one.
+     */
+    QFuture<CommandResult> run(const QString &script, int timeoutMs = CommandExecutor::DefaultTimeout, const OutputHandler &onOutput = {});
+
+    /**
+     * @brief Runs a script and waits for its result in a nested event loop
+     *
+     * Prefer run() on the GUI thread; @p onOutput is invoked from within this call as output arrives.
+     */
+    CommandResult runBlocking(const QString &script, int timeoutMs = CommandExecutor::DefaultTimeout, const OutputHandler &onOutput = {});
+
+    int idleTimeout() const;
+    void setIdleTimeout(int idleTimeoutMs);
+
+    /**
+     * @brief Whether the shell process is currently running
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Ends the shell once the current script finished, queued scripts start a new one
+     */
+    void close();
+
+private:
+    struct Request {
+        QString script;
+        int timeoutMs = CommandExecutor::DefaultTimeout;
+        OutputHandler onOutput;
+        std::shared_ptr<QPromise<CommandResult>> promise;
+        QByteArray marker;
+        qsizetype delivered = 0; ///< Bytes of m_buffer already passed to onOutput
+    };
+
+    std::shared_ptr<QPromise<CommandResult>> enqueue(const QString &script, int timeoutMs, const OutputHandler &onOutput);
+    void ensureStarted();
+    void processQueue();
+    void readOutput();
+    void deliverOutput(qsizetype available);
+    void finishCurrent(const CommandResult &result);
+    void abortCurrent(bool timedOut);
+    void handleExit();
+    void discardProcess();
+    void dropRequest(const std::shared_ptr<QPromise<CommandResult>> &promise, bool timedOut);
+
+    QString m_shellCommand;
+    QProcess *m_process = nullptr;
+    QTimer *m_idleTimer;
+    QTimer *m_requestTimer;
+    QQueue<Request> m_queue;
+    std::optional<Request> m_current;
+    QByteArray m_buffer;
+    QByteArray m_errorBuffer;
+    QByteArray m_readyMarker;
+    bool m_ready = false;
+};
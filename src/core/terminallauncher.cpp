@@ -4,12 +4,14 @@
  */
 
 #include "terminallauncher.h"
+#include "hosthelper.h"
 
 #include <KConfigGroup>
 #include <KService>
 #include <KSharedConfig>
 #include <KShell>
 #include <QFile>
+#include <QHash>
 #include <QObject>
 #include <QProcess>
 #include <QStandardPaths>
@@ -39,6 +41,10 @@ bool hostExecutableExists(const QString &executable)
         return !QStandardPaths::findExecutable(executable).isEmpty();
     }
 
+    if (HostHelper::isEnabled()) {
+        return HostHelper::run(QStringLiteral("command -v %1").arg(KShell::quoteArg(executable)), 3000).success();
+    }
+
     if (QStandardPaths::findExecutable(QStringLiteral("flatpak-spawn")).isEmpty()) {
         return false;
     }
@@ -69,6 +75,24 @@ TerminalLaunchConfig buildTerminalLaunchConfig(const QString &command, const QSt
 
         const QStringList candidates = {terminalExec, QStringLiteral("konsole"), QStringLiteral("gnome-terminal"), QStringLiteral("xterm")};
 
+        // Look every candidate up in one request instead of one flatpak-spawn each
+        QHash<QString, bool> installed;
+        if (HostHelper::isEnabled()) {
+            QStringList programs;
+            QStringList lookups;
+            for (const QString &candidate : candidates) {
+                const QStringList parts = KShell::splitArgs(candidate);
+                if (!parts.isEmpty() && !programs.contains(parts.first())) {
+                    programs << parts.first();
+                    lookups << QStringLiteral("command -v %1").arg(KShell::quoteArg(parts.first()));
+                }
+            }
+            const QList<CommandResult> results = HostHelper::runBatch(lookups);
+            for (qsizetype i = 0; i < programs.size(); ++i) {
+                installed.insert(programs.at(i), results.at(i).success());
+            }
+        }
+
         for (const QString &candidate : candidates) {
             if (candidate.isEmpty()) {
                 continue;
@@ -80,7 +104,8 @@ TerminalLaunchConfig buildTerminalLaunchConfig(const QString &command, const QSt
                 continue;
             }
 
-            if (!hostExecutableExists(parts.first())) {
+            const auto known = installed.constFind(parts.first());
+            if (known != installed.constEnd() ? !*known : !hostExecutableExists(parts.first())) {
                 continue;
             }
 
@@ -0,0 +1,363 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "upgradescheduler.h"
+#include "distroboxcli.h"
+
+#include <KLocalizedString>
+#include <KShell>
+#include <QDebug>
+#include <QProcess>
+#include <QSettings>
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+const QString MaxConcurrentKey = u"Upgrades/maxConcurrent"_s;
+
+// Package managers can be chatty, the start of a long log is the least interesting part
+constexpr qsizetype MaximumLogSize = 1024 * 1024;
+
+// Time an upgrade gets to exit after SIGTERM before it is killed
+constexpr int TerminateGracePeriod = 5000;
+
+// An upgrade that prints nothing for this long is taken as stuck, e.g. on a prompt
+constexpr int SilenceTimeout = 30 * 60 * 1000;
+
+int defaultConcurrency()
+{
+    return qMax(1, QThread::idealThreadCount());
+}
+
+// Last non-empty line of @p output; progress bars redraw their line with carriage returns
+QString lastLineOf(const QByteArray &output)
+{
+    qsizetype end = output.size();
+    while (end > 0) {
+        qsizetype start = end - 1;
+        while (start >= 0 && output.at(start) != '\n' && output.at(start) != '\r') {
+            --start;
+        }
+        const QByteArray line = output.mid(start + 1, end - start - 1).trimmed();
+        if (!line.isEmpty()) {
+            return QString::fromUtf8(line);
+        }
+        end = start;
+    }
+    return {};
+}
+}
+
+bool UpgradeJob::isFinished() const
+{
+    return state == Succeeded || state == Failed || state == Canceled;
+}
+
+bool UpgradeJob::operator==(const UpgradeJob &other) const
+{
+    return container == other.container && state == other.state && lastLine == other.lastLine && logSize == other.logSize && logRevision == other.logRevision && exitCode == other.exitCode
+        && duration == other.duration;
+}
+
+UpgradeScheduler::UpgradeScheduler(QObject *parent)
+    : KeyedListModel(parent)
+    , m_maxConcurrent(qMax(1, QSettings().value(MaxConcurrentKey, defaultConcurrency()).toInt()))
+{
+    connect(this, &QAbstractItemModel::rowsInserted, this, &UpgradeScheduler::countChanged);
+    connect(this, &QAbstractItemModel::rowsRemoved, this, &UpgradeScheduler::countChanged);
+    connect(this, &QAbstractItemModel::modelReset, this, &UpgradeScheduler::countChanged);
+}
+
+UpgradeScheduler::~UpgradeScheduler()
+{
+    // The processes are children and go down with us, their signals must not reach a dying model
+    for (QProcess *process : std::as_const(m_processes)) {
+        process->disconnect(this);
+    }
+}
+
+QVariant UpgradeScheduler::data(const QModelIndex &index, int role) const
+{
+    if (!checkIndex(index, CheckIndexOption::IndexIsValid | CheckIndexOption::ParentIsInvalid)) {
+        return {};
+    }
+
+    const UpgradeJob &job = rows().at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+    case ContainerRole:
+        return job.container;
+    case StateRole:
+        return int(job.state);
+    case LastLineRole:
+        return job.lastLine;
+    case LogRole:
+        return log(job.container);
+    case ExitCodeRole:
+        return job.exitCode;
+    case DurationRole:
+        return job.duration;
+    case LogRevisionRole:
+        return job.logRevision;
+    }
+    return {};
+}
+
+QHash<int, QByteArray> UpgradeScheduler::roleNames() const
+{
+    return {
+        {ContainerRole, "container"},
+        {StateRole, "jobState"},
+        {LastLineRole, "lastLine"},
+        {LogRole, "log"},
+        {ExitCodeRole, "exitCode"},
+        {DurationRole, "duration"},
+        {LogRevisionRole, "logRevision"},
+    };
+}
+
+int UpgradeScheduler::maxConcurrent() const
+{
+    return m_maxConcurrent;
+}
+
+void UpgradeScheduler::setMaxConcurrent(int maxConcurrent)
+{
+    maxConcurrent = qMax(1, maxConcurrent);
+    if (maxConcurrent == m_maxConcurrent) {
+        return;
+    }
+
+    m_maxConcurrent = maxConcurrent;
+    QSettings().setValue(MaxConcurrentKey, maxConcurrent);
+    Q_EMIT maxConcurrentChanged();
+
+    // Lowering the limit lets running upgrades finish, raising it starts queued ones right away
+    startNext();
+}
+
+int UpgradeScheduler::runningCount() const
+{
+    return int(m_processes.size());
+}
+
+int UpgradeScheduler::finishedCount() const
+{
+    return int(std::count_if(rows().cbegin(), rows().cend(), [](const UpgradeJob &job) {
+        return job.isFinished();
+    }));
+}
+
+bool UpgradeScheduler::isActive() const
+{
+    return finishedCount() < count();
+}
+
+void UpgradeScheduler::upgrade(const QStringList &containers)
+{
+    for (const QString &container : containers) {
+        const int row = rowOf(container);
+        if (row >= 0 && !rows().at(row).isFinished()) {
+            continue;
+        }
+
+        m_logs.remove(container);
+        setJob(UpgradeJob{container});
+    }
+
+    Q_EMIT progressChanged();
+    startNext();
+}
+
+void UpgradeScheduler::cancel(const QString &container)
+{
+    const int row = rowOf(container);
+    if (row < 0 || rows().at(row).isFinished()) {
+        return;
+    }
+
+    QProcess *process = m_processes.value(container);
+    if (!process) {
+        finish(container, UpgradeJob::Canceled, -1);
+        return;
+    }
+
+    // finish() runs once the process exited
+    process->setProperty("canceled", true);
+    terminate(process);
+}
+
+void UpgradeScheduler::cancelAll()
+{
+    // Queued jobs first, so canceling a running one doesn't start them
+    for (const UpgradeJob &job : QList<UpgradeJob>(rows())) {
+        if (job.state == UpgradeJob::Queued) {
+            cancel(job.container);
+        }
+    }
+    for (const QString &container : m_processes.keys()) {
+        cancel(container);
+    }
+}
+
+void UpgradeScheduler::clearFinished()
+{
+    for (const UpgradeJob &job : QList<UpgradeJob>(rows())) {
+        if (job.isFinished()) {
+            m_logs.remove(job.container);
+            removeKey(job.container);
+        }
+    }
+    Q_EMIT progressChanged();
+}
+
+QString UpgradeScheduler::log(const QString &container) const
+{
+    return QString::fromUtf8(m_logs.value(container));
+}
+
+QString UpgradeScheduler::keyOf(const UpgradeJob &job) const
+{
+    return job.container;
+}
+
+void UpgradeScheduler::startNext()
+{
+    for (int row = 0; row < count() && runningCount() < m_maxConcurrent; ++row) {
+        if (rows().at(row).state == UpgradeJob::Queued) {
+            start(rows().at(row).container);
+        }
+    }
+}
+
+void UpgradeScheduler::start(const QString &container)
+{
+    auto *process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    // Nobody can answer a prompt, so a sudo or confirmation prompt fails instead of waiting forever
+    process->setStandardInputFile(QProcess::nullDevice());
+    m_processes.insert(container, process);
+    m_timers[container].start();
+
+    // Restarted by every output, so long but progressing upgrades aren't cut off
+    auto *silenceTimer = new QTimer(process);
+    silenceTimer->setSingleShot(true);
+    silenceTimer->setInterval(SilenceTimeout);
+    connect(silenceTimer, &QTimer::timeout, this, [this, container, process]() {
+        if (process->state() == QProcess::NotRunning) {
+            return;
+        }
+        qWarning() << "Upgrade of" << container << "printed nothing for" << SilenceTimeout / 1000 << "s, stopping it";
+        const QByteArray note = "\n" + i18n("No output for %1 minutes, the upgrade was stopped.", SilenceTimeout / 60000).toUtf8() + "\n";
+        appendOutput(container, note);
+        process->setProperty("timedOut", true);
+        terminate(process);
+    });
+    silenceTimer->start();
+
+    connect(process, &QProcess::readyRead, this, [this, container, process, silenceTimer]() {
+        silenceTimer->start();
+        appendOutput(container, process->readAll());
+    });
+    connect(process, &QProcess::finished, this, [this, container, process](int exitCode, QProcess::ExitStatus exitStatus) {
+        appendOutput(container, process->readAll());
+        if (process->property("timedOut").toBool()) {
+            finish(container, UpgradeJob::Failed, -1);
+        } else if (process->property("canceled").toBool()) {
+            finish(container, UpgradeJob::Canceled, -1);
+        } else if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+            finish(container, UpgradeJob::Succeeded, exitCode);
+        } else {
+            finish(container, UpgradeJob::Failed, exitStatus == QProcess::NormalExit ? exitCode : -1);
+        }
+    });
+    connect(process, &QProcess::errorOccurred, this, [this, container, process](QProcess::ProcessError error) {
+        // Every other error is followed by finished()
+        if (error != QProcess::FailedToStart) {
+            return;
+        }
+        appendOutput(container, process->errorString().toUtf8());
+        finish(container, UpgradeJob::Failed, -1);
+    });
+
+    UpgradeJob job = rows().at(rowOf(container));
+    job.state = UpgradeJob::Running;
+    setJob(job, {StateRole});
+
+    qDebug() << "Upgrading container" << container << "-" << runningCount() << "of at most" << m_maxConcurrent << "upgrades running";
+    process->start(u"sh"_s, DistroboxCli::hostShellArguments(u"distrobox upgrade %1"_s.arg(KShell::quoteArg(container))));
+    Q_EMIT progressChanged();
+}
+
+void UpgradeScheduler::appendOutput(const QString &container, const QByteArray &output)
+{
+    const int row = rowOf(container);
+    if (output.isEmpty() || row < 0) {
+        return;
+    }
+
+    QByteArray &log = m_logs[container];
+    log += output;
+    if (log.size() > MaximumLogSize) {
+        log.remove(0, log.size() - MaximumLogSize);
+    }
+
+    UpgradeJob job = rows().at(row);
+    job.logSize = log.size();
+    ++job.logRevision;
+    const QString lastLine = lastLineOf(output);
+    if (!lastLine.isEmpty()) {
+        job.lastLine = lastLine;
+    }
+    setJob(job, {LastLineRole, LogRole, LogRevisionRole});
+}
+
+void UpgradeScheduler::finish(const QString &container, UpgradeJob::State state, int exitCode)
+{
+    if (QProcess *process = m_processes.take(container)) {
+        process->disconnect(this);
+        process->deleteLater();
+    }
+
+    const int row = rowOf(container);
+    if (row >= 0 && !rows().at(row).isFinished()) {
+        UpgradeJob job = rows().at(row);
+        job.state = state;
+        job.exitCode = exitCode;
+        job.duration = m_timers.contains(container) ? m_timers.take(container).elapsed() : 0;
+        setJob(job, {StateRole, ExitCodeRole, DurationRole});
+
+        qDebug() << "Upgrade of" << container << (state == UpgradeJob::Succeeded ? "succeeded" : state == UpgradeJob::Failed ? "failed" : "canceled")
+                 << "after" << job.duration << "ms";
+        Q_EMIT upgradeFinished(container, state == UpgradeJob::Succeeded);
+    }
+
+    Q_EMIT progressChanged();
+    startNext();
+}
+
+void UpgradeScheduler::setJob(const UpgradeJob &job, const QList<int> &roles)
+{
+    const int row = rowOf(job.container);
+    if (row < 0) {
+        insertOrUpdateRow(job);
+    } else {
+        updateRow(row, job, roles);
+    }
+}
+
+void UpgradeScheduler::terminate(QProcess *process)
+{
+    process->terminate();
+    QTimer::singleShot(TerminateGracePeriod, process, [process]() {
+        if (process->state() != QProcess::NotRunning) {
+            process->kill();
+        }
+    });
+}
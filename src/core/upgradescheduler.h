@@ -0,0 +1,160 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include "keyedlistmodel.h"
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <qqmlintegration.h>
+
+class QProcess;
+
+/**
+ * @struct UpgradeJob
+ * @brief One row of UpgradeScheduler
+ */
+struct UpgradeJob {
+    enum State {
+        Queued,
+        Running,
+        Succeeded,
+        Failed,
+        Canceled,
+    };
+
+    QString container;
+    State state = Queued;
+    QString lastLine; ///< Last non-empty line of output, for a one-line progress display
+    qsizetype logSize = 0; ///< Bytes in the job's log, the log itself is kept outside the row
+    int logRevision = 0; ///< Incremented on every output, also once the log is capped
+    int exitCode = -1;
+    qint64 duration = 0; ///< Milliseconds, once the job finished
+
+    bool isFinished() const;
+
+    bool operator==(const UpgradeJob &other) const;
+};
+
+/**
+ * @class UpgradeScheduler
+ * @brief Upgrades containers with "distrobox upgrade", several at a time
+ *
+ * Each container is upgraded by its own host process, at most maxConcurrent() of them
+ * at the same time; the others wait in the order they were queued. The combined output
+ * of a process is kept as the container's log, of which the model exposes the last
+ * line while it runs and the whole text on request.
+ *
+ * The processes get no input, so prompts fail instead of waiting, and an upgrade that
+ * prints nothing for 30 minutes is stopped and reported as failed.
+ *
+ * The concurrency is saved in the application settings and defaults to the number of
+ * CPU cores.
+ */
+class UpgradeScheduler : public KeyedListModel<UpgradeJob>
+{
+    Q_OBJECT
+    QML_ELEMENT
+    QML_UNCREATABLE("Use distroBoxManager.upgrades")
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    Q_PROPERTY(int maxConcurrent READ maxConcurrent WRITE setMaxConcurrent NOTIFY maxConcurrentChanged)
+    Q_PROPERTY(int runningCount READ runningCount NOTIFY progressChanged)
+    Q_PROPERTY(int finishedCount READ finishedCount NOTIFY progressChanged)
+    Q_PROPERTY(bool active READ isActive NOTIFY progressChanged)
+
+public:
+    enum Roles {
+        ContainerRole = Qt::UserRole + 1,
+        StateRole, ///< One of State
+        LastLineRole,
+        LogRole, ///< Whole output so far
+        ExitCodeRole,
+        DurationRole,
+        LogRevisionRole, ///< Changes whenever output was added to the log
+    };
+    Q_ENUM(Roles)
+
+    enum State {
+        Queued = UpgradeJob::Queued,
+        Running = UpgradeJob::Running,
+        Succeeded = UpgradeJob::Succeeded,
+        Failed = UpgradeJob::Failed,
+        Canceled = UpgradeJob::Canceled,
+    };
+    Q_ENUM(State)
+
+    explicit UpgradeScheduler(QObject *parent = nullptr);
+    ~UpgradeScheduler() override;
+
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    int maxConcurrent() const;
+    void setMaxConcurrent(int maxConcurrent);
+
+    int runningCount() const;
+    int finishedCount() const;
+
+    /**
+     * @brief Whether jobs are queued or running
+     */
+    bool isActive() const;
+
+    /**
+     * @brief Queues an upgrade of every container in @p containers
+     *
+     * Containers that are already queued or upgrading are left alone; finished ones are
+     * upgraded again with a fresh log.
+     */
+    Q_INVOKABLE void upgrade(const QStringList &containers);
+
+    /**
+     * @brief Drops the queued upgrade of @p container, or stops it if it is running
+     */
+    Q_INVOKABLE void cancel(const QString &container);
+
+    Q_INVOKABLE void cancelAll();
+
+    /**
+     * @brief Removes the rows and logs of finished jobs
+     */
+    Q_INVOKABLE void clearFinished();
+
+    /**
+     * @brief Output of the upgrade of @p container so far
+     */
+    Q_INVOKABLE QString log(const QString &container) const;
+
+Q_SIGNALS:
+    void countChanged();
+    void maxConcurrentChanged();
+
+    /**
+     * @brief Emitted whenever a job was queued, started or finished
+     */
+    void progressChanged();
+
+    void upgradeFinished(const QString &container, bool success);
+
+protected:
+    QString keyOf(const UpgradeJob &job) const override;
+
+private:
+    void startNext();
+    void start(const QString &container);
+    void appendOutput(const QString &container, const QByteArray &output);
+    void finish(const QString &container, UpgradeJob::State state, int exitCode);
+    void setJob(const UpgradeJob &job, const QList<int> &roles = {});
+    static void terminate(QProcess *process);
+
+    int m_maxConcurrent;
+    QHash<QString, QProcess *> m_processes; ///< Running process per container
+    QHash<QString, QElapsedTimer> m_timers;
+    QHash<QString, QByteArray> m_logs; ///< Output per container, the oldest part is dropped past MaximumLogSize
+};
@@ -5,14 +5,18 @@
 */
 
 #include "distroboxmanager.h"
+#include "iconimageprovider.h"
 #include "version-kontainer.h"
 #include <KAboutData>
 #include <KIconTheme>
 #include <KLocalizedContext>
 #include <KLocalizedString>
 #include <QApplication>
+#include <QDebug>
+#include <QElapsedTimer>
 #include <QIcon>
 #include <QQmlApplicationEngine>
+#include <QQuickWindow>
 #include <QQuickStyle>
 #include <QUrl>
 #include <QtQml>
@@ -21,6 +25,9 @@ using namespace Qt::Literals::StringLiterals;
 
 int main(int argc, char *argv[])
 {
+    QElapsedTimer startupTimer;
+    startupTimer.start();
+
     KIconTheme::initTheme();
 
     QApplication app(argc, argv);
@@ -60,6 +67,9 @@ int main(int argc, char *argv[])
     DistroboxManager *distroBoxManager = new DistroboxManager(&engine);
     engine.rootContext()->setContextProperty(u"distroBoxManager"_s, distroBoxManager);
 
+    // Icons are decoded off the GUI thread and shared between delegates
+    engine.addImageProvider(QLatin1String(IconImageProvider::ProviderId), new IconImageProvider);
+
     engine.rootContext()->setContextObject(new KLocalizedContext(&engine));
     engine.loadFromModule("io.github.DenysMb.Kontainer", "Main");
 
@@ -67,5 +77,17 @@ int main(int argc, char *argv[])
         return -1;
     }
 
+    // Startup regressions show up here, e.g. something blocking before the window can paint
+    if (auto *window = qobject_cast<QQuickWindow *>(engine.rootObjects().constFirst())) {
+        QObject::connect(
+            window,
+            &QQuickWindow::frameSwapped,
+            window,
+            [startupTimer]() {
+                qDebug() << "Time to first frame:" << startupTimer.elapsed() << "ms";
+            },
+            Qt::SingleShotConnection);
+    }
+
     return app.exec();
 }
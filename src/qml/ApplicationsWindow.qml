@@ -21,10 +21,14 @@ Kirigami.ApplicationWindow {
     property string containerName: ""
     property bool loading: true
     property bool operationInProgress: false
-    property var exportedApps: []
-    property var allApps: []
+    // Rows are updated in place, delegates survive exports and refreshes
+    readonly property var exportedAppsModel: containerName ? distroBoxManager.exportedAppsModel(containerName) : null
+    readonly property var applicationsModel: containerName ? distroBoxManager.applicationsModel(containerName) : null
     property var selectedApps: ({})
     property string lastOperation: ""
+    // Progress of the running exportApps()/unexportApps() batch
+    property int batchDone: 0
+    property int batchTotal: 0
     // Separate search text for each tab
     property string exportedSearchText: ""
     property string availableSearchText: ""
@@ -35,56 +39,87 @@ Kirigami.ApplicationWindow {
     function refreshApplications() {
         loading = true;
 
-        // Let the window paint first
+        // Let the window paint first; applicationsLoaded() ends the loading state
         Qt.callLater(function () {
-            exportedApps = distroBoxManager.exportedApps(containerName) || [];
-            allApps = distroBoxManager.allApps(containerName) || [];
-            loading = false;
-            dataReady();
+            distroBoxManager.loadApplications(containerName);
         });
     }
 
-    function refreshAppLists() {
-        // Only refresh the lists without showing loading screen
-        Qt.callLater(function () {
-            exportedApps = distroBoxManager.exportedApps(containerName) || [];
-            allApps = distroBoxManager.allApps(containerName) || [];
-        });
+    function iconSourceForApp(icon, iconSource) {
+        if (iconSource)
+            return iconSource;
+        if (icon && (icon.startsWith("file:") || icon.startsWith("/") || icon.startsWith("data:")))
+            return icon;
+        return "";
     }
 
-    function filterApps(apps, searchText) {
-        if (!searchText)
-            return apps;
-        return apps.filter(function (app) {
-            return app.name && app.name.toLowerCase().includes(searchText.toLowerCase()) || app.basename && app.basename.toLowerCase().includes(searchText.toLowerCase());
-        });
+    function iconNameForApp(icon, fallbackIcon) {
+        if (icon && icon.length > 0 && !icon.startsWith("/") && icon.indexOf("://") === -1)
+            return icon;
+        return fallbackIcon;
     }
 
-    function isAppExported(basename) {
-        if (!basename || !exportedApps || exportedApps.length === 0)
-            return false;
+    // Search runs in C++ over a precomputed index, debounced while typing
+    ApplicationFilterModel {
+        id: exportedFilterModel
+        sourceModel: applicationsWindow.exportedAppsModel
+        filterText: applicationsWindow.exportedSearchText
+    }
 
-        return exportedApps.some(function (app) {
-            return app && app.basename === basename;
-        });
+    ApplicationFilterModel {
+        id: availableFilterModel
+        sourceModel: applicationsWindow.applicationsModel
+        filterText: applicationsWindow.availableSearchText
     }
 
-    function iconSourceForApp(app) {
-        if (!app)
-            return "";
-        if (app.iconSource)
-            return app.iconSource;
-        if (app.icon && (app.icon.startsWith("file:") || app.icon.startsWith("/") || app.icon.startsWith("data:")))
-            return app.icon;
-        return "";
+    // Exports and unexports run in the background, one or many applications at a time
+    function runBatch(operation, basenames, label) {
+        if (basenames.length === 0)
+            return;
+        operationInProgress = true;
+        lastOperation = label;
+        batchDone = 0;
+        batchTotal = basenames.length;
+        if (operation === "unexport")
+            distroBoxManager.unexportApps(basenames, containerName);
+        else
+            distroBoxManager.exportApps(basenames, containerName);
     }
 
-    function iconNameForApp(app, fallbackIcon) {
-        if (!app)
-            return fallbackIcon;
-        if (app.icon && app.icon.length > 0 && !app.icon.startsWith("/") && app.icon.indexOf("://") === -1)
-            return app.icon;
-        return fallbackIcon;
+    Connections {
+        target: distroBoxManager
+
+        function onApplicationsLoaded(container) {
+            if (container !== applicationsWindow.containerName)
+                return;
+            applicationsWindow.loading = false;
+            applicationsWindow.dataReady();
+        }
+
+        function onApplicationBatchProgress(container, operation, basename, success, done, total) {
+            if (container === applicationsWindow.containerName)
+                applicationsWindow.batchDone = done;
+        }
+
+        function onApplicationBatchFinished(container, operation, results) {
+            if (container !== applicationsWindow.containerName)
+                return;
+            var failures = results.filter(function (result) {
+                return !result.success;
+            });
+            var failed = failures.length;
+            if (failed > 0) {
+                if (results.length === 1 && failures[0].error)
+                    showPassiveNotification(operation === "unexport" ? i18n("Failed to unexport application: %1", failures[0].error) : i18n("Failed to export application: %1", failures[0].error));
+                else if (results.length === 1)
+                    showPassiveNotification(operation === "unexport" ? i18n("Failed to unexport application") : i18n("Failed to export application"));
+                else
+                    showPassiveNotification(operation === "unexport" ? i18n("Failed to unexport %1 of %2 applications", failed, results.length) : i18n("Failed to export %1 of %2 applications", failed, results.length));
+                lastOperation = "";
+            }
+            applicationsWindow.batchTotal = 0;
+            applicationsWindow.operationInProgress = false;
+        }
     }
 
     onContainerNameChanged: {
@@ -140,7 +175,7 @@ Kirigami.ApplicationWindow {
 
                         Controls.ToolButton {
                             Layout.fillWidth: true
-                            text: i18n("Exported Applications (%1)", exportedApps.length)
+                            text: i18n("Exported Applications (%1)", exportedAppsModel ? exportedAppsModel.count : 0)
                             checkable: true
                             checked: currentTabIndex === 0
                             onClicked: currentTabIndex = 0
@@ -148,7 +183,7 @@ Kirigami.ApplicationWindow {
 
                         Controls.ToolButton {
                             Layout.fillWidth: true
-                            text: i18n("All Applications (%1)", allApps.length)
+                            text: i18n("All Applications (%1)", applicationsModel ? applicationsModel.count : 0)
                             checkable: true
                             checked: currentTabIndex === 1
                             onClicked: currentTabIndex = 1
@@ -176,7 +211,7 @@ Kirigami.ApplicationWindow {
                             id: exportedSearchField
                             Layout.fillWidth: true
                             Layout.preferredHeight: visible ? implicitHeight : 0
-                            visible: filterApps(exportedApps, exportedSearchText).length > 0 || exportedSearchText.length > 0
+                            visible: (exportedAppsModel ? exportedAppsModel.count : 0) > 0 || exportedSearchText.length > 0
                             placeholderText: i18n("Search exported applications...")
                             text: exportedSearchText
                             onTextChanged: exportedSearchText = text
@@ -189,7 +224,7 @@ Kirigami.ApplicationWindow {
                             Layout.topMargin: exportedSearchField.visible ? Kirigami.Units.largeSpacing : 0
 
                             sourceComponent: {
-                                if (filterApps(exportedApps, exportedSearchText).length === 0) {
+                                if (exportedFilterModel.count === 0) {
                                     return exportedPlaceholderComponent;
                                 } else {
                                     return exportedListViewComponent;
@@ -210,7 +245,7 @@ Kirigami.ApplicationWindow {
                             id: availableSearchField
                             Layout.fillWidth: true
                             Layout.preferredHeight: visible ? implicitHeight : 0
-                            visible: filterApps(allApps, availableSearchText).length > 0 || availableSearchText.length > 0
+                            visible: (applicationsModel ? applicationsModel.count : 0) > 0 || availableSearchText.length > 0
                             placeholderText: i18n("Search available applications...")
                             text: availableSearchText
                             onTextChanged: availableSearchText = text
@@ -223,7 +258,7 @@ Kirigami.ApplicationWindow {
                             Layout.topMargin: availableSearchField.visible ? Kirigami.Units.largeSpacing : 0
 
                             sourceComponent: {
-                                if (filterApps(allApps, availableSearchText).length === 0) {
+                                if (availableFilterModel.count === 0) {
                                     return availablePlaceholderComponent;
                                 } else {
                                     return availableListViewComponent;
@@ -257,7 +292,7 @@ Kirigami.ApplicationWindow {
 
                     ListView {
                         id: exportedListView
-                        model: filterApps(exportedApps, exportedSearchText)
+                        model: exportedFilterModel
                         spacing: Kirigami.Units.smallSpacing
 
                         delegate: Kirigami.AbstractCard {
@@ -267,20 +302,20 @@ Kirigami.ApplicationWindow {
                                 spacing: Kirigami.Units.largeSpacing
 
                                 Controls.CheckBox {
-                                    checked: selectedApps[modelData.basename] || false
-                                    onCheckedChanged: selectedApps[modelData.basename] = checked
+                                    checked: selectedApps[model.basename] || false
+                                    onCheckedChanged: selectedApps[model.basename] = checked
                                     visible: Object.keys(selectedApps).length > 0 || checked
                                 }
 
-                                Kirigami.Icon {
-                                    readonly property string resolvedIconSource: iconSourceForApp(modelData)
-                                    source: resolvedIconSource.length > 0 ? resolvedIconSource : iconNameForApp(modelData, "application-x-executable")
+                                ContainerIcon {
+                                    source: iconSourceForApp(model.icon, model.iconSource)
+                                    iconName: iconNameForApp(model.icon, "application-x-executable")
                                     width: Kirigami.Units.iconSizes.medium
                                     height: width
                                 }
 
                                 Controls.Label {
-                                    text: modelData.name || modelData.basename || "Unknown Application"
+                                    text: model.name || model.basename || "Unknown Application"
                                     Layout.fillWidth: true
                                     elide: Text.ElideRight
                                     font.bold: true
@@ -290,19 +325,7 @@ Kirigami.ApplicationWindow {
                                     text: i18n("Unexport")
                                     icon.name: "list-remove"
                                     enabled: !operationInProgress
-                                    onClicked: {
-                                        operationInProgress = true;
-                                        lastOperation = modelData.name || modelData.basename;
-                                        var success = distroBoxManager.unexportApp(modelData.basename, containerName);
-                                        if (success) {
-                                            refreshAppLists();
-                                            operationInProgress = false;
-                                        } else {
-                                            showPassiveNotification(i18n("Failed to unexport application"));
-                                            lastOperation = "";
-                                            operationInProgress = false;
-                                        }
-                                    }
+                                    onClicked: runBatch("unexport", [model.basename], model.name || model.basename)
                                 }
                             }
                         }
@@ -317,7 +340,7 @@ Kirigami.ApplicationWindow {
 
                     ListView {
                         id: availableListView
-                        model: filterApps(allApps, availableSearchText)
+                        model: availableFilterModel
                         spacing: Kirigami.Units.smallSpacing
 
                         delegate: Kirigami.AbstractCard {
@@ -327,43 +350,30 @@ Kirigami.ApplicationWindow {
                                 spacing: Kirigami.Units.largeSpacing
 
                                 Controls.CheckBox {
-                                    checked: selectedApps[modelData.basename] || false
-                                    onCheckedChanged: selectedApps[modelData.basename] = checked
+                                    checked: selectedApps[model.basename] || false
+                                    onCheckedChanged: selectedApps[model.basename] = checked
                                     visible: Object.keys(selectedApps).length > 0 || checked
                                 }
 
-                                Kirigami.Icon {
-                                    readonly property string resolvedIconSource: iconSourceForApp(modelData)
-                                    source: resolvedIconSource.length > 0 ? resolvedIconSource : iconNameForApp(modelData, "package-x-generic")
+                                ContainerIcon {
+                                    source: iconSourceForApp(model.icon, model.iconSource)
+                                    iconName: iconNameForApp(model.icon, "package-x-generic")
                                     width: Kirigami.Units.iconSizes.medium
                                     height: width
                                 }
 
                                 Controls.Label {
-                                    text: modelData.name || modelData.basename || "Unknown Application"
+                                    text: model.name || model.basename || "Unknown Application"
                                     Layout.fillWidth: true
                                     elide: Text.ElideRight
                                     font.bold: true
                                 }
 
                                 Controls.Button {
-                                    text: applicationsWindow.isAppExported(modelData.basename) ? i18n("Unexport") : i18n("Export")
-                                    icon.name: applicationsWindow.isAppExported(modelData.basename) ? "list-remove" : "list-add"
+                                    text: model.exported ? i18n("Unexport") : i18n("Export")
+                                    icon.name: model.exported ? "list-remove" : "list-add"
                                     enabled: !operationInProgress
-                                    onClicked: {
-                                        var wasExported = applicationsWindow.isAppExported(modelData.basename);
-                                        operationInProgress = true;
-                                        lastOperation = modelData.name || modelData.basename;
-                                        var success = wasExported ? distroBoxManager.unexportApp(modelData.basename, containerName) : distroBoxManager.exportApp(modelData.basename, containerName);
-                                        if (success) {
-                                            refreshAppLists();
-                                            operationInProgress = false;
-                                        } else {
-                                            showPassiveNotification(wasExported ? i18n("Failed to unexport application") : i18n("Failed to export application"));
-                                            lastOperation = "";
-                                            operationInProgress = false;
-                                        }
-                                    }
+                                    onClicked: runBatch(model.exported ? "unexport" : "export", [model.basename], model.name || model.basename)
                                 }
                             }
                         }
@@ -372,11 +382,11 @@ Kirigami.ApplicationWindow {
             }
 
             footer: Controls.ToolBar {
-                visible: Object.keys(selectedApps).length > 0
+                visible: Object.keys(selectedApps).length > 0 || batchTotal > 1
                 RowLayout {
                     width: parent.width
                     Controls.Label {
-                        text: i18n("%1 selected", Object.keys(selectedApps).length)
+                        text: batchTotal > 1 ? i18n("%1 of %2 applications done", batchDone, batchTotal) : i18n("%1 selected", Object.keys(selectedApps).length)
                     }
                     Item {
                         Layout.fillWidth: true
@@ -386,21 +396,12 @@ Kirigami.ApplicationWindow {
                         icon.name: currentTabIndex === 0 ? "list-remove" : "list-add"
                         enabled: !operationInProgress
                         onClicked: {
-                            operationInProgress = true;
                             var appNames = Object.keys(selectedApps).filter(function (key) {
                                 return selectedApps[key];
                             });
-                            for (var i = 0; i < appNames.length; i++) {
-                                if (currentTabIndex === 0) {
-                                    distroBoxManager.unexportApp(appNames[i], containerName);
-                                } else {
-                                    distroBoxManager.exportApp(appNames[i], containerName);
-                                }
-                            }
-                            lastOperation = i18n("%1 applications", appNames.length);
+                            var operation = currentTabIndex === 0 ? "unexport" : "export";
                             selectedApps = {};
-                            refreshAppLists();
-                            operationInProgress = false;
+                            runBatch(operation, appNames, i18n("%1 applications", appNames.length));
                         }
                     }
                     Controls.Button {
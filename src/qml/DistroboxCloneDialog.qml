@@ -15,7 +15,6 @@ Kirigami.Dialog {
     padding: Kirigami.Units.largeSpacing
     standardButtons: Kirigami.Dialog.Ok | Kirigami.Dialog.Cancel
 
-    property var containersList: []
     property string selectedContainer: ""
     property bool nameManuallyEdited: false
     property string errorMessage: ""
@@ -28,23 +27,16 @@ Kirigami.Dialog {
     }
 
     function openWithContainer(containerName) {
-        if (!containersList || containersList.length === 0) {
+        const containers = distroBoxManager.containers;
+        if (containers.count === 0) {
             errorMessage = i18n("No containers available to clone.");
             return;
         }
 
-        var index = 0;
-        if (containerName && containerName.length > 0) {
-            for (var i = 0; i < containersList.length; ++i) {
-                if (containersList[i].name === containerName) {
-                    index = i;
-                    break;
-                }
-            }
-        }
+        const index = Math.max(containers.rowOfName(containerName || ""), 0);
 
         containerCombo.currentIndex = index;
-        selectedContainer = containersList[index].name;
+        selectedContainer = containers.nameAt(index);
         nameManuallyEdited = false;
         nameField.text = defaultCloneName(selectedContainer);
         errorMessage = "";
@@ -87,15 +79,15 @@ Kirigami.Dialog {
             Controls.ComboBox {
                 id: containerCombo
                 Kirigami.FormData.label: i18n("Container")
-                model: cloneDialog.containersList
+                model: distroBoxManager.containers
                 textRole: "name"
                 Layout.fillWidth: true
 
                 onCurrentIndexChanged: {
-                    if (currentIndex < 0 || currentIndex >= cloneDialog.containersList.length) {
+                    if (currentIndex < 0 || currentIndex >= distroBoxManager.containers.count) {
                         return;
                     }
-                    selectedContainer = cloneDialog.containersList[currentIndex].name;
+                    selectedContainer = distroBoxManager.containers.nameAt(currentIndex);
                     if (!nameManuallyEdited) {
                         nameField.text = defaultCloneName(selectedContainer);
                     }
@@ -4,6 +4,7 @@
  *   SPDX-FileCopyrightText: 2025 Thomas Duckworth <tduck@filotimoproject.org>
  */
 
+import QtCore
 import QtQuick
 import QtQuick.Layouts
 import QtQuick.Controls as Controls
@@ -20,7 +21,6 @@ Kirigami.Dialog {
 
     property bool isCreating: false
     property var errorDialog
-    required property var mainPage
     property bool selectingImage: false
     property bool advancedOpen: false
 
@@ -54,12 +54,46 @@ Kirigami.Dialog {
     property bool selectedImageIsCustom: false
     property string imageSearchQuery: ""
     property string pendingContainerName: ""
+    // ContainerCreateJob of the running creation, reports the image pull and distrobox's output
+    property var createJob: null
+    // ImagePull of the selected image, started ahead of the creation when pre-pulling is enabled
+    property var prepull: null
     property string customHomePath: ""
 
     ListModel {
         id: volumesModel
     }
 
+    Settings {
+        id: createSettings
+        category: "Create"
+        property bool prepullImages: false
+    }
+
+    // Waits for the selection to settle, a custom image name changes with every key press
+    Timer {
+        id: prepullTimer
+        interval: 1000
+        onTriggered: createDialog.updatePrepull()
+    }
+
+    onSelectedImageFullChanged: prepullTimer.restart()
+    onSelectedImageDisplayChanged: prepullTimer.restart()
+    onOpened: prepullTimer.restart()
+    onClosed: {
+        prepullTimer.stop();
+        prepull = null;
+        distroBoxManager.prepullImage("");
+    }
+
+    function updatePrepull() {
+        if (!createDialog.opened || isCreating) {
+            return;
+        }
+        var image = createSettings.prepullImages ? (selectedImageFull || selectedImageDisplay) : "";
+        prepull = distroBoxManager.prepullImage(image);
+    }
+
     FileDialog {
         id: iniFileDialog
         title: i18n("Choose .ini file")
@@ -109,9 +143,6 @@ Kirigami.Dialog {
             visible: !createDialog.selectingImage
             enabled: !createDialog.isCreating
             onTriggered: {
-                if (creationMonitorTimer.running) {
-                    creationMonitorTimer.stop();
-                }
                 iniFileDialog.open();
                 createDialog.close();
             }
@@ -120,12 +151,12 @@ Kirigami.Dialog {
             icon.name: "dialog-cancel"
             text: i18n("Cancel")
             visible: !createDialog.selectingImage
-            enabled: !createDialog.isCreating
             onTriggered: {
-                if (creationMonitorTimer.running) {
-                    creationMonitorTimer.stop();
+                if (createDialog.isCreating && createDialog.pendingContainerName) {
+                    distroBoxManager.cancelOperation(createDialog.pendingContainerName);
                 }
                 createDialog.pendingContainerName = "";
+                createDialog.createJob = null;
                 createDialog.isCreating = false;
                 createDialog.selectingImage = false;
                 createDialog.advancedOpen = false;
@@ -135,12 +166,9 @@ Kirigami.Dialog {
     ]
 
     function finalizeCreation() {
-        if (creationMonitorTimer.running) {
-            creationMonitorTimer.stop();
-        }
-
         isCreating = false;
         pendingContainerName = "";
+        createJob = null;
         selectingImage = false;
 
         nameField.text = "";
@@ -262,109 +290,47 @@ Kirigami.Dialog {
             isCreating = true;
 
             nameField.text = safeName; // reflect sanitized name in UI
-            createTimer.start();
+
+            // Runs asynchronously, the result arrives through onContainerOperationFinished
+            createDialog.pendingContainerName = safeName;
+            createDialog.createJob = distroBoxManager.createContainer(safeName, imageName, getFullArgs());
         } else {
             errorDialog.text = i18n("Name and Image fields are required");
             errorDialog.open();
         }
     }
 
-    Timer {
-        id: createTimer
-        interval: 0
-        onTriggered: {
-            var imageName = selectedImageFull || selectedImageDisplay;
-            var safeName = nameField.text.trim().replace(/\s+/g, "-");
-
-            var success = distroBoxManager.createContainer(safeName, imageName, getFullArgs());
+    Connections {
+        target: distroBoxManager
+        function onContainerOperationFinished(name, operation, success) {
+            if (operation !== "create" || name !== createDialog.pendingContainerName) {
+                return;
+            }
 
             if (success) {
-                createDialog.pendingContainerName = safeName;
-                var result = distroBoxManager.listContainers();
-                var containers = [];
-                try {
-                    containers = JSON.parse(result);
-                } catch (e) {
-                    containers = [];
-                }
-                if (mainPage) {
-                    mainPage.containersList = containers;
-                }
-                createDialog.selectingImage = false;
-
-                var containerFound = false;
-                if (createDialog.pendingContainerName && containers) {
-                    for (var i = 0; i < containers.length; ++i) {
-                        if (containers[i].name === createDialog.pendingContainerName) {
-                            containerFound = true;
-                            break;
-                        }
-                    }
-                }
-
-                if (containerFound) {
-                    createDialog.finalizeCreation();
-                } else {
-                    createDialog.isCreating = true;
-                    if (creationMonitorTimer.running) {
-                        creationMonitorTimer.stop();
-                    }
-                    creationMonitorTimer.start();
-                }
+                // The container exists once distrobox create returns, the list picks it up
+                // from the engine's event stream (or from the refresh in Main.qml)
+                createDialog.finalizeCreation();
             } else {
+                var canceled = createDialog.createJob && createDialog.createJob.stage === ContainerCreateJob.Canceled;
+                var lastLine = createDialog.createJob ? createDialog.createJob.lastLine : "";
                 createDialog.isCreating = false;
                 createDialog.pendingContainerName = "";
-                if (creationMonitorTimer.running) {
-                    creationMonitorTimer.stop();
-                }
-                errorDialog.text = i18n("Failed to create container. Please check your input and try again.");
-                errorDialog.open();
-            }
-        }
-    }
-
-    Timer {
-        id: creationMonitorTimer
-        interval: 1000
-        repeat: true
-        onTriggered: {
-            if (!createDialog.pendingContainerName || createDialog.pendingContainerName.trim() === "") {
-                stop();
-                createDialog.isCreating = false;
-                return;
-            }
-
-            var result = distroBoxManager.listContainers();
-            var containers = [];
-            try {
-                containers = JSON.parse(result);
-            } catch (e) {
-                containers = [];
-            }
-            if (mainPage) {
-                mainPage.containersList = containers;
-            }
-
-            var containerFound = false;
-            for (var i = 0; i < containers.length; ++i) {
-                if (containers[i].name === createDialog.pendingContainerName) {
-                    containerFound = true;
-                    break;
+                createDialog.createJob = null;
+                if (!canceled) {
+                    errorDialog.text = lastLine ? i18n("Failed to create container:\n%1", lastLine) : i18n("Failed to create container. Please check your input and try again.");
+                    errorDialog.open();
                 }
             }
-
-            if (containerFound) {
-                stop();
-                createDialog.finalizeCreation();
-            }
         }
     }
 
     onRejected: {
-        if (creationMonitorTimer.running) {
-            creationMonitorTimer.stop();
+        if (isCreating && pendingContainerName) {
+            distroBoxManager.cancelOperation(pendingContainerName);
         }
         pendingContainerName = "";
+        createJob = null;
         isCreating = false;
         createDialog.close();
         createDialog.selectingImage = false;
@@ -372,11 +338,20 @@ Kirigami.Dialog {
     }
 
     Component.onCompleted: {
+        // Served from the saved list; a fresh one arrives through availableImagesChanged
         var images = JSON.parse(distroBoxManager.listAvailableImages());
         availableImages = images;
         updateFilteredImages(imageSearchField ? imageSearchField.text : "");
     }
 
+    Connections {
+        target: distroBoxManager
+        function onAvailableImagesChanged(imagesJson) {
+            createDialog.availableImages = JSON.parse(imagesJson);
+            updateFilteredImages(imageSearchField ? imageSearchField.text : "");
+        }
+    }
+
     ColumnLayout {
         spacing: Kirigami.Units.largeSpacing
 
@@ -409,10 +384,46 @@ Kirigami.Dialog {
 
                 Controls.Label {
                     Layout.alignment: Qt.AlignHCenter
-                    text: i18n("Creating container…")
+                    text: createDialog.createJob && createDialog.createJob.stage === ContainerCreateJob.Pulling ? i18n("Downloading image…") : i18n("Creating container…")
                     font.bold: true
                 }
 
+                Controls.ProgressBar {
+                    Layout.preferredWidth: Kirigami.Units.gridUnit * 20
+                    Layout.alignment: Qt.AlignHCenter
+                    visible: createDialog.createJob !== null
+                    // Sizes are only known when the engine API does the pull
+                    indeterminate: !createDialog.createJob || createDialog.createJob.bytesTotal <= 0 || createDialog.createJob.stage !== ContainerCreateJob.Pulling
+                    from: 0
+                    to: createDialog.createJob ? Math.max(1, createDialog.createJob.bytesTotal) : 1
+                    value: createDialog.createJob ? createDialog.createJob.bytesDone : 0
+                }
+
+                Controls.Label {
+                    Layout.alignment: Qt.AlignHCenter
+                    visible: createDialog.createJob !== null && createDialog.createJob.layerCount > 0
+                    text: {
+                        var job = createDialog.createJob;
+                        if (!job)
+                            return "";
+                        var layers = i18n("%1 of %2 layers", job.layersDone, job.layerCount);
+                        if (job.bytesTotal <= 0)
+                            return layers;
+                        return i18nc("downloaded size of total size, layers", "%1 of %2, %3", Qt.locale().formattedDataSize(job.bytesDone), Qt.locale().formattedDataSize(job.bytesTotal), layers);
+                    }
+                }
+
+                Controls.Label {
+                    Layout.alignment: Qt.AlignHCenter
+                    Layout.maximumWidth: Kirigami.Units.gridUnit * 24
+                    visible: text.length > 0
+                    text: createDialog.createJob ? createDialog.createJob.lastLine : ""
+                    elide: Text.ElideRight
+                    font.family: "monospace"
+                    font.pointSize: Kirigami.Theme.smallFont.pointSize
+                    color: Kirigami.Theme.disabledTextColor
+                }
+
                 Controls.Label {
                     Layout.alignment: Qt.AlignHCenter
                     text: i18n("This may take a few minutes")
@@ -476,6 +487,30 @@ Kirigami.Dialog {
                         color: createDialog.selectedImageIsCustom ? Kirigami.Theme.neutralTextColor : Kirigami.Theme.disabledTextColor
                         font.italic: createDialog.selectedImageIsCustom
                     }
+
+                    Controls.Label {
+                        Layout.fillWidth: true
+                        visible: createDialog.prepull !== null && !createDialog.isCreating
+                        wrapMode: Text.Wrap
+                        color: Kirigami.Theme.disabledTextColor
+                        font.pointSize: Kirigami.Theme.smallFont.pointSize
+                        text: {
+                            var pull = createDialog.prepull;
+                            if (!pull) {
+                                return "";
+                            }
+                            if (pull.state === ImagePull.Succeeded) {
+                                return i18n("Image downloaded");
+                            }
+                            if (pull.state !== ImagePull.Running) {
+                                return i18n("The image will be downloaded when creating the container");
+                            }
+                            if (pull.bytesTotal > 0) {
+                                return i18n("Downloading image: %1 of %2", Qt.locale().formattedDataSize(pull.bytesDone), Qt.locale().formattedDataSize(pull.bytesTotal));
+                            }
+                            return i18n("Downloading image…");
+                        }
+                    }
                 }
 
                 Controls.CheckBox {
@@ -493,6 +528,16 @@ Kirigami.Dialog {
                     enabled: !createDialog.isCreating
                 }
 
+                Controls.CheckBox {
+                    text: i18n("Download the image while filling in the form")
+                    checked: createSettings.prepullImages
+                    enabled: !createDialog.isCreating
+                    onToggled: {
+                        createSettings.prepullImages = checked;
+                        createDialog.updatePrepull();
+                    }
+                }
+
                 Kirigami.Separator {
                     Layout.fillWidth: true
                     Layout.topMargin: Kirigami.Units.smallSpacing
@@ -760,7 +805,7 @@ Kirigami.Dialog {
             Kirigami.PlaceholderMessage {
                 Layout.fillWidth: true
                 visible: createDialog.filteredImages.length === 0 && imageSearchField.text.trim().length === 0
-                text: i18n("Type to search for images")
+                text: distroBoxManager.loadingAvailableImages ? i18n("Loading images…") : i18n("Type to search for images")
             }
         }
     }
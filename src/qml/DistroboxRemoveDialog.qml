@@ -17,22 +17,18 @@ Kirigami.Dialog {
     standardButtons: Kirigami.Dialog.Yes | Kirigami.Dialog.No
 
     property string containerName: ""
-    required property var mainPage
     
     onAccepted: {
         if (containerName) {
-            var success = distroBoxManager.removeContainer(containerName)
-            if (success) {
-                // Refresh the container list
-                var result = distroBoxManager.listContainers()
-                if (mainPage) {
-                    try {
-                        mainPage.containersList = JSON.parse(result)
-                    } catch (e) {
-                        mainPage.containersList = []
-                    }
-                }
-            } else {
+            // Main.qml refreshes the list once the removal finishes
+            distroBoxManager.removeContainer(containerName)
+        }
+    }
+
+    Connections {
+        target: distroBoxManager
+        function onContainerOperationFinished(name, operation, success) {
+            if (operation === "remove" && !success) {
                 errorDialog.text = i18n("Failed to remove container")
                 errorDialog.open()
             }
@@ -20,7 +20,6 @@ Kirigami.Dialog {
     standardButtons: Kirigami.Dialog.Ok | Kirigami.Dialog.Cancel
     
     property string selectedContainer: ""
-    property var containersList: []
     
     onAccepted: {
         if (allCheckbox.checked) {
@@ -51,13 +50,13 @@ Kirigami.Dialog {
         
         Controls.ComboBox {
             id: containerCombo
-            model: shortcutDialog.containersList
+            model: distroBoxManager.containers
             textRole: "name"
             enabled: !allCheckbox.checked
             Layout.fillWidth: true
             onCurrentIndexChanged: {
                 if (currentIndex >= 0) {
-                    shortcutDialog.selectedContainer = model[currentIndex].name
+                    shortcutDialog.selectedContainer = distroBoxManager.containers.nameAt(currentIndex)
                 } else {
                     shortcutDialog.selectedContainer = ""
                 }
@@ -36,20 +36,21 @@ Kirigami.ApplicationWindow {
     // alias for clarity
     property alias fallbackToDistroColors: kontainerSettings.showColors
 
+    // Container metrics are sampled slowly while nobody looks at them
+    Binding {
+        target: distroBoxManager.metrics
+        property: "windowVisible"
+        value: root.visible && root.visibility !== Window.Minimized
+    }
+
     function refresh() {
         refreshing = true;
         
         // Check if container engine is available
         containerEngineAvailable = distroBoxManager.isContainerEngineAvailable();
         
-        if (containerEngineAvailable) {
-            var result = distroBoxManager.listContainers();
-            containersPage.containersList = JSON.parse(result);
-        } else {
-            containersPage.containersList = [];
-        }
-        
-        refreshing = false;
+        // Result arrives through onContainersRefreshed; without an engine the list is emptied
+        distroBoxManager.refreshContainers();
     }
     
     function setPending(containerName, isPending) {
@@ -66,24 +67,15 @@ Kirigami.ApplicationWindow {
     
     function executeContainerOperation(containerName, operation) {
         setPending(containerName, true);
-        
-        // Execute operation asynchronously using Timer
-        var timer = Qt.createQmlObject('import QtQuick; Timer {}', root);
-        timer.interval = 100;
-        timer.repeat = false;
-        timer.triggered.connect(function() {
-            operation();
-            refresh();
-            setPending(containerName, false);
-            timer.destroy();
-        });
-        timer.start();
+
+        // The operation runs asynchronously, onContainerOperationFinished clears the pending state
+        operation();
     }
 
     Connections {
         target: distroBoxManager
         function onContainerCloneFinished(clonedName, success) {
-            if (success) {
+            if (success && !distroBoxManager.watchingContainerEvents) {
                 refresh();
             }
         }
@@ -91,15 +83,37 @@ Kirigami.ApplicationWindow {
     Connections {
         target: distroBoxManager
         function onContainerAssembleFinished(success) {
-            if (success) {
+            if (success && !distroBoxManager.watchingContainerEvents) {
                 refresh()
             }
         }
+        function onContainerAssemblePulling(images) {
+            showPassiveNotification(i18np("Downloading the image before assembling…", "Downloading %1 images before assembling…", images.length));
+        }
+    }
+    Connections {
+        target: distroBoxManager
+        function onContainersRefreshed() {
+            refreshing = false;
+        }
+        function onContainerOperationFinished(containerName, operation, success) {
+            setPending(containerName, false);
+            // With the event stream the list already reflects the change
+            if (!distroBoxManager.watchingContainerEvents) {
+                refresh();
+            }
+        }
+        function onContainerEnginesChanged() {
+            // An engine was installed or removed while the window was open
+            if (distroBoxManager.isContainerEngineAvailable() !== containerEngineAvailable) {
+                refresh();
+            }
+        }
     }
 
 
     globalDrawer: MainGlobalDrawer {
-        hasContainers: containersPage.containersList.length > 0
+        hasContainers: distroBoxManager.containers.count > 0
         fallbackToDistroColors: root.fallbackToDistroColors
         onCreateRequested: createDialog.open()
         onShortcutRequested: shortcutDialog.open()
@@ -117,24 +131,23 @@ Kirigami.ApplicationWindow {
     }
     DistroboxRemoveDialog {
         id: removeDialog
-        mainPage: containersPage
     }
     DistroboxCreateDialog {
         id: createDialog
         errorDialog: errorDialog
-        mainPage: containersPage
     }
     DistroboxShortcutDialog {
         id: shortcutDialog
-        containersList: containersPage.containersList
     }
     DistroboxCloneDialog {
         id: cloneDialog
-        containersList: containersPage.containersList
     }
     FilePickerDialog {
         id: packageFileDialog
     }
+    UpgradesDialog {
+        id: upgradesDialog
+    }
 
     pageStack.initialPage: MainContainersPage {
         id: containersPage
@@ -142,7 +155,10 @@ Kirigami.ApplicationWindow {
         appRefreshing: root.refreshing
         containerEngineAvailable: root.containerEngineAvailable
         onCreateRequested: createDialog.open()
-        onUpgradeAllRequested: distroBoxManager.upgradeAllContainer()
+        onUpgradeAllRequested: {
+            distroBoxManager.upgradeAllContainers();
+            upgradesDialog.open();
+        }
         onRefreshRequested: refresh()
         onInitialLoadRequested: refresh()
         onInstallPackageRequested: function(containerName, containerImage) {
@@ -163,6 +179,9 @@ Kirigami.ApplicationWindow {
         }
         onOpenTerminalRequested: function(containerName) {
             distroBoxManager.enterContainer(containerName);
+            if (distroBoxManager.watchingContainerEvents) {
+                return;
+            }
             // Refresh after 1 second to update container status (in case it was stopped and auto-started)
             var timer = Qt.createQmlObject('import QtQuick; Timer {}', root);
             timer.interval = 1000;
@@ -190,7 +209,6 @@ Kirigami.ApplicationWindow {
                 });
             } else {
                 distroBoxManager.startContainer(containerName);
-                refresh();
             }
         }
         onStopContainerRequested: function(containerName, setPending) {
@@ -200,7 +218,6 @@ Kirigami.ApplicationWindow {
                 });
             } else {
                 distroBoxManager.stopContainer(containerName);
-                refresh();
             }
         }
         onRebootContainerRequested: function(containerName, setPending) {
@@ -210,7 +227,6 @@ Kirigami.ApplicationWindow {
                 });
             } else {
                 distroBoxManager.rebootContainer(containerName);
-                refresh();
             }
         }
     }
@@ -0,0 +1,202 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+import QtQuick
+import QtQuick.Layouts
+import QtQuick.Controls as Controls
+
+import org.kde.kirigami as Kirigami
+
+Kirigami.Dialog {
+    id: upgradesDialog
+    title: i18n("Upgrades")
+    padding: Kirigami.Units.largeSpacing
+    preferredWidth: Kirigami.Units.gridUnit * 32
+    preferredHeight: Kirigami.Units.gridUnit * 28
+
+    readonly property var upgrades: distroBoxManager.upgrades
+
+    function stateText(state, exitCode) {
+        switch (state) {
+        case UpgradeScheduler.Queued:
+            return i18n("Waiting");
+        case UpgradeScheduler.Running:
+            return i18n("Upgrading…");
+        case UpgradeScheduler.Succeeded:
+            return i18n("Upgraded");
+        case UpgradeScheduler.Failed:
+            return exitCode >= 0 ? i18n("Failed (exit code %1)", exitCode) : i18n("Failed");
+        case UpgradeScheduler.Canceled:
+            return i18n("Canceled");
+        }
+        return "";
+    }
+
+    function stateIcon(state) {
+        switch (state) {
+        case UpgradeScheduler.Queued:
+            return "content-loading-symbolic";
+        case UpgradeScheduler.Succeeded:
+            return "data-success";
+        case UpgradeScheduler.Failed:
+            return "data-error";
+        case UpgradeScheduler.Canceled:
+            return "dialog-cancel";
+        }
+        return "";
+    }
+
+    customFooterActions: [
+        Kirigami.Action {
+            text: i18n("Cancel All")
+            icon.name: "dialog-cancel"
+            visible: upgrades.active
+            onTriggered: upgrades.cancelAll()
+        },
+        Kirigami.Action {
+            text: i18n("Clear Finished")
+            icon.name: "edit-clear-history"
+            enabled: upgrades.finishedCount > 0
+            onTriggered: upgrades.clearFinished()
+        }
+    ]
+
+    ColumnLayout {
+        spacing: Kirigami.Units.largeSpacing
+
+        RowLayout {
+            Layout.fillWidth: true
+
+            Controls.Label {
+                text: i18n("%1 of %2 containers done", upgrades.finishedCount, upgrades.count)
+                Layout.fillWidth: true
+            }
+
+            Controls.Label {
+                text: i18n("Upgrade at the same time:")
+            }
+
+            Controls.SpinBox {
+                from: 1
+                to: 64
+                value: upgrades.maxConcurrent
+                onValueModified: upgrades.maxConcurrent = value
+            }
+        }
+
+        Controls.ProgressBar {
+            Layout.fillWidth: true
+            from: 0
+            to: Math.max(1, upgrades.count)
+            value: upgrades.finishedCount
+        }
+
+        Controls.ScrollView {
+            Layout.fillWidth: true
+            Layout.fillHeight: true
+            Layout.minimumHeight: Kirigami.Units.gridUnit * 16
+            clip: true
+
+            ListView {
+                model: upgradesDialog.upgrades
+                spacing: Kirigami.Units.smallSpacing
+
+                delegate: ColumnLayout {
+                    id: jobDelegate
+
+                    required property string container
+                    required property int jobState
+                    required property string lastLine
+                    required property int exitCode
+                    required property int logRevision
+
+                    property bool expanded: false
+                    // Only fetched while shown, re-read whenever logRevision says new output arrived
+                    readonly property string log: expanded && logRevision >= 0 ? upgradesDialog.upgrades.log(container) : ""
+
+                    width: ListView.view.width
+                    spacing: Kirigami.Units.smallSpacing
+
+                    RowLayout {
+                        Layout.fillWidth: true
+
+                        Controls.BusyIndicator {
+                            visible: jobDelegate.jobState === UpgradeScheduler.Running
+                            running: visible
+                            Layout.preferredWidth: Kirigami.Units.iconSizes.smallMedium
+                            Layout.preferredHeight: Kirigami.Units.iconSizes.smallMedium
+                        }
+
+                        Kirigami.Icon {
+                            visible: jobDelegate.jobState !== UpgradeScheduler.Running
+                            source: upgradesDialog.stateIcon(jobDelegate.jobState)
+                            Layout.preferredWidth: Kirigami.Units.iconSizes.smallMedium
+                            Layout.preferredHeight: Kirigami.Units.iconSizes.smallMedium
+                        }
+
+                        ColumnLayout {
+                            Layout.fillWidth: true
+                            spacing: 0
+
+                            Controls.Label {
+                                text: jobDelegate.container
+                                font.bold: true
+                                elide: Text.ElideRight
+                                Layout.fillWidth: true
+                            }
+
+                            Controls.Label {
+                                // The last line of output shows what the package manager is doing
+                                text: jobDelegate.jobState === UpgradeScheduler.Running && jobDelegate.lastLine ? jobDelegate.lastLine : upgradesDialog.stateText(jobDelegate.jobState, jobDelegate.exitCode)
+                                elide: Text.ElideRight
+                                opacity: 0.7
+                                Layout.fillWidth: true
+                            }
+                        }
+
+                        Controls.ToolButton {
+                            icon.name: jobDelegate.expanded ? "arrow-up" : "arrow-down"
+                            text: jobDelegate.expanded ? i18n("Hide Log") : i18n("Show Log")
+                            display: Controls.AbstractButton.IconOnly
+                            enabled: jobDelegate.jobState !== UpgradeScheduler.Queued
+                            onClicked: jobDelegate.expanded = !jobDelegate.expanded
+                            Controls.ToolTip.text: text
+                            Controls.ToolTip.visible: hovered
+                        }
+
+                        Controls.ToolButton {
+                            icon.name: "dialog-cancel"
+                            text: i18n("Cancel")
+                            display: Controls.AbstractButton.IconOnly
+                            visible: jobDelegate.jobState === UpgradeScheduler.Queued || jobDelegate.jobState === UpgradeScheduler.Running
+                            onClicked: upgradesDialog.upgrades.cancel(jobDelegate.container)
+                            Controls.ToolTip.text: text
+                            Controls.ToolTip.visible: hovered
+                        }
+                    }
+
+                    Controls.ScrollView {
+                        visible: jobDelegate.expanded
+                        Layout.fillWidth: true
+                        Layout.preferredHeight: Kirigami.Units.gridUnit * 10
+
+                        Controls.TextArea {
+                            text: jobDelegate.log
+                            readOnly: true
+                            wrapMode: TextEdit.NoWrap
+                            font.family: "monospace"
+                            // Follow the output while the upgrade runs
+                            onTextChanged: cursorPosition = length
+                        }
+                    }
+
+                    Kirigami.Separator {
+                        Layout.fillWidth: true
+                    }
+                }
+            }
+        }
+    }
+}
@@ -52,9 +52,10 @@ Item {
         }
         radius: 4
 
-        Kirigami.Icon {
+        ContainerIcon {
             anchors.centerIn: parent
-            source: distroBoxManager.getDistroIcon(badge.containerName)
+            source: distroBoxManager.getDistroIcon(badge.containerName, badge.containerImage)
+            iconName: "preferences-virtualization-container"
             width: Kirigami.Units.iconSizes.medium
             height: Kirigami.Units.iconSizes.medium
         }
@@ -10,9 +10,13 @@ import org.kde.kirigami as Kirigami
 Kirigami.AbstractCard {
     id: card
 
-    property var container: ({})
+    property string containerName: ""
+    property string containerImage: ""
+    property string containerStatus: ""
     property bool fallbackToDistroColors: false
     property bool isPending: false
+    property double writableSize: -1 // Bytes, -1 while not measured
+    property double imageSize: -1 // Bytes of the image attributed to this container, -1 if not known
 
     signal installPackageRequested(string containerName, string containerImage)
     signal manageApplicationsRequested(string containerName)
@@ -34,8 +38,8 @@ Kirigami.AbstractCard {
 
             ContainerBadge {
                 fallbackToDistroColors: card.fallbackToDistroColors
-                containerName: card.container.name || ""
-                containerImage: card.container.image || ""
+                containerName: card.containerName
+                containerImage: card.containerImage
             }
 
             RowLayout {
@@ -48,7 +52,7 @@ Kirigami.AbstractCard {
                     Layout.maximumWidth: implicitWidth
 
                     Controls.Label {
-                        text: card.container.name ? card.container.name.charAt(0).toUpperCase() + card.container.name.slice(1) : ""
+                        text: card.containerName ? card.containerName.charAt(0).toUpperCase() + card.containerName.slice(1) : ""
                         elide: Text.ElideRight
                         Layout.fillWidth: true
                         font.pointSize: Kirigami.Theme.defaultFont.pointSize * 1.1
@@ -56,18 +60,44 @@ Kirigami.AbstractCard {
                     }
 
                     Controls.Label {
-                        text: card.container.image || ""
+                        text: card.containerImage
                         elide: Text.ElideRight
                         Layout.fillWidth: true
                         font.pointSize: Kirigami.Theme.smallFont.pointSize
                         opacity: 0.7
                     }
+
+                    Controls.Label {
+                        visible: card.writableSize >= 0
+                        text: i18nc("Disk space used by a container", "Size %1", Qt.locale().formattedDataSize(card.writableSize + Math.max(0, card.imageSize)))
+                        font.pointSize: Kirigami.Theme.smallFont.pointSize
+                        opacity: 0.7
+
+                        HoverHandler {
+                            id: sizeHover
+                        }
+
+                        Controls.ToolTip.visible: sizeHover.hovered
+                        Controls.ToolTip.delay: Kirigami.Units.toolTipDelay
+                        Controls.ToolTip.text: {
+                            var lines = [i18n("Container: %1", Qt.locale().formattedDataSize(card.writableSize))];
+                            if (card.imageSize >= 0) {
+                                lines.push(i18n("Share of the image: %1", Qt.locale().formattedDataSize(card.imageSize)));
+                            }
+                            return lines.join("\n");
+                        }
+                    }
+
+                    ContainerMetricsRow {
+                        containerName: card.containerName
+                        running: card.containerStatus.toLowerCase().startsWith("up")
+                    }
                 }
 
                 ContainerActionsToolbar {
-                    containerName: card.container.name || ""
-                    containerImage: card.container.image || ""
-                    containerStatus: card.container.status || ""
+                    containerName: card.containerName
+                    containerImage: card.containerImage
+                    containerStatus: card.containerStatus
                     isPending: card.isPending
                     onInstallPackageRequested: function(containerName, containerImage) {
                         card.installPackageRequested(containerName, containerImage)
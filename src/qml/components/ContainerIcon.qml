@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+import QtQuick
+import org.kde.kirigami as Kirigami
+
+// Shows an image://kontainer-icon/ URL, decoded off the GUI thread, or a theme icon
+Item {
+    id: containerIcon
+
+    // image://kontainer-icon/ URL or an absolute path on the host; empty to show iconName
+    property string source: ""
+    // Theme icon used while the image loads and when there is none
+    property string iconName: ""
+
+    readonly property string imageSource: {
+        if (source.length === 0)
+            return "";
+        if (source.startsWith("image://"))
+            return source;
+        const path = source.startsWith("file://") ? decodeURIComponent(source.slice(7)) : source;
+        return path.startsWith("/") ? "image://kontainer-icon/host/" + encodeURIComponent(path) : "";
+    }
+
+    implicitWidth: Kirigami.Units.iconSizes.medium
+    implicitHeight: implicitWidth
+
+    Image {
+        id: image
+        anchors.fill: parent
+        visible: status === Image.Ready
+        source: containerIcon.imageSource
+        // Pre-scaled variants exist for these sizes, no full-size decode happens here
+        sourceSize.width: width * Screen.devicePixelRatio
+        sourceSize.height: height * Screen.devicePixelRatio
+        fillMode: Image.PreserveAspectFit
+        asynchronous: true
+        cache: true
+        smooth: true
+    }
+
+    Kirigami.Icon {
+        anchors.fill: parent
+        visible: !image.visible
+        source: containerIcon.imageSource.length > 0 || containerIcon.source.length === 0 ? containerIcon.iconName : containerIcon.source
+        // Distribution logos aren't in every icon theme
+        fallback: containerIcon.iconName.length > 0 ? containerIcon.iconName : "unknown"
+    }
+}
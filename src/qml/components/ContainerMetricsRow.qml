@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+import QtQuick
+import QtQuick.Controls as Controls
+import QtQuick.Layouts
+import org.kde.kirigami as Kirigami
+
+// CPU and memory of a running container, with their recent history
+RowLayout {
+    id: metricsRow
+
+    property string containerName: ""
+    property bool running: false
+
+    property var latest: ({})
+    property var cpuHistory: []
+    property var memoryHistory: []
+
+    spacing: Kirigami.Units.largeSpacing
+    visible: running && latest.cpu !== undefined
+
+    function update() {
+        var metrics = distroBoxManager.metrics;
+        latest = metrics.latest(containerName);
+        cpuHistory = metrics.history(containerName, "cpu");
+        memoryHistory = metrics.history(containerName, "memory");
+    }
+
+    onRunningChanged: update()
+    onContainerNameChanged: update()
+
+    Connections {
+        // Stopped containers aren't sampled, their cards need no updates
+        target: metricsRow.running ? distroBoxManager.metrics : null
+        function onSampled() {
+            metricsRow.update();
+        }
+    }
+
+    Controls.Label {
+        text: i18nc("CPU usage of a container", "CPU %1%", Math.round(metricsRow.latest.cpu || 0))
+        font.pointSize: Kirigami.Theme.smallFont.pointSize
+        opacity: 0.7
+    }
+
+    Sparkline {
+        values: metricsRow.cpuHistory
+        // Percent of one core
+        minimumMaximum: 100
+    }
+
+    Controls.Label {
+        text: i18nc("Memory usage of a container", "RAM %1", Qt.locale().formattedDataSize(metricsRow.latest.memory || 0))
+        font.pointSize: Kirigami.Theme.smallFont.pointSize
+        opacity: 0.7
+    }
+
+    Sparkline {
+        values: metricsRow.memoryHistory
+        // 64 MiB, below that the line would only show noise
+        minimumMaximum: 64 * 1024 * 1024
+        color: Kirigami.Theme.positiveTextColor
+    }
+
+    HoverHandler {
+        id: metricsHover
+    }
+
+    Controls.ToolTip.visible: metricsHover.hovered
+    Controls.ToolTip.delay: Kirigami.Units.toolTipDelay
+    Controls.ToolTip.text: {
+        var lines = [i18n("Processes: %1", metricsRow.latest.pids || 0), i18n("Disk: %1/s", Qt.locale().formattedDataSize(metricsRow.latest.blockRate || 0))];
+        if (metricsRow.latest.networkRate !== undefined && metricsRow.latest.networkRate >= 0) {
+            lines.push(i18n("Network: %1/s", Qt.locale().formattedDataSize(metricsRow.latest.networkRate)));
+        } else {
+            lines.push(i18n("Network: shared with the host"));
+        }
+        if (metricsRow.latest.memoryLimit > 0) {
+            lines.push(i18n("Memory limit: %1", Qt.locale().formattedDataSize(metricsRow.latest.memoryLimit)));
+        }
+        return lines.join("\n");
+    }
+}
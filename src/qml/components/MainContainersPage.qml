@@ -2,6 +2,7 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 
+import QtCore
 import QtQuick
 import QtQuick.Layouts
 import org.kde.kirigami as Kirigami
@@ -9,7 +10,6 @@ import org.kde.kirigami as Kirigami
 Kirigami.ScrollablePage {
     id: page
 
-    property var containersList: []
     property bool appRefreshing: false
     property bool fallbackToDistroColors: false
     property bool containerEngineAvailable: true
@@ -34,6 +34,18 @@ Kirigami.ScrollablePage {
 
     title: i18n("Distrobox Containers")
 
+    Settings {
+        id: containersSettings
+        category: "Containers"
+        property int sortOrder: ContainerSortModel.Default
+    }
+
+    ContainerSortModel {
+        id: sortedContainers
+        sourceModel: distroBoxManager.containers
+        sortOrder: containersSettings.sortOrder
+    }
+
     supportsRefreshing: true
     onRefreshingChanged: if (refreshing)
         page.refreshRequested()
@@ -51,6 +63,30 @@ Kirigami.ScrollablePage {
             enabled: page.containerEngineAvailable
             onTriggered: page.upgradeAllRequested()
         },
+        Kirigami.Action {
+            text: i18n("Sort")
+            icon.name: "view-sort"
+            displayHint: Kirigami.DisplayHint.IconOnly
+
+            Kirigami.Action {
+                text: i18nc("Sort containers as the engine lists them", "Default")
+                checkable: true
+                checked: containersSettings.sortOrder === ContainerSortModel.Default
+                onTriggered: containersSettings.sortOrder = ContainerSortModel.Default
+            }
+            Kirigami.Action {
+                text: i18nc("Sort containers by", "Name")
+                checkable: true
+                checked: containersSettings.sortOrder === ContainerSortModel.Name
+                onTriggered: containersSettings.sortOrder = ContainerSortModel.Name
+            }
+            Kirigami.Action {
+                text: i18nc("Sort containers by", "Size")
+                checkable: true
+                checked: containersSettings.sortOrder === ContainerSortModel.Size
+                onTriggered: containersSettings.sortOrder = ContainerSortModel.Size
+            }
+        },
         Kirigami.Action {
             text: i18n("Refresh")
             icon.name: "view-refresh"
@@ -66,12 +102,23 @@ Kirigami.ScrollablePage {
             id: containersListView
             Layout.fillWidth: true
             Layout.fillHeight: true
-            model: page.containersList
+            // Rows are updated in place, so cards survive refreshes
+            model: sortedContainers
 
             delegate: ContainerCard {
-                container: modelData
+                required property string name
+                required property string image
+                required property string status
+                required property double size
+                required property double imageShare
+
+                containerName: name
+                containerImage: image
+                containerStatus: status
+                writableSize: size
+                imageSize: imageShare
                 fallbackToDistroColors: page.fallbackToDistroColors
-                isPending: page.pendingContainers[modelData.name] || false
+                isPending: page.pendingContainers[name] || false
                 onInstallPackageRequested: function (containerName, containerImage) {
                     page.installPackageRequested(containerName, containerImage);
                 }
@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+import QtQuick
+import org.kde.kirigami as Kirigami
+
+// Small line chart of recent values, scaled to their maximum
+Canvas {
+    id: sparkline
+
+    property var values: []
+    // Values are scaled to at least this, so an idle container doesn't look busy
+    property real minimumMaximum: 1
+    property color color: Kirigami.Theme.highlightColor
+
+    implicitWidth: Kirigami.Units.gridUnit * 4
+    implicitHeight: Kirigami.Units.gridUnit
+
+    onValuesChanged: requestPaint()
+    onColorChanged: requestPaint()
+    onWidthChanged: requestPaint()
+    onHeightChanged: requestPaint()
+
+    onPaint: {
+        var ctx = getContext("2d");
+        ctx.reset();
+
+        var count = values ? values.length : 0;
+        if (count < 2) {
+            return;
+        }
+
+        var maximum = minimumMaximum;
+        for (var i = 0; i < count; i++) {
+            maximum = Math.max(maximum, values[i]);
+        }
+
+        var step = width / (count - 1);
+        var baseline = height - 1;
+
+        ctx.beginPath();
+        ctx.moveTo(0, baseline - values[0] / maximum * (height - 2));
+        for (var j = 1; j < count; j++) {
+            ctx.lineTo(j * step, baseline - values[j] / maximum * (height - 2));
+        }
+        ctx.strokeStyle = sparkline.color;
+        ctx.lineWidth = 1;
+        ctx.stroke();
+
+        // Fill below the line, lightly
+        ctx.lineTo(width, height);
+        ctx.lineTo(0, height);
+        ctx.closePath();
+        ctx.fillStyle = Qt.rgba(sparkline.color.r, sparkline.color.g, sparkline.color.b, 0.2);
+        ctx.fill();
+    }
+}
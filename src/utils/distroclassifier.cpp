@@ -0,0 +1,119 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#include "distroclassifier.h"
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+
+using namespace Qt::Literals::StringLiterals;
+
+namespace
+{
+// Enough for every image in the catalog and then some; the memo is simply dropped when full
+constexpr qsizetype MemoLimit = 4096;
+
+const QString Dnf = u"sudo dnf install %1"_s;
+const QString Apt = u"sudo apt install %1"_s;
+const QString Apk = u"sudo apk add --allow-untrusted %1"_s;
+
+struct Rule {
+    QRegularExpression pattern;
+    DistroClassifier::Distro distro;
+};
+
+// Tried in order, the first matching pattern wins
+const QList<Rule> &rules()
+{
+    static const QList<Rule> compiled = []() {
+        QList<Rule> rules = {
+            // Major distributions
+            {QRegularExpression(u"fedora|bluefin|ublue-os/fedora|fedoraproject\\.org/fedora"_s),
+             {u"fedora"_s, u"#3c6eb4"_s, u"distributor-logo-fedora"_s, Dnf}},
+            {QRegularExpression(u"ubuntu|toolbx/ubuntu|ubuntu-toolbox"_s), {u"ubuntu"_s, u"#e95420"_s, u"distributor-logo-ubuntu"_s, Apt}},
+            {QRegularExpression(u"debian|neurodebian"_s), {u"debian"_s, u"#d70a53"_s, u"distributor-logo-debian"_s, Apt}},
+            {QRegularExpression(u"opensuse|tumbleweed|leap|^suse$|^sles$"_s), {u"opensuse"_s, u"#73ba25"_s, u"distributor-logo-opensuse"_s, u"sudo zypper install %1"_s}},
+            {QRegularExpression(u"arch|blackarch|ublue-os/arch|bazzite-arch|arch-toolbox"_s),
+             {u"arch"_s, u"#1793d1"_s, u"distributor-logo-archlinux"_s, u"sudo pacman -U --noconfirm %1"_s}},
+            {QRegularExpression(u"centos|rhel|rocky|alma|ubi[789]?/|amazonlinux|^amzn$|^ol$"_s), {u"rhel"_s, u"#262577"_s, u"distributor-logo-redhat"_s, Dnf}},
+            // Other distributions
+            {QRegularExpression(u"gentoo"_s), {u"gentoo"_s, u"#54487a"_s, u"distributor-logo-gentoo"_s, u"sudo emerge %1"_s}},
+            {QRegularExpression(u"alpine"_s), {u"alpine"_s, u"#0d597f"_s, u"distributor-logo-alpine"_s, Apk}},
+            {QRegularExpression(u"kali"_s), {u"kali"_s, u"#367bf0"_s, u"distributor-logo-kali"_s, Apt}},
+            {QRegularExpression(u"mint"_s), {u"mint"_s, u"#87cf3e"_s, u"distributor-logo-linuxmint"_s, Apt}},
+            {QRegularExpression(u"void"_s), {u"void"_s, u"#478061"_s, u"distributor-logo-void"_s, u"sudo xbps-install %1"_s}},
+            {QRegularExpression(u"nixos"_s), {u"nixos"_s, u"#5277c3"_s, u"distributor-logo-nixos"_s, {}}},
+            {QRegularExpression(u"deepin|linuxdeepin"_s), {u"deepin"_s, u"#0188D7"_s, u"distributor-logo-deepin"_s, {}}},
+            {QRegularExpression(u"crystal"_s), {u"crystal"_s, u"#1E63A4"_s, {}, {}}},
+            {QRegularExpression(u"clear"_s), {u"clear"_s, u"#003366"_s, u"distributor-logo-clearlinux"_s, {}}},
+            {QRegularExpression(u"slack"_s), {u"slackware"_s, u"#333333"_s, u"distributor-logo-slackware"_s, u"sudo installpkg %1"_s}},
+            {QRegularExpression(u"steamos"_s), {u"steamos"_s, u"#1A9FFF"_s, u"distributor-logo-steamdeck"_s, {}}},
+            {QRegularExpression(u"vanilla"_s), {u"vanilla"_s, u"#0F0F0F"_s, {}, {}}},
+            {QRegularExpression(u"wolfi|chainguard"_s), {u"wolfi"_s, u"#007D9C"_s, {}, Apk}},
+            {QRegularExpression(u"oracle"_s), {u"oracle"_s, u"#C74634"_s, {}, Dnf}},
+            {QRegularExpression(u"kde|neon"_s), {u"neon"_s, u"#1D99F3"_s, u"distributor-logo-neon"_s, Apt}},
+        };
+
+        for (Rule &rule : rules) {
+            rule.pattern.optimize();
+        }
+        return rules;
+    }();
+    return compiled;
+}
+
+// Unknown images get a color of their own, the same one on every call
+QString colorForUnknown(const QString &image)
+{
+    QRandomGenerator generator(quint32(qHash(image, 0)));
+    const int r = generator.bounded(100, 201);
+    const int g = generator.bounded(100, 201);
+    const int b = generator.bounded(100, 201);
+    return u"#%1%2%3"_s.arg(r, 2, 16, QLatin1Char('0')).arg(g, 2, 16, QLatin1Char('0')).arg(b, 2, 16, QLatin1Char('0'));
+}
+
+DistroClassifier::Distro match(const QString &image)
+{
+    const QString imageLower = image.toLower();
+    for (const Rule &rule : rules()) {
+        if (imageLower.contains(rule.pattern)) {
+            return rule.distro;
+        }
+    }
+
+    DistroClassifier::Distro unknown;
+    unknown.color = colorForUnknown(imageLower);
+    return unknown;
+}
+}
+
+namespace DistroClassifier
+{
+Distro classify(const QString &image)
+{
+    static QMutex mutex;
+    static QHash<QString, Distro> memo;
+
+    {
+        QMutexLocker locker(&mutex);
+        const auto it = memo.constFind(image);
+        if (it != memo.constEnd()) {
+            return *it;
+        }
+    }
+
+    const Distro distro = match(image);
+
+    QMutexLocker locker(&mutex);
+    if (memo.size() >= MemoLimit) {
+        memo.clear();
+    }
+    memo.insert(image, distro);
+    return distro;
+}
+}
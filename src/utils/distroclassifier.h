@@ -0,0 +1,41 @@
+/*
+    SPDX-License-Identifier: GPL-3.0-or-later
+    SPDX-FileCopyrightText: 2025 Denys Madureira <denysmb@zoho.com>
+*/
+
+#pragma once
+
+#include <QString>
+
+/**
+ * @brief Classifies image references by distribution
+ *
+ * The patterns are compiled once, and every image is matched only the first time
+ * it is seen; later lookups are a hash lookup. Colors, package install commands
+ * and fallback icons all come from the same result, so they always agree.
+ */
+namespace DistroClassifier
+{
+/**
+ * @struct Distro
+ * @brief What is known about the distribution of an image
+ */
+struct Distro {
+    QString id; ///< e.g. "fedora"; empty if the image wasn't recognized
+    QString color; ///< "#rrggbb"; derived from the image name if it wasn't recognized
+    QString iconName; ///< Theme icon of the distribution; empty if unknown
+    QString installCommand; ///< Command installing the local package "%1"; empty if unknown
+
+    bool isKnown() const
+    {
+        return !id.isEmpty();
+    }
+};
+
+/**
+ * @brief Returns the distribution of @p image, e.g. "registry.fedoraproject.org/fedora-toolbox:42"
+ *
+ * Thread-safe.
+ */
+Distro classify(const QString &image);
+}
@@ -9,5 +9,8 @@
 
 namespace DistroColors
 {
+/**
+ * @brief Color of the distribution of @p image, see DistroClassifier
+ */
 QString colorForImage(const QString &image);
 }
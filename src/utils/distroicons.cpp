@@ -5,58 +5,38 @@
 
 #include "distroicons.h"
 
-#include "distroboxcli.h"
+#include "distroclassifier.h"
+#include "hostdesktopindex.h"
 #include <QDir>
-#include <QSettings>
-#include <QStandardPaths>
+#include <QIcon>
 
 using namespace Qt::Literals::StringLiterals;
 
 namespace DistroIcons
 {
-QString resolveDistroboxIcon(const QString container)
+QString resolveDistroboxIcon(const QString container, const QString &image)
 {
-    bool isFlatpakRuntime = DistroboxCli::isFlatpak();
-    QStringList searchPaths;
-
-    if (isFlatpakRuntime) {
-        searchPaths = {QDir::homePath() + QStringLiteral("/.var/app/io.github.DenysMb.Kontainer/data/applications"),
-                       QDir::homePath() + QStringLiteral("/.var/app/io.github.DenysMb.Kontainer/.local/share/applications"),
-                       QStringLiteral("/var/lib/flatpak/exports/share/applications"),
-                       QDir::homePath() + QStringLiteral("/.local/share/flatpak/exports/share/applications"),
-                       QDir::homePath() + QStringLiteral("/.local/share/applications")};
-    } else {
-        searchPaths = {QStandardPaths::writableLocation(QStandardPaths::ApplicationsLocation)};
-    }
-
-    QStringList patterns;
-    patterns << QStringLiteral("%1.desktop").arg(container);
-
     // 1. Try to resolve from .desktop file
-    for (const QString &searchPath : searchPaths) {
-        QDir dir(searchPath);
-        if (!dir.exists())
-            continue;
-
-        for (const QFileInfo &file : dir.entryInfoList(patterns, QDir::Files)) {
-            if (!file.fileName().endsWith(QStringLiteral(".desktop")))
-                continue;
-
-            QSettings desktop(file.filePath(), QSettings::IniFormat);
-            QString foundIcon = desktop.value(QStringLiteral("Desktop Entry/Icon"), QString()).toString();
+    if (const auto entry = HostDesktopIndex::instance()->find(QStringLiteral("%1.desktop").arg(container))) {
+        if (!entry->icon.isEmpty())
+            return entry->icon;
+    }
 
-            if (!foundIcon.isEmpty())
-                return foundIcon;
+    // 2. Fallback to the distribution's logo, if the icon theme has it
+    if (!image.isEmpty()) {
+        const QString distroIcon = DistroClassifier::classify(image).iconName;
+        if (!distroIcon.isEmpty() && QIcon::hasThemeIcon(distroIcon)) {
+            return distroIcon;
         }
     }
 
-    // 2. Fallback to distrobox terminal icon
+    // 3. Fallback to distrobox terminal icon
     QString customIconPath = QDir::homePath() + QStringLiteral("/.local/share/icons/distrobox/terminal-distrobox-icon.svg");
     if (QFile::exists(customIconPath)) {
         return customIconPath;
     }
 
-    // 3. Super final fallback
+    // 4. Super final fallback
     return QStringLiteral("preferences-virtualization-container");
 }
 }
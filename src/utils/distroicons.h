@@ -9,5 +9,8 @@
 
 namespace DistroIcons
 {
-QString resolveDistroboxIcon(const QString container);
+/**
+ * @brief Icon of @p container's desktop entry, or of the distribution of @p image if it has none
+ */
+QString resolveDistroboxIcon(const QString container, const QString &image = QString());
 }